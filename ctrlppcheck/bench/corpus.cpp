@@ -0,0 +1,237 @@
+//-----------------------------------------------------------------------------
+#include "corpus.h"
+
+#include <sstream>
+
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+//-----------------------------------------------------------------------------
+
+void makeDirectory(const std::string &path)
+{
+#if defined(_WIN32)
+    _mkdir(path.c_str());
+#else
+    mkdir(path.c_str(), 0777);
+#endif
+}
+
+CorpusGenerator::CorpusGenerator(unsigned long long seed)
+    : mRandom(seed)
+{
+}
+
+std::string CorpusGenerator::statement(const std::string &indent)
+{
+    std::ostringstream out;
+    out << indent;
+    switch (mRandom.next(8)) {
+    case 0:
+        out << "i = i * " << mRandom.next(100) << " + " << mRandom.next(1000) << ';';
+        break;
+    case 1:
+        out << "s = \"value_" << mRandom.next(10000) << "\" + i;";
+        break;
+    case 2:
+        out << "dynAppend(ds, s);";
+        break;
+    case 3:
+        out << "if (dynlen(ds) > " << mRandom.next(50) << ") { i = dynlen(ds); }";
+        break;
+    case 4:
+        out << "m[\"key_" << mRandom.next(100) << "\"] = i;";
+        break;
+    case 5:
+        out << "i += strlen(s) % " << 1U + mRandom.next(9) << ';';
+        break;
+    case 6:
+        out << "DebugTN(\"step\", i, s);";
+        break;
+    default:
+        out << "s = substr(s, 0, " << mRandom.next(20) << ");";
+        break;
+    }
+    out << '\n';
+    return out.str();
+}
+
+std::string CorpusGenerator::declarations() const
+{
+    return "  int i = 0;\n  string s;\n  dyn_string ds;\n  mapping m;\n";
+}
+
+std::string CorpusGenerator::longFunctions(int functions, int statements)
+{
+    std::string code;
+    for (int f = 0; f < functions; ++f) {
+        code += "int longFunction" + std::to_string(f) + "(int arg)\n{\n" + declarations() + "  i = arg;\n";
+        for (int n = 0; n < statements; ++n)
+            code += statement("  ");
+        code += "  return i;\n}\n\n";
+    }
+    return code + "main()\n{\n  DebugN(longFunction0(1));\n}\n";
+}
+
+std::string CorpusGenerator::deepNesting(int functions, int depth)
+{
+    std::string code;
+    for (int f = 0; f < functions; ++f) {
+        code += "int nestedFunction" + std::to_string(f) + "(int arg)\n{\n" + declarations();
+        std::string indent = "  ";
+        for (int d = 0; d < depth; ++d) {
+            const std::string var = "j" + std::to_string(d);
+            switch (mRandom.next(3)) {
+            case 0:
+                code += indent + "for (int " + var + " = 0; " + var + " < arg; " + var + "++) {\n";
+                break;
+            case 1:
+                code += indent + "if (arg > " + std::to_string(d) + ") {\n";
+                break;
+            default:
+                code += indent + "while (i < " + std::to_string(100 + d) + ") {\n";
+                code += indent + "  i++;\n";
+                break;
+            }
+            indent += "  ";
+            code += statement(indent);
+        }
+        for (int d = depth; d > 0; --d) {
+            indent.resize(indent.size() - 2U);
+            code += indent + "}\n";
+        }
+        code += "  return i;\n}\n\n";
+    }
+    return code + "main()\n{\n  DebugN(nestedFunction0(3));\n}\n";
+}
+
+std::string CorpusGenerator::library(int index, int functions)
+{
+    std::string code;
+    if (index > 0)
+        code += "#uses \"benchLib" + std::to_string(index - 1) + "\"\n\n";
+    code += "const int BENCH_LIB" + std::to_string(index) + "_VERSION = " + std::to_string(index) + ";\n\n";
+    for (int f = 0; f < functions; ++f) {
+        code += "int benchLib" + std::to_string(index) + "_f" + std::to_string(f) + "(int arg)\n{\n" + declarations() + "  i = arg;\n";
+        for (int n = 0; n < 10; ++n)
+            code += statement("  ");
+        if (index > 0)
+            code += "  i += benchLib" + std::to_string(index - 1) + "_f" + std::to_string(f) + "(i);\n";
+        code += "  return i;\n}\n\n";
+    }
+    return code;
+}
+
+std::string CorpusGenerator::usesScript(int libraries, int functions)
+{
+    std::string code;
+    for (int l = 0; l < libraries; ++l)
+        code += "#uses \"benchLib" + std::to_string(l) + "\"\n";
+    code += "\nmain()\n{\n  int i = 0;\n";
+    for (int l = 0; l < libraries; ++l)
+        code += "  i += benchLib" + std::to_string(l) + "_f" + std::to_string(mRandom.next(functions)) + "(i);\n";
+    return code + "  DebugN(i);\n}\n";
+}
+
+std::string CorpusGenerator::largeSwitch(int cases)
+{
+    std::string code = "string switchFunction(int arg)\n{\n" + declarations() + "  switch (arg) {\n";
+    for (int c = 0; c < cases; ++c) {
+        code += "    case " + std::to_string(c) + ":\n";
+        code += statement("      ");
+        code += "      s = \"case " + std::to_string(c) + "\";\n      break;\n";
+    }
+    code += "    default:\n      s = \"\";\n      break;\n  }\n  return s;\n}\n\n";
+    return code + "main()\n{\n  DebugN(switchFunction(7));\n}\n";
+}
+
+std::string CorpusGenerator::stringTable(int strings)
+{
+    std::string code = "const dyn_string BENCH_TEXTS = makeDynString(\n";
+    for (int n = 0; n < strings; ++n) {
+        code += "  \"" + text(20 + mRandom.next(60)) + '\"';
+        code += (n + 1 < strings) ? ",\n" : ");\n\n";
+    }
+    code += "mapping textMapping()\n{\n  mapping m;\n";
+    for (int n = 0; n < strings; ++n)
+        code += "  m[\"text" + std::to_string(n) + "\"] = \"" + text(10 + mRandom.next(40)) + "\";\n";
+    return code + "  return m;\n}\n\nmain()\n{\n  DebugN(dynlen(BENCH_TEXTS), mappinglen(textMapping()));\n}\n";
+}
+
+std::string CorpusGenerator::script(int index, int lines)
+{
+    std::string code;
+    int lineCount = 0;
+    for (int f = 0; lineCount < lines; ++f) {
+        code += "int script" + std::to_string(index) + "_f" + std::to_string(f) + "(int arg)\n{\n" + declarations() + "  i = arg;\n";
+        for (int n = 0; n < 40; ++n)
+            code += statement("  ");
+        if (f > 0)
+            code += "  i += script" + std::to_string(index) + "_f" + std::to_string(f - 1) + "(i);\n";
+        code += "  return i;\n}\n\n";
+        lineCount += 51;
+    }
+    return code + "main()\n{\n  DebugN(script" + std::to_string(index) + "_f0(1));\n}\n";
+}
+
+std::string CorpusGenerator::panel(int shapes, int statements)
+{
+    std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<panel version=\"14\">\n";
+    xml += " <events>\n  <script name=\"ScopeLib\" isEscaped=\"1\"><![CDATA[int panelValue;\n]]></script>\n";
+    xml += "  <script name=\"Initialize\" isEscaped=\"1\"><![CDATA[main()\n{\n  panelValue = 0;\n}\n]]></script>\n </events>\n <shapes>\n";
+    for (int shape = 0; shape < shapes; ++shape) {
+        xml += "  <shape Name=\"PUSH_BUTTON" + std::to_string(shape) + "\" shapeType=\"PUSH_BUTTON\">\n   <events>\n";
+        const char * const events[] = { "Clicked", "Initialize" };
+        for (const char *event : events) {
+            xml += std::string("    <script name=\"") + event + "\" isEscaped=\"1\"><![CDATA[main(mapping event)\n{\n" + declarations();
+            for (int n = 0; n < statements; ++n)
+                xml += statement("  ");
+            xml += "  this.text = s;\n}\n]]></script>\n";
+        }
+        xml += "   </events>\n  </shape>\n";
+    }
+    return xml + " </shapes>\n</panel>\n";
+}
+
+std::string CorpusGenerator::eventScript(int locals, int statements)
+{
+    std::string code = "main()\n{\n";
+    for (int v = 0; v < locals; ++v)
+        code += "  int v" + std::to_string(v) + " = " + std::to_string(mRandom.next(100)) + ";\n";
+    const unsigned int count = static_cast<unsigned int>(locals);
+    for (int n = 0; n < statements; ++n) {
+        const std::string v1 = "v" + std::to_string(mRandom.next(count));
+        const std::string v2 = "v" + std::to_string(mRandom.next(count));
+        const std::string v3 = "v" + std::to_string(mRandom.next(count));
+        switch (n % 5) {
+        case 0:
+            code += "  " + v1 + " = " + v2 + " + " + v3 + ";\n";
+            break;
+        case 1:
+            code += "  if (" + v1 + " > " + v2 + ") { DebugN(" + v3 + "); }\n";
+            break;
+        case 2:
+            code += "  DebugN(\"x\", " + v1 + " * 2, " + v2 + ");\n";
+            break;
+        case 3:
+            code += "  while (" + v1 + " < 10) { " + v1 + "++; }\n";
+            break;
+        default:
+            code += "  string s" + std::to_string(n) + " = \"a\" + " + v1 + ";\n";
+            break;
+        }
+    }
+    return code + "}\n";
+}
+
+std::string CorpusGenerator::text(unsigned int length)
+{
+    static const char letters[] = "abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789.,:";
+    std::string str(length, ' ');
+    for (char &c : str)
+        c = letters[mRandom.next(sizeof(letters) - 1U)];
+    return str;
+}
@@ -0,0 +1,71 @@
+//-----------------------------------------------------------------------------
+// Generator of synthetic CTRL projects for the benchmarks. The same seed
+// always gives the same code, it does not depend on the standard library.
+//-----------------------------------------------------------------------------
+#ifndef corpusH
+#define corpusH
+
+#include <string>
+
+/** Create a directory, an existing directory is kept */
+void makeDirectory(const std::string &path);
+
+/** Portable random numbers */
+class Random {
+public:
+    explicit Random(unsigned long long seed) : mState(seed * 2862933555777941757ULL + 3037000493ULL) {}
+
+    unsigned int next(unsigned int n) {
+        mState = mState * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<unsigned int>(mState >> 33) % n;
+    }
+
+private:
+    unsigned long long mState;
+};
+
+/** Generator of the CTRL code */
+class CorpusGenerator {
+public:
+    explicit CorpusGenerator(unsigned long long seed);
+
+    /** A statement of a function body with the local variables i, s, ds and m */
+    std::string statement(const std::string &indent);
+
+    /** The local variables of the statements */
+    std::string declarations() const;
+
+    /** Functions with long bodies */
+    std::string longFunctions(int functions, int statements);
+
+    /** Nested loops and conditions */
+    std::string deepNesting(int functions, int depth);
+
+    /** A library of the #uses case, it uses the previous library */
+    std::string library(int index, int functions);
+
+    /** A script that uses all libraries */
+    std::string usesScript(int libraries, int functions);
+
+    /** A switch with many cases */
+    std::string largeSwitch(int cases);
+
+    /** Tables of string literals */
+    std::string stringTable(int strings);
+
+    /** A script with about the given number of lines, in functions that call each other */
+    std::string script(int index, int lines);
+
+    /** A panel with event scripts of the panel and of its shapes */
+    std::string panel(int shapes, int statements);
+
+    /** An event script, one long function with many local variables */
+    std::string eventScript(int locals, int statements);
+
+private:
+    std::string text(unsigned int length);
+
+    Random mRandom;
+};
+
+#endif // corpusH
@@ -0,0 +1,338 @@
+//-----------------------------------------------------------------------------
+// Benchmark of the analysis phases with a generated CTRL project.
+//
+// Usage: ctrlppcheck-bench [--scale=<n>] [--seed=<n>] [--iterations=<n>] [--corpus=<dir>]
+//                          [--library=<file>] [--rule-file=<file>] [--naming-rule-file=<file>]
+//                          [--case=<name>] [--legacy-known-variables] [--output=<file>]
+//
+// The generator writes a synthetic project into the corpus directory, the same
+// seed and scale always give the same files. Each case of the project is
+// checked like the command line tool does it, the times of the phases
+// (simplecpp, tokenizer, symbol database, ValueFlow, each check, rules,
+// reporting) are collected with the timers of --showtime and written as JSON.
+//
+// --case runs only the given case. --legacy-known-variables simplifies the
+// known variables with the old pattern based code, e.g.
+//   ctrlppcheck-bench --case=eventScript
+//   ctrlppcheck-bench --case=eventScript --legacy-known-variables
+// compare the simplifyTokenList2 phases of the long event script.
+//-----------------------------------------------------------------------------
+
+#include "corpus.h"
+#include "cppcheck.h"
+#include "errorlogger.h"
+#include "importproject.h"
+#include "library.h"
+#include "memoryusage.h"
+#include "settings.h"
+#include "timer.h"
+
+#include <tinyxml2.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+/** Files of a benchmark case */
+struct Case {
+    std::string name;
+    std::vector<std::string> scripts;
+    std::vector<std::string> panels;
+    std::size_t bytes;
+};
+
+void writeFile(const std::string &fileName, const std::string &content, Case &benchCase)
+{
+    std::ofstream fout(fileName.c_str(), std::ios::binary);
+    fout << content;
+    benchCase.bytes += content.size();
+}
+
+std::list<Case> generateCorpus(const std::string &dir, unsigned long long seed, int scale)
+{
+    makeDirectory(dir);
+    makeDirectory(dir + "/scripts");
+    makeDirectory(dir + "/scripts/libs");
+    makeDirectory(dir + "/panels");
+
+    CorpusGenerator generator(seed);
+    std::list<Case> cases;
+    Case c;
+
+    c = Case{"longFunctions", {}, {}, 0};
+    c.scripts.push_back(dir + "/scripts/longFunctions.ctl");
+    writeFile(c.scripts.back(), generator.longFunctions(4 * scale, 250), c);
+    cases.push_back(c);
+
+    c = Case{"deepNesting", {}, {}, 0};
+    c.scripts.push_back(dir + "/scripts/deepNesting.ctl");
+    writeFile(c.scripts.back(), generator.deepNesting(4 * scale, 40), c);
+    cases.push_back(c);
+
+    c = Case{"manyUses", {}, {}, 0};
+    const int libraries = 20 * scale;
+    for (int l = 0; l < libraries; ++l)
+        writeFile(dir + "/scripts/libs/benchLib" + std::to_string(l) + ".ctl", generator.library(l, 5), c);
+    for (int s = 0; s < 4; ++s) {
+        c.scripts.push_back(dir + "/scripts/manyUses" + std::to_string(s) + ".ctl");
+        writeFile(c.scripts.back(), generator.usesScript(libraries, 5), c);
+    }
+    cases.push_back(c);
+
+    c = Case{"largeSwitch", {}, {}, 0};
+    c.scripts.push_back(dir + "/scripts/largeSwitch.ctl");
+    writeFile(c.scripts.back(), generator.largeSwitch(500 * scale), c);
+    cases.push_back(c);
+
+    c = Case{"stringTable", {}, {}, 0};
+    c.scripts.push_back(dir + "/scripts/stringTable.ctl");
+    writeFile(c.scripts.back(), generator.stringTable(1000 * scale), c);
+    cases.push_back(c);
+
+    c = Case{"panelScripts", {}, {}, 0};
+    for (int p = 0; p < 2 * scale; ++p) {
+        c.panels.push_back(dir + "/panels/benchPanel" + std::to_string(p) + ".pnl");
+        writeFile(c.panels.back(), generator.panel(20, 15), c);
+    }
+    cases.push_back(c);
+
+    c = Case{"eventScript", {}, {}, 0};
+    c.scripts.push_back(dir + "/scripts/eventScript.ctl");
+    writeFile(c.scripts.back(), generator.eventScript(1500 * scale, 3000 * scale), c);
+    cases.push_back(c);
+
+    return cases;
+}
+
+/** Counts the reported errors and formats them like --xml */
+class BenchErrorLogger : public ErrorLogger {
+public:
+    BenchErrorLogger() : errors(0), xmlBytes(0) {}
+
+    void reportOut(const std::string &outmsg) OVERRIDE {
+        (void)outmsg;
+    }
+
+    void reportErr(const ErrorLogger::ErrorMessage &msg) OVERRIDE {
+        ++errors;
+        xmlBytes += msg.toXML().size();
+    }
+
+    std::size_t errors;
+    std::size_t xmlBytes;
+};
+
+bool loadRules(const std::string &fileName, std::list<Settings::Rule> &rules)
+{
+    tinyxml2::XMLDocument doc;
+    if (doc.LoadFile(fileName.c_str()) != tinyxml2::XML_SUCCESS)
+        return false;
+    for (const tinyxml2::XMLElement *node = doc.FirstChildElement(); node && std::strcmp(node->Value(), "rule") == 0; node = node->NextSiblingElement()) {
+        Settings::Rule rule;
+        const tinyxml2::XMLElement *tokenlist = node->FirstChildElement("tokenlist");
+        if (tokenlist && tokenlist->GetText())
+            rule.tokenlist = tokenlist->GetText();
+        const tinyxml2::XMLElement *pattern = node->FirstChildElement("pattern");
+        if (!pattern || !pattern->GetText())
+            continue;
+        rule.pattern = pattern->GetText();
+        const tinyxml2::XMLElement *message = node->FirstChildElement("message");
+        if (message) {
+            const tinyxml2::XMLElement *severity = message->FirstChildElement("severity");
+            if (severity && severity->GetText())
+                rule.severity = Severity::fromString(severity->GetText());
+            const tinyxml2::XMLElement *id = message->FirstChildElement("id");
+            if (id && id->GetText())
+                rule.id = id->GetText();
+            const tinyxml2::XMLElement *summary = message->FirstChildElement("summary");
+            if (summary && summary->GetText())
+                rule.summary = summary->GetText();
+        }
+        rules.push_back(rule);
+    }
+    return true;
+}
+
+std::string jsonString(const std::string &str)
+{
+    std::string ret = "\"";
+    for (char c : str) {
+        if (c == '\"' || c == '\\')
+            ret += '\\';
+        ret += c;
+    }
+    return ret + '\"';
+}
+
+/** Results of a case, the phase times are the average of the iterations */
+struct CaseResult {
+    double wallSeconds;
+    std::size_t errors;
+    std::size_t xmlBytes;
+    std::map<std::string, TimerResultsData> phases;
+};
+
+CaseResult runCase(const Case &benchCase, const Settings &settings, int iterations)
+{
+    CaseResult result;
+    result.wallSeconds = 0;
+    TimerResults &timerResults = CppCheck::timerResults();
+    timerResults.clear();
+
+    for (int i = 0; i < iterations; ++i) {
+        BenchErrorLogger errorLogger;
+        const Clock::time_point start = Clock::now();
+        {
+            CppCheck cppcheck(errorLogger, true);
+            cppcheck.settings() = settings;
+            for (const std::string &script : benchCase.scripts)
+                cppcheck.check(script);
+            for (const std::string &panel : benchCase.panels) {
+                ImportProject project;
+                Timer timer("ImportProject::importPanel", settings.showtime, &timerResults);
+                project.importPanel(panel, nullptr);
+                timer.Stop();
+                for (const ImportProject::VirtualFile &vf : project.virtualFiles)
+                    cppcheck.check(vf.filename, vf.content);
+            }
+            cppcheck.analyseWholeProgram();
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        result.wallSeconds = (i == 0) ? seconds : std::min(result.wallSeconds, seconds);
+        result.errors = errorLogger.errors;
+        result.xmlBytes = errorLogger.xmlBytes;
+    }
+
+    result.phases = timerResults.getResults();
+    for (std::pair<const std::string, TimerResultsData> &phase : result.phases) {
+        phase.second.mClocks /= iterations;
+        phase.second.mNumberOfResults /= iterations;
+    }
+    return result;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    int scale = 1;
+    unsigned long long seed = 1;
+    int iterations = 1;
+    std::string corpus = "ctrlppcheck-bench-corpus";
+    std::string libraryFile = std::string(BENCH_CFG_DIR) + "/ctrl.xml";
+    std::string ruleFile = std::string(BENCH_RULE_DIR) + "/ctrl.xml";
+    std::string namingRuleFile = std::string(BENCH_RULE_DIR) + "/variableNaming.xml";
+    std::string outputFile;
+    std::string caseName;
+    bool legacyKnownVariables = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--scale=", 8) == 0)
+            scale = std::max(1, std::atoi(argv[i] + 8));
+        else if (std::strncmp(argv[i], "--seed=", 7) == 0)
+            seed = std::strtoull(argv[i] + 7, nullptr, 10);
+        else if (std::strncmp(argv[i], "--iterations=", 13) == 0)
+            iterations = std::max(1, std::atoi(argv[i] + 13));
+        else if (std::strncmp(argv[i], "--corpus=", 9) == 0)
+            corpus = argv[i] + 9;
+        else if (std::strncmp(argv[i], "--library=", 10) == 0)
+            libraryFile = argv[i] + 10;
+        else if (std::strncmp(argv[i], "--rule-file=", 12) == 0)
+            ruleFile = argv[i] + 12;
+        else if (std::strncmp(argv[i], "--naming-rule-file=", 19) == 0)
+            namingRuleFile = argv[i] + 19;
+        else if (std::strncmp(argv[i], "--output=", 9) == 0)
+            outputFile = argv[i] + 9;
+        else if (std::strncmp(argv[i], "--case=", 7) == 0)
+            caseName = argv[i] + 7;
+        else if (std::strcmp(argv[i], "--legacy-known-variables") == 0)
+            legacyKnownVariables = true;
+        else {
+            std::cerr << "ctrlppcheck-bench: unknown option: " << argv[i] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    Settings settings;
+    settings.projectName = "bench";
+    settings.addEnabled("all");
+    settings.inconclusive = true;
+    settings.quiet = true;
+    settings.showtime = SHOWTIME_QUIET;
+    settings.namingRuleFile = namingRuleFile;
+    settings.legacyKnownVariables = legacyKnownVariables;
+    if (settings.library.load(argv[0], libraryFile.c_str()).errorcode != Library::OK) {
+        std::cerr << "ctrlppcheck-bench: unable to load library: " << libraryFile << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!ruleFile.empty() && !loadRules(ruleFile, settings.rules)) {
+        std::cerr << "ctrlppcheck-bench: unable to load rule file: " << ruleFile << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::list<Case> cases = generateCorpus(corpus, seed, scale);
+    if (!caseName.empty()) {
+        cases.remove_if([&caseName](const Case &benchCase) {
+            return benchCase.name != caseName;
+        });
+        if (cases.empty()) {
+            std::cerr << "ctrlppcheck-bench: unknown case: " << caseName << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // the checks write messages to std::cout, the results are written in JSON only
+    std::ostringstream discarded;
+    std::streambuf * const coutBuffer = std::cout.rdbuf(discarded.rdbuf());
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(6);
+    json << "{\n  \"seed\": " << seed << ",\n  \"scale\": " << scale << ",\n  \"iterations\": " << iterations
+         << ",\n  \"legacyKnownVariables\": " << (legacyKnownVariables ? "true" : "false") << ",\n  \"cases\": [\n";
+    for (std::list<Case>::const_iterator benchCase = cases.begin(); benchCase != cases.end(); ++benchCase) {
+        const CaseResult result = runCase(*benchCase, settings, iterations);
+        discarded.str(std::string());
+
+        json << "    {\n      \"name\": " << jsonString(benchCase->name)
+             << ",\n      \"files\": " << benchCase->scripts.size() + benchCase->panels.size()
+             << ",\n      \"bytes\": " << benchCase->bytes
+             << ",\n      \"wallSeconds\": " << result.wallSeconds
+             << ",\n      \"errors\": " << result.errors
+             << ",\n      \"xmlBytes\": " << result.xmlBytes
+             << ",\n      \"phases\": {";
+        for (std::map<std::string, TimerResultsData>::const_iterator phase = result.phases.begin(); phase != result.phases.end(); ++phase) {
+            json << (phase == result.phases.begin() ? "\n" : ",\n")
+                 << "        " << jsonString(phase->first) << ": { \"seconds\": " << phase->second.seconds()
+                 << ", \"calls\": " << phase->second.mNumberOfResults << " }";
+        }
+        json << "\n      }\n    }" << (std::next(benchCase) != cases.end() ? "," : "") << '\n';
+    }
+    json << "  ],\n  \"peakProcessMemory\": " << MemoryUsage::peakProcessMemory() << "\n}\n";
+
+    std::cout.rdbuf(coutBuffer);
+    if (outputFile.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream fout(outputFile.c_str());
+        fout << json.str();
+        if (!fout.good()) {
+            std::cerr << "ctrlppcheck-bench: unable to write: " << outputFile << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,217 @@
+//-----------------------------------------------------------------------------
+// Benchmark of the regex backends with the patterns of the rule files.
+//
+// Usage: regexbench [--size=<bytes>] [--literal=<bytes>] [--names=<n>] [--iterations=<n>] [rule files]
+//
+// Each pattern is compiled and matched with the automaton and with std::regex.
+// Rule patterns are searched (all matches, like the rule check) in a generated
+// token stream of CTRL code, followed by one long string literal. Naming rule
+// patterns are matched against generated names.
+//-----------------------------------------------------------------------------
+
+#include "regex.h"
+
+#include <tinyxml2.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Pattern {
+    std::string file;
+    std::string id;
+    std::string pattern;
+    bool naming;
+};
+
+struct Measurement {
+    Measurement() : ok(true), engine("-"), compileUs(0), searchUs(0), matches(0) {}
+    bool ok;
+    std::string engine;
+    double compileUs;
+    double searchUs;
+    std::size_t matches;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsedUs(const Clock::time_point &start)
+{
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+void loadPatterns(const std::string &fileName, std::list<Pattern> &patterns)
+{
+    tinyxml2::XMLDocument doc;
+    if (doc.LoadFile(fileName.c_str()) != tinyxml2::XML_SUCCESS) {
+        std::cerr << "regexbench: unable to load rule file: " << fileName << std::endl;
+        return;
+    }
+    for (const tinyxml2::XMLElement *node = doc.FirstChildElement(); node && std::strcmp(node->Value(), "rule") == 0; node = node->NextSiblingElement()) {
+        const tinyxml2::XMLElement *pattern = node->FirstChildElement("pattern");
+        if (!pattern || !pattern->GetText())
+            continue;
+        Pattern p;
+        p.file = fileName.substr(fileName.find_last_of("/\\") + 1);
+        p.pattern = pattern->GetText();
+        p.naming = p.file.find("Naming") != std::string::npos;
+        const tinyxml2::XMLElement *message = node->FirstChildElement("message");
+        const tinyxml2::XMLElement *id = message ? message->FirstChildElement("id") : nullptr;
+        p.id = (id && id->GetText()) ? id->GetText() : "rule";
+
+        // naming rules: bind the file name placeholders
+        const char *placeholders[] = { "%fileName_allUpper%", "%fileName_allLower%", "%fileName%" };
+        const char *values[] = { "BENCH", "bench", "bench" };
+        for (int i = 0; i < 3; ++i) {
+            std::string::size_type pos;
+            while ((pos = p.pattern.find(placeholders[i])) != std::string::npos)
+                p.pattern.replace(pos, std::strlen(placeholders[i]), values[i]);
+        }
+        patterns.push_back(p);
+    }
+}
+
+/** Generated token stream, like the one the rules are matched against */
+std::string generateText(std::size_t size, std::size_t literalSize)
+{
+    static const char * const lines[] = {
+        " main ( ) {",
+        " int i = 0 ;",
+        " string s = \"WCC_OA\" ;",
+        " dyn_string ds = strsplit ( s , \"_\" ) ;",
+        " if ( strlen ( s ) > 0 ) { DebugN ( s ) ; }",
+        " if ( strpos ( s , \"W\" ) == 0 ) { i ++ ; }",
+        " for ( int j = 1 ; j <= dynlen ( ds ) ; j ++ ) { foo_bar ( ds [ j ] ) ; }",
+        " system ( cmd , out ) ;",
+        " delay ( 1 ) ;",
+        " logger . fatal ( 1 , \"PVSS\" ) ;",
+        " makeError ( \"\" , PRIO_SEVERE , ERR_CONTROL , 0 ) ;",
+        " }"
+    };
+    std::string text;
+    text.reserve(size + literalSize + 4);
+    for (std::size_t i = 0; text.size() < size; ++i)
+        text += lines[i % (sizeof(lines) / sizeof(lines[0]))];
+    if (literalSize > 0)
+        text += " \"" + std::string(literalSize, 'a') + "\"";
+    return text;
+}
+
+/** Generated variable, function and class names */
+std::vector<std::string> generateNames(std::size_t count)
+{
+    static const char * const prefixes[] = { "", "i", "s", "ds", "f_", "m_", "g_", "_", "bench_", "BENCH_", "c_" };
+    static const char * const words[] = { "count", "Value", "name", "DpName", "x", "result", "tmp", "Index" };
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        names.push_back(std::string(prefixes[i % (sizeof(prefixes) / sizeof(prefixes[0]))]) +
+                        words[(i / 7) % (sizeof(words) / sizeof(words[0]))]);
+    }
+    return names;
+}
+
+Measurement measure(const Pattern &pattern, Regex::Engine engine, const std::string &text, const std::vector<std::string> &names, int iterations)
+{
+    Measurement m;
+    try {
+        std::shared_ptr<const Regex> regex;
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < iterations; ++i)
+            regex = Regex::create(pattern.pattern, engine);
+        m.compileUs = elapsedUs(start) / iterations;
+        m.engine = regex->engineName();
+
+        start = Clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            m.matches = 0;
+            if (pattern.naming) {
+                for (const std::string &name : names) {
+                    if (regex->match(name, nullptr) == Regex::MATCH)
+                        ++m.matches;
+                }
+                continue;
+            }
+            std::size_t pos = 0, matchPos, matchLength;
+            while (pos <= text.size() && regex->search(text, pos, &matchPos, &matchLength, nullptr) == Regex::MATCH) {
+                ++m.matches;
+                pos = matchPos + (matchLength ? matchLength : 1);
+            }
+        }
+        m.searchUs = elapsedUs(start) / iterations;
+    } catch (const std::regex_error &e) {
+        m.ok = false;
+        m.engine = std::string("error: ") + e.what();
+    }
+    return m;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t size = 1000000;
+    std::size_t literalSize = 1000;
+    std::size_t nameCount = 100000;
+    int iterations = 3;
+    std::list<Pattern> patterns;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--size=", 7) == 0)
+            size = std::strtoul(argv[i] + 7, nullptr, 10);
+        else if (std::strncmp(argv[i], "--literal=", 10) == 0)
+            literalSize = std::strtoul(argv[i] + 10, nullptr, 10);
+        else if (std::strncmp(argv[i], "--names=", 8) == 0)
+            nameCount = std::strtoul(argv[i] + 8, nullptr, 10);
+        else if (std::strncmp(argv[i], "--iterations=", 13) == 0)
+            iterations = std::max(1, std::atoi(argv[i] + 13));
+        else
+            loadPatterns(argv[i], patterns);
+    }
+
+    if (patterns.empty()) {
+        const char *ruleFiles[] = { "ctrl.xml", "variableNaming.xml", "functionNaming.xml", "classNaming.xml" };
+        for (const char *ruleFile : ruleFiles)
+            loadPatterns(std::string(BENCH_RULE_DIR) + "/" + ruleFile, patterns);
+    }
+
+    const std::string text = generateText(size, literalSize);
+    const std::vector<std::string> names = generateNames(nameCount);
+    std::cout << "text: " << text.size() << " bytes (string literal: " << literalSize << " bytes), names: " << names.size()
+              << ", iterations: " << iterations << std::endl;
+    std::cout << std::left << std::setw(20) << "file" << std::setw(26) << "id" << std::setw(10) << "engine"
+              << std::right << std::setw(12) << "compile us" << std::setw(12) << "search ms" << std::setw(9) << "matches"
+              << std::setw(12) << "std us" << std::setw(12) << "std ms" << std::setw(9) << "matches" << std::endl;
+
+    double automatonTotal = 0, stdTotal = 0;
+    int mismatches = 0;
+    for (const Pattern &pattern : patterns) {
+        const Measurement automaton = measure(pattern, Regex::AUTOMATIC, text, names, iterations);
+        const Measurement stdRegex = measure(pattern, Regex::STD, text, names, iterations);
+        automatonTotal += automaton.compileUs + automaton.searchUs;
+        stdTotal += stdRegex.compileUs + stdRegex.searchUs;
+
+        std::cout << std::left << std::setw(20) << pattern.file << std::setw(26) << pattern.id.substr(0, 25) << std::setw(10) << automaton.engine
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << automaton.compileUs << std::setw(12) << automaton.searchUs / 1000 << std::setw(9) << automaton.matches
+                  << std::setw(12) << stdRegex.compileUs << std::setw(12) << stdRegex.searchUs / 1000 << std::setw(9) << stdRegex.matches;
+        if (automaton.ok != stdRegex.ok || automaton.matches != stdRegex.matches) {
+            std::cout << "  MISMATCH";
+            ++mismatches;
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << "total: automatic " << automatonTotal / 1000 << " ms, std " << stdTotal / 1000 << " ms" << std::endl;
+    return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,393 @@
+//-----------------------------------------------------------------------------
+// Scalability harness of the command line tool.
+//
+// Usage: ctrlppcheck-scaling [--cli=<path>] [--corpus=<dir>] [--seed=<n>]
+//                            [--lines=<min>:<max>] [--files=<min>:<max>] [--file-lines=<n>]
+//                            [--factor=<n>] [--workers=<n>,<n>,...] [--min-seconds=<s>]
+//                            [--max-exponent=<x>] [--baseline=<file>] [--tolerance=<x>]
+//                            [--output=<file>]
+//
+// Generated projects of growing size are checked with the command line tool
+// and --showtime=summary. The size grows by the factor, once in the lines of
+// one script ("lines") and once in the number of scripts ("files"). For every
+// phase the exponent of the time is fitted (time ~ size^exponent), phases with
+// an exponent above --max-exponent are super-linear. With --baseline (the
+// output of an earlier run) an exponent that grew by more than the tolerance
+// is a regression. Super-linear phases and regressions fail the run.
+//
+// The command line tool checks the files one after the other. The throughput
+// of several workers is measured with processes that check a part of the
+// files of the largest "files" project each.
+//-----------------------------------------------------------------------------
+
+#include "corpus.h"
+
+#include "../externals/picojson.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+/** Times of a check of a project */
+struct Point {
+    int size;
+    double wallSeconds;
+    std::map<std::string, double> phases;
+};
+
+struct Options {
+    std::string cli;
+    std::string corpus;
+    unsigned long long seed;
+    int fileLines;
+    double minSeconds;
+};
+
+std::string quote(const std::string &str)
+{
+    return '\"' + str + '\"';
+}
+
+/** Run the command line tool, the output is written to a file */
+bool runCli(const std::string &cli, const std::string &arguments, const std::string &outputFile)
+{
+    std::string command = quote(cli) + " --winccoa-projectName=bench --enable=all --inconclusive -q"
+                          " --library=" + quote(std::string(BENCH_CFG_DIR) + "/ctrl.xml") +
+                          " --rule-file=" + quote(std::string(BENCH_RULE_DIR) + "/ctrl.xml") +
+                          " --naming-rule-file=" + quote(std::string(BENCH_RULE_DIR) + "/variableNaming.xml") +
+                          ' ' + arguments + " > " + quote(outputFile) + " 2>&1";
+#if defined(_WIN32)
+    // cmd.exe removes the first and the last quote of the command
+    command = quote(command);
+#endif
+    return std::system(command.c_str()) != -1;
+}
+
+/** Phase times of the output of --showtime=summary: "<phase>: <seconds>s (avg. ...)" */
+std::map<std::string, double> readPhases(const std::string &outputFile)
+{
+    std::map<std::string, double> phases;
+    std::ifstream fin(outputFile.c_str());
+    std::string line;
+    while (std::getline(fin, line)) {
+        const std::string::size_type avg = line.find("s (avg. ");
+        if (avg == std::string::npos)
+            continue;
+        const std::string::size_type colon = line.rfind(": ", avg);
+        if (colon == std::string::npos)
+            continue;
+        phases[line.substr(0, colon)] = std::atof(line.substr(colon + 2U, avg - colon - 2U).c_str());
+    }
+    return phases;
+}
+
+std::vector<int> sizes(int minSize, int maxSize, int factor)
+{
+    std::vector<int> ret;
+    for (long long size = minSize; size <= maxSize; size *= factor)
+        ret.push_back(static_cast<int>(size));
+    return ret;
+}
+
+/** Write the scripts of a project, the file list is returned */
+std::string writeProject(const Options &options, const std::string &name, int files, int lines)
+{
+    const std::string dir = options.corpus + '/' + name;
+    makeDirectory(dir);
+    makeDirectory(dir + "/scripts");
+    CorpusGenerator generator(options.seed);
+    const std::string fileList = dir + "/files.txt";
+    std::ofstream list(fileList.c_str());
+    for (int f = 0; f < files; ++f) {
+        const std::string fileName = dir + "/scripts/script" + std::to_string(f) + ".ctl";
+        std::ofstream fout(fileName.c_str(), std::ios::binary);
+        fout << generator.script(f, lines);
+        list << fileName << '\n';
+    }
+    return fileList;
+}
+
+Point measure(const Options &options, const std::string &name, int size, int files, int lines)
+{
+    const std::string fileList = writeProject(options, name, files, lines);
+    const std::string outputFile = options.corpus + '/' + name + "/output.txt";
+
+    Point point;
+    point.size = size;
+    const Clock::time_point start = Clock::now();
+    runCli(options.cli, "--showtime=summary --file-list=" + quote(fileList), outputFile);
+    point.wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    point.phases = readPhases(outputFile);
+    point.phases.erase("Overall time");
+    return point;
+}
+
+/** Least squares fit of log(time) = exponent * log(size) + c, the short times are skipped */
+bool fitExponent(const std::vector<Point> &points, const std::string &phase, double minSeconds, double *exponent)
+{
+    std::vector<std::pair<double, double>> logs;
+    for (const Point &point : points) {
+        const std::map<std::string, double>::const_iterator it = point.phases.find(phase);
+        const double seconds = phase.empty() ? point.wallSeconds : (it == point.phases.end() ? 0.0 : it->second);
+        if (seconds >= minSeconds)
+            logs.emplace_back(std::log(static_cast<double>(point.size)), std::log(seconds));
+    }
+    if (logs.size() < 3U)
+        return false;
+
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (const std::pair<double, double> &xy : logs) {
+        sx += xy.first;
+        sy += xy.second;
+        sxx += xy.first * xy.first;
+        sxy += xy.first * xy.second;
+    }
+    const double n = static_cast<double>(logs.size());
+    const double denominator = n * sxx - sx * sx;
+    if (denominator <= 0)
+        return false;
+    *exponent = (n * sxy - sx * sy) / denominator;
+    return true;
+}
+
+/** Measure an axis and fit the exponents, "wall" is the time of the command line tool */
+picojson::object runAxis(const Options &options, const std::string &axis, const std::vector<int> &axisSizes, std::map<std::string, double> &exponents)
+{
+    std::vector<Point> points;
+    picojson::array jsonPoints;
+    for (int size : axisSizes) {
+        const bool lines = axis == "lines";
+        const Point point = measure(options, axis + '_' + std::to_string(size), size, lines ? 1 : size, lines ? size : options.fileLines);
+        std::cerr << axis << ' ' << size << ": " << point.wallSeconds << "s" << std::endl;
+
+        picojson::object phases;
+        for (const std::pair<const std::string, double> &phase : point.phases)
+            phases[phase.first] = picojson::value(phase.second);
+        picojson::object jsonPoint;
+        jsonPoint["size"] = picojson::value(static_cast<double>(size));
+        jsonPoint["wallSeconds"] = picojson::value(point.wallSeconds);
+        jsonPoint["phases"] = picojson::value(phases);
+        jsonPoints.push_back(picojson::value(jsonPoint));
+        points.push_back(point);
+    }
+
+    std::map<std::string, bool> names;
+    for (const Point &point : points) {
+        for (const std::pair<const std::string, double> &phase : point.phases)
+            names[phase.first] = true;
+    }
+    names[""] = true;
+
+    picojson::object jsonExponents;
+    for (const std::pair<const std::string, bool> &name : names) {
+        double exponent;
+        if (!fitExponent(points, name.first, options.minSeconds, &exponent))
+            continue;
+        const std::string phase = name.first.empty() ? "wall" : name.first;
+        exponents[phase] = exponent;
+        jsonExponents[phase] = picojson::value(exponent);
+    }
+
+    picojson::object ret;
+    ret["points"] = picojson::value(jsonPoints);
+    ret["exponents"] = picojson::value(jsonExponents);
+    return ret;
+}
+
+/** Check the largest "files" project with several processes */
+picojson::array runWorkers(const Options &options, int files, const std::vector<int> &workerCounts)
+{
+    const std::string dir = options.corpus + "/files_" + std::to_string(files);
+    picojson::array ret;
+    double firstThroughput = 0;
+    for (int workers : workerCounts) {
+        std::vector<std::ofstream> lists(static_cast<std::size_t>(workers));
+        for (int w = 0; w < workers; ++w)
+            lists[w].open((dir + "/files_worker" + std::to_string(w) + ".txt").c_str());
+        for (int f = 0; f < files; ++f)
+            lists[f % workers] << dir << "/scripts/script" << f << ".ctl\n";
+        for (std::ofstream &list : lists)
+            list.close();
+
+        const Clock::time_point start = Clock::now();
+        std::vector<std::thread> threads;
+        for (int w = 0; w < workers; ++w) {
+            const std::string suffix = "_worker" + std::to_string(w) + ".txt";
+            threads.emplace_back(runCli, options.cli, "--file-list=" + quote(dir + "/files" + suffix), dir + "/output" + suffix);
+        }
+        for (std::thread &thread : threads)
+            thread.join();
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        const double throughput = files / seconds;
+        if (ret.empty())
+            firstThroughput = throughput;
+        std::cerr << "workers " << workers << ": " << seconds << "s, " << throughput << " files/s" << std::endl;
+
+        picojson::object result;
+        result["workers"] = picojson::value(static_cast<double>(workers));
+        result["files"] = picojson::value(static_cast<double>(files));
+        result["wallSeconds"] = picojson::value(seconds);
+        result["filesPerSecond"] = picojson::value(throughput);
+        result["speedup"] = picojson::value(throughput / firstThroughput);
+        ret.push_back(picojson::value(result));
+    }
+    return ret;
+}
+
+bool parseRange(const char *arg, int *minSize, int *maxSize)
+{
+    const char *colon = std::strchr(arg, ':');
+    if (!colon)
+        return false;
+    *minSize = std::atoi(arg);
+    *maxSize = std::atoi(colon + 1);
+    return *minSize > 0 && *maxSize >= *minSize;
+}
+
+/** Exponents of the baseline, by axis and phase */
+bool loadBaseline(const std::string &fileName, std::map<std::string, std::map<std::string, double>> &baseline)
+{
+    std::ifstream fin(fileName.c_str());
+    picojson::value json;
+    const std::string err = picojson::parse(json, fin);
+    if (!err.empty() || !json.is<picojson::object>())
+        return false;
+    const picojson::value &axes = json.get("axes");
+    if (!axes.is<picojson::object>())
+        return false;
+    for (const std::pair<const std::string, picojson::value> &axis : axes.get<picojson::object>()) {
+        const picojson::value &exponents = axis.second.get("exponents");
+        if (!exponents.is<picojson::object>())
+            continue;
+        for (const std::pair<const std::string, picojson::value> &exponent : exponents.get<picojson::object>()) {
+            if (exponent.second.is<double>())
+                baseline[axis.first][exponent.first] = exponent.second.get<double>();
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    options.cli = BENCH_CLI;
+    options.corpus = "ctrlppcheck-scaling-corpus";
+    options.seed = 1;
+    options.fileLines = 100;
+    options.minSeconds = 0.01;
+    int minLines = 100, maxLines = 25600;
+    int minFiles = 10, maxFiles = 640;
+    int factor = 4;
+    std::vector<int> workerCounts = { 1, 2, 4 };
+    double maxExponent = 1.5;
+    double tolerance = 0.25;
+    std::string baselineFile;
+    std::string outputFile;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--cli=", 6) == 0)
+            options.cli = argv[i] + 6;
+        else if (std::strncmp(argv[i], "--corpus=", 9) == 0)
+            options.corpus = argv[i] + 9;
+        else if (std::strncmp(argv[i], "--seed=", 7) == 0)
+            options.seed = std::strtoull(argv[i] + 7, nullptr, 10);
+        else if (std::strncmp(argv[i], "--lines=", 8) == 0 && parseRange(argv[i] + 8, &minLines, &maxLines))
+            ;
+        else if (std::strncmp(argv[i], "--files=", 8) == 0 && parseRange(argv[i] + 8, &minFiles, &maxFiles))
+            ;
+        else if (std::strncmp(argv[i], "--file-lines=", 13) == 0)
+            options.fileLines = std::max(1, std::atoi(argv[i] + 13));
+        else if (std::strncmp(argv[i], "--factor=", 9) == 0)
+            factor = std::max(2, std::atoi(argv[i] + 9));
+        else if (std::strncmp(argv[i], "--workers=", 10) == 0) {
+            workerCounts.clear();
+            std::istringstream iss(argv[i] + 10);
+            std::string count;
+            while (std::getline(iss, count, ','))
+                workerCounts.push_back(std::max(1, std::atoi(count.c_str())));
+        } else if (std::strncmp(argv[i], "--min-seconds=", 14) == 0)
+            options.minSeconds = std::atof(argv[i] + 14);
+        else if (std::strncmp(argv[i], "--max-exponent=", 15) == 0)
+            maxExponent = std::atof(argv[i] + 15);
+        else if (std::strncmp(argv[i], "--baseline=", 11) == 0)
+            baselineFile = argv[i] + 11;
+        else if (std::strncmp(argv[i], "--tolerance=", 12) == 0)
+            tolerance = std::atof(argv[i] + 12);
+        else if (std::strncmp(argv[i], "--output=", 9) == 0)
+            outputFile = argv[i] + 9;
+        else {
+            std::cerr << "ctrlppcheck-scaling: unknown option: " << argv[i] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::map<std::string, std::map<std::string, double>> baseline;
+    if (!baselineFile.empty() && !loadBaseline(baselineFile, baseline)) {
+        std::cerr << "ctrlppcheck-scaling: unable to load baseline: " << baselineFile << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    makeDirectory(options.corpus);
+    std::map<std::string, std::map<std::string, double>> exponents;
+    picojson::object axes;
+    axes["lines"] = picojson::value(runAxis(options, "lines", sizes(minLines, maxLines, factor), exponents["lines"]));
+    const std::vector<int> fileSizes = sizes(minFiles, maxFiles, factor);
+    axes["files"] = picojson::value(runAxis(options, "files", fileSizes, exponents["files"]));
+    const picojson::array workers = runWorkers(options, fileSizes.back(), workerCounts);
+
+    picojson::array failures;
+    for (const std::pair<const std::string, std::map<std::string, double>> &axis : exponents) {
+        for (const std::pair<const std::string, double> &exponent : axis.second) {
+            std::ostringstream failure;
+            failure << axis.first << ": " << exponent.first << ": exponent " << exponent.second;
+            if (exponent.second > maxExponent)
+                failure << " is super-linear, more than " << maxExponent;
+            else {
+                const std::map<std::string, double> &baseAxis = baseline[axis.first];
+                const std::map<std::string, double>::const_iterator base = baseAxis.find(exponent.first);
+                if (base == baseAxis.end() || exponent.second <= base->second + tolerance)
+                    continue;
+                failure << " regressed, the baseline is " << base->second;
+            }
+            std::cerr << failure.str() << std::endl;
+            failures.push_back(picojson::value(failure.str()));
+        }
+    }
+
+    picojson::object result;
+    result["seed"] = picojson::value(static_cast<double>(options.seed));
+    result["factor"] = picojson::value(static_cast<double>(factor));
+    result["fileLines"] = picojson::value(static_cast<double>(options.fileLines));
+    result["maxExponent"] = picojson::value(maxExponent);
+    result["axes"] = picojson::value(axes);
+    result["workers"] = picojson::value(workers);
+    result["failures"] = picojson::value(failures);
+    const std::string json = picojson::value(result).serialize(true);
+
+    if (outputFile.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream fout(outputFile.c_str());
+        fout << json;
+        if (!fout.good()) {
+            std::cerr << "ctrlppcheck-scaling: unable to write: " << outputFile << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    return failures.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
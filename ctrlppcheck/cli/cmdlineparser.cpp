@@ -34,11 +34,22 @@
 #include <cstdlib> // EXIT_FAILURE
 #include <cstring>
 #include <iostream>
+#include <limits>
 #include <list>
 #include <set>
 
 
 
+/** Parse an unsigned number, only digits: the stream would accept a sign or trailing characters */
+template<class T>
+static bool parseUnsigned(const std::string &str, T &value)
+{
+    if (str.empty() || str.find_first_not_of("0123456789") != std::string::npos)
+        return false;
+    std::istringstream iss(str);
+    return static_cast<bool>(iss >> value); // fails on overflow
+}
+
 static void addFilesToList(const std::string& FileList, std::vector<std::string>& PathNames)
 {
     // To keep things initially simple, if the file can't be opened, just be silent and move on.
@@ -162,11 +173,30 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
             else if (std::strncmp(argv[i], "--max-ctu-depth=", 16) == 0)
                 mSettings->maxCtuDepth = std::atoi(argv[i] + 16);
 
+            // Memory budget of a file in MiB
+            else if (std::strncmp(argv[i], "--max-memory=", 13) == 0) {
+                std::size_t mebibytes = 0;
+                if (!parseUnsigned(argv[i] + 13, mebibytes)) {
+                    printMessage("cppcheck: Argument must be an integer. Try something like '--max-memory=512'.");
+                    return false;
+                }
+                if (mebibytes > std::numeric_limits<std::size_t>::max() / (1024U * 1024U)) {
+                    printMessage("cppcheck: Argument to '--max-memory' is too large.");
+                    return false;
+                }
+                mSettings->maxMemory = mebibytes * 1024U * 1024U;
+            }
+
             else if (std::strcmp(argv[i], "--experimental-fast") == 0)
                 // Skip slow simplifications and see how that affect the results, the
                 // goal is to remove the simplifications.
                 mSettings->experimentalFast = true;
 
+            else if (std::strcmp(argv[i], "--legacy-known-variables") == 0)
+                // Simplify known variables with the old pattern based code
+                // instead of the ValueFlow values, to compare the results.
+                mSettings->legacyKnownVariables = true;
+
             // (Experimental) exception handling inside cppcheck client
             else if (std::strcmp(argv[i], "--exception-handling") == 0)
                 mSettings->exceptionHandling = true;
@@ -302,8 +332,29 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                 mSettings->namingRuleFile = Path::simplifyPath(Path::fromNativeSeparators(argv[i] + 19));
 
             // Write results in results.xml
-            else if (std::strcmp(argv[i], "--xml") == 0)
+            else if (std::strcmp(argv[i], "--xml") == 0) {
                 mSettings->xml = true;
+                mSettings->outputFormat = Settings::OUTPUT_XML;
+            }
+
+            // Format of the results
+            else if (std::strncmp(argv[i], "--output-format=", 16) == 0) {
+                const std::string format(argv[i] + 16);
+                mSettings->xml = false;
+                if (format == "text")
+                    mSettings->outputFormat = Settings::OUTPUT_TEXT;
+                else if (format == "xml") {
+                    mSettings->xml = true;
+                    mSettings->outputFormat = Settings::OUTPUT_XML;
+                } else if (format == "jsonl")
+                    mSettings->outputFormat = Settings::OUTPUT_JSONL;
+                else if (format == "sarif")
+                    mSettings->outputFormat = Settings::OUTPUT_SARIF;
+                else {
+                    printMessage("cppcheck: argument to '--output-format' must be 'text', 'xml', 'jsonl' or 'sarif'.");
+                    return false;
+                }
+            }
 
             // Define the XML file version (and enable XML output)
             else if (std::strncmp(argv[i], "--xml-version=", 14) == 0) {
@@ -323,6 +374,7 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
 
                 // Enable also XML if version is set
                 mSettings->xml = true;
+                mSettings->outputFormat = Settings::OUTPUT_XML;
             }
 
             // Only print something when there are errors
@@ -421,6 +473,24 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                 }
             }
 
+            // batch manifest: scripts that are checked from memory
+            else if (std::strncmp(argv[i], "--batch=", 8) == 0) {
+                const std::string manifest(argv[i] + 8);
+                std::ifstream fin;
+                if (manifest != "-")
+                    fin.open(manifest, std::ios::binary);
+                std::istream &istr = (manifest == "-") ? std::cin : fin;
+                std::string errorMessage;
+                if (!istr) {
+                    printMessage("cppcheck: Couldn't open the batch manifest: \"" + manifest + "\".");
+                    return false;
+                }
+                if (!mSettings->project.importBatchManifest(istr, &errorMessage)) {
+                    printMessage("cppcheck: Bad batch manifest \"" + manifest + "\", " + errorMessage + ".");
+                    return false;
+                }
+            }
+
             // file list specified
             else if (std::strncmp(argv[i], "--file-list=", 12) == 0) {
                 // open this file and read every input file (1 file name per line)
@@ -460,10 +530,27 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                 }
             }
 
-            // --library
+            // --library, loaded after all options are known
             else if (std::strncmp(argv[i], "--library=", 10) == 0) {
-                if (!CppCheckExecutor::tryLoadLibrary(mSettings->library, argv[0], argv[i]+10))
+                mLibraries.push_back(argv[i]+10);
+            }
+
+            // Directory of the library snapshots and the token images
+            else if (std::strncmp(argv[i], "--library-cache=", 16) == 0) {
+                mSettings->libraryCacheDir = Path::fromNativeSeparators(argv[i]+16);
+                if (mSettings->libraryCacheDir.empty()) {
+                    printMessage("cppcheck: No directory given to '--library-cache' option.");
                     return false;
+                }
+            }
+
+            // Directory of the cached results
+            else if (std::strncmp(argv[i], "--cache-dir=", 12) == 0) {
+                mSettings->cacheDir = Path::fromNativeSeparators(argv[i]+12);
+                if (mSettings->cacheDir.empty()) {
+                    printMessage("cppcheck: No directory given to '--cache-dir' option.");
+                    return false;
+                }
             }
 
             // Report progress
@@ -528,6 +615,8 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                     mSettings->showtime = SHOWTIME_SUMMARY;
                 else if (showtimeMode == "top5")
                     mSettings->showtime = SHOWTIME_TOP5;
+                else if (showtimeMode == "memory")
+                    mSettings->showtime = SHOWTIME_MEMORY;
                 else if (showtimeMode.empty())
                     mSettings->showtime = SHOWTIME_NONE;
                 else {
@@ -554,6 +643,16 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                         rule.pattern = "";
                         xmlGetText(pattern, rule.pattern);
 
+                        tinyxml2::XMLElement *budget = node->FirstChildElement("budget");
+                        if (budget) {
+                            std::string str;
+                            xmlGetText(budget, str);
+                            if (!parseUnsigned(str, rule.budget)) {
+                                printMessage("cppcheck: error: rule budget is not a number: " + str);
+                                return false;
+                            }
+                        }
+
                         tinyxml2::XMLElement *message = node->FirstChildElement("message");
                         if (message) {
                             tinyxml2::XMLElement *severity = message->FirstChildElement("severity");
@@ -578,6 +677,27 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                 }
             }
 
+            // Regex backend of the rules
+            else if (std::strncmp(argv[i], "--regex-engine=", 15) == 0) {
+                const std::string engine(argv[i] + 15);
+                if (engine == "auto")
+                    mSettings->regexEngine = Regex::AUTOMATIC;
+                else if (engine == "std")
+                    mSettings->regexEngine = Regex::STD;
+                else {
+                    printMessage("cppcheck: error: unrecognized regex engine: \"" + engine + "\". Supported engines: auto, std.");
+                    return false;
+                }
+            }
+
+            // Default match budget of the rules
+            else if (std::strncmp(argv[i], "--rule-match-budget=", 20) == 0) {
+                if (!parseUnsigned(argv[i] + 20, mSettings->ruleMatchBudget)) {
+                    printMessage("cppcheck: Argument must be an integer. Try something like '--rule-match-budget=1000000'.");
+                    return false;
+                }
+            }
+
             // Specify platform
             else if (std::strncmp(argv[i], "--platform=", 11) == 0) {
                 const std::string platform(11+argv[i]);
@@ -631,6 +751,9 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
 
     mSettings->project.ignorePaths(mIgnoredPaths);
 
+    if (!CppCheckExecutor::tryLoadLibraries(mSettings->library, argv[0], mLibraries, mSettings->libraryCacheDir))
+        return false;
+
     if (argc <= 1) {
         mShowHelp = true;
         mExitAfterPrint = true;
@@ -649,7 +772,7 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
   }
 
     // Print error only if we have "real" command and expect files
-    if (!mExitAfterPrint && mPathNames.empty() && mSettings->project.fileSettings.empty()) {
+    if (!mExitAfterPrint && mPathNames.empty() && mSettings->project.fileSettings.empty() && mSettings->project.virtualFiles.empty()) {
         printMessage("cppcheck: No C or C++ source files found.");
         return false;
     }
@@ -679,13 +802,25 @@ void CmdLineParser::printHelp()
               "    cppcheck [OPTIONS] [files or paths]\n"
               "\n"
               "If a directory is given instead of a filename, *.ctl files are\n"
-              " checked recursively from the given directory.\n\n"
+              " checked recursively from the given directory.\n"
+              "The scripts of panels in XML format are checked if the panel\n"
+              " (*.xml) is given as filename.\n\n"
               "Options:\n"
               "  Mandatory:\n"
               "    --winccoa-projectName=PROJ_NAME\n"
               "    --winCCOA-productCode=WinCCOA_PRODUCT_CODE\n"
               "\n"
               "  Optional:\n"
+              "    --batch=<manifest>   Check scripts given in a manifest instead of files, one\n"
+              "                         JSON object per line:\n"
+              "                         {\"file\": \"<name>\", \"content\": \"<script>\", \"line\": <n>}\n"
+              "                         <name> is used as file name in the results, the\n"
+              "                         optional \"line\" is the line of the first script line\n"
+              "                         in the original file. When manifest is '-' it is read\n"
+              "                         from standard input.\n"
+              "    --cache-dir=<dir>    Keep the results of the checked files in <dir>. A file\n"
+              "                         is only checked again when its code, the code of the\n"
+              "                         files it #uses or the options were changed.\n"
               "    --check-config       Check cppcheck configuration. The normal code\n"
               "                         analysis is disabled by this flag.\n"
               "    --check-library      Show information messages when library files have\n"
@@ -779,10 +914,27 @@ void CmdLineParser::printHelp()
               "                         distributed with Cppcheck is loaded automatically.\n"
               "                         For more information about library files, read the\n"
               "                         manual.\n"
+              "    --library-cache=<dir>\n"
+              "                         Keep a binary snapshot of the loaded library files in\n"
+              "                         <dir>. Later runs with the same library options load\n"
+              "                         the snapshot instead of parsing the XML files, as long\n"
+              "                         as the files are unchanged. The libraries included\n"
+              "                         with #uses are kept as token images in <dir> too,\n"
+              "                         they are read without lexing while unchanged.\n"
               "    --max-ctu-depth=N    Max depth in whole program analysis. The default value\n"
               "                         is 2. A larger value will mean more errors can be found\n"
               "                         but also means the analysis will be slower.\n"
+              "    --max-memory=<MiB>   Memory budget of the analysis data of a file. When the\n"
+              "                         tokens and the symbol database exceed it the ValueFlow\n"
+              "                         analysis is skipped, then the checks of the simplified\n"
+              "                         token list. --showtime=memory shows the memory used.\n"
               "    --output-file=<file> Write results to file, rather than standard error.\n"
+              "    --output-format=<format>\n"
+              "                         Format of the results:\n"
+              "                          * text  Text, see --template (default)\n"
+              "                          * xml   XML, same as --xml\n"
+              "                          * jsonl One JSON object per error and line\n"
+              "                          * sarif SARIF 2.1.0 log\n"
               "    --naming-rule-file=<file>   Use given naming rule file.\n"
               "                         The rules defined in the file are used to\n"
               "                         check the variable names.\n"
@@ -816,12 +968,27 @@ void CmdLineParser::printHelp()
               "                         using e.g. ~ for home folder does not work. It is\n"
               "                         currently only possible to apply the base paths to\n"
               "                         files that are on a lower level in the directory tree.\n"
+              "    --regex-engine=<engine>\n"
+              "                         Regex backend of the rules and naming rules:\n"
+              "                          * auto\n"
+              "                                 linear time automaton, std::regex for patterns\n"
+              "                                 with backreferences or lookahead (default)\n"
+              "                          * std\n"
+              "                                 std::regex for all patterns\n"
               "    --remove-unused-templates\n"
               "                         Remove unused templates.\n"
               "    --remove-unused-included-templates\n"
               "                         Remove unused templates in included files.\n"
               "    --report-progress    Report progress messages while checking a file.\n"
-              "    --rule-file=<file>   Use given rule file."
+              "    --rule-file=<file>   Use given rule file.\n"
+              "    --rule-match-budget=N\n"
+              "                         Max number of automaton steps of a rule for each\n"
+              "                         checked token list. If the budget is used up the\n"
+              "                         search is stopped and an error is reported. A rule\n"
+              "                         can set its own budget with <budget>. The default\n"
+              "                         value is 0 (unlimited). Rules matched with\n"
+              "                         std::regex can't be stopped, with a budget they are\n"
+              "                         skipped and an error is reported.\n"
           /// @todo link to own docu
               "    --suppress=<spec>    Suppress warnings that match <spec>. The format of\n"
               "                         <spec> is:\n"
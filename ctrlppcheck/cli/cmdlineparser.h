@@ -114,6 +114,7 @@ protected:
 private:
     std::vector<std::string> mPathNames;
     std::vector<std::string> mIgnoredPaths;
+    std::vector<std::string> mLibraries;
     Settings *mSettings;
     bool mShowHelp;
     bool mShowVersion;
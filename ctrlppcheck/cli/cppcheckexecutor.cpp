@@ -30,8 +30,8 @@
 #include "settings.h"
 #include "suppressions.h"
 #include "utils.h"
-#include "checkunusedfunctions.h"
 
+#include <atomic>
 #include <csignal>
 #include <cstdio>
 #include <cstdlib> // EXIT_SUCCESS and EXIT_FAILURE
@@ -66,6 +66,11 @@
 
 #if defined(_WIN32)
 #include <windows.h>
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 #if defined(_MSC_VER)
@@ -78,14 +83,37 @@
 
 
 /*static*/ FILE* CppCheckExecutor::exceptionOutput = stdout;
+/*static*/ int CppCheckExecutor::crashOutputFd = -1;
+/*static*/ const char * volatile CppCheckExecutor::crashResults = nullptr;
+/*static*/ volatile std::sig_atomic_t CppCheckExecutor::crashResultsSize = 0;
+
+/** Open the output file for the crash handlers, the results are appended */
+static int openCrashOutput(const std::string &fileName)
+{
+#if defined(_WIN32)
+    return _open(fileName.c_str(), _O_WRONLY | _O_APPEND | _O_BINARY);
+#else
+    return open(fileName.c_str(), O_WRONLY | O_APPEND);
+#endif
+}
+
+static void closeCrashOutput(int fd)
+{
+#if defined(_WIN32)
+    _close(fd);
+#else
+    close(fd);
+#endif
+}
 
 CppCheckExecutor::CppCheckExecutor()
-    : _settings(nullptr), latestProgressOutputTime(0), errorOutput(nullptr), errorlist(false)
+    : _settings(nullptr), latestProgressOutputTime(0), errorOutput(nullptr), sarifResultCount(0), errorlist(false)
 {
 }
 
 CppCheckExecutor::~CppCheckExecutor()
 {
+    flushResults();
     delete errorOutput;
 }
 
@@ -153,7 +181,29 @@ bool CppCheckExecutor::parseFromArgs(CppCheck *cppcheck, int argc, const char* c
             FileLister::recursiveAddFiles(_files, Path::toNativeSeparators(*iter), _settings->library.markupExtensions(), matcher);
     }
 
-    if (_files.empty() && settings.project.fileSettings.empty())
+    // panels in XML format, their scripts are checked instead of the file.
+    // Other XML files are checked as before, unreadable files are reported
+    // as error when the results are written.
+    _panelErrors.clear();
+    for (std::map<std::string, std::size_t>::iterator it = _files.begin(); it != _files.end();) {
+        if (Path::getFilenameExtensionInLowerCase(it->first) != ".xml" || settings.library.markupFile(it->first)) {
+            ++it;
+            continue;
+        }
+        std::string errorMessage;
+        const ImportProject::PanelImport result = settings.project.importPanel(it->first, &errorMessage);
+        if (result == ImportProject::PanelImport::NOT_A_PANEL) {
+            ++it;
+            continue;
+        }
+        if (result == ImportProject::PanelImport::FAILED) {
+            const std::list<ErrorLogger::ErrorMessage::FileLocation> callstack(1, ErrorLogger::ErrorMessage::FileLocation(it->first, 0));
+            _panelErrors.push_back(ErrorLogger::ErrorMessage(callstack, emptyString, Severity::error, "Failed to read panel. " + errorMessage, "panelReadError", false));
+        }
+        _files.erase(it++);
+    }
+
+    if (_files.empty() && settings.project.fileSettings.empty() && settings.project.virtualFiles.empty() && _panelErrors.empty())
     {
 
         std::string detail = !ignored.empty() ? " Maybe all paths were ignored?." : "";
@@ -174,8 +224,6 @@ int CppCheckExecutor::check(int argc, const char* const argv[])
     Preprocessor::missingIncludeFlag = false;
     Preprocessor::missingSystemIncludeFlag = false;
 
-    CheckUnusedFunctions::clear();
-
     CppCheck cppCheck(*this, true);
 
     const Settings& settings = cppCheck.settings();
@@ -365,6 +413,8 @@ static void CppcheckSignalHandler(int signo, siginfo_t * info, void * context)
     bool unexpectedSignal=true; // unexpected indicates program failure
     bool terminate=true; // exit process/thread
     const bool isAddressOnStack = IsAddressOnStack(info->si_addr);
+    // the results found so far are not lost
+    CppCheckExecutor::flushActiveResults();
     FILE* output = CppCheckExecutor::getExceptionOutput();
     switch (signo) {
     case SIGABRT:
@@ -678,6 +728,7 @@ namespace {
     int filterException(int code, PEXCEPTION_POINTERS ex)
     {
         FILE *outputFile = stdout;
+        CppCheckExecutor::flushActiveResults();
         fputs("Internal error: ", outputFile);
         switch (ex->ExceptionRecord->ExceptionCode) {
         case EXCEPTION_ACCESS_VIOLATION:
@@ -811,19 +862,33 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
 {
     Settings& settings = cppcheck.settings();
     _settings = &settings;
-
     if (settings.reportProgress)
         latestProgressOutputTime = std::time(nullptr);
 
     if (!settings.outputFile.empty()) {
         errorOutput = new std::ofstream(settings.outputFile);
+        crashOutputFd = openCrashOutput(settings.outputFile);
+    } else {
+        crashOutputFd = 2; // stderr
     }
 
     if (settings.xml) {
         reportErr(ErrorLogger::ErrorMessage::getXMLHeader());
+    } else if (settings.outputFormat == Settings::OUTPUT_SARIF) {
+        sarifResultCount = 0;
+        writeResult(ErrorLogger::ErrorMessage::getSARIFHeader());
     }
 
     unsigned int returnValue = 0;
+    for (const ErrorLogger::ErrorMessage &msg : _panelErrors) {
+        // the same suppressions as for the messages of the checks
+        const Suppressions::ErrorMessage errorMessage = msg.toSuppressionsErrorMessage();
+        if (settings.nomsg.isSuppressed(errorMessage))
+            continue;
+        reportErr(msg);
+        if (!settings.nofail.isSuppressed(errorMessage))
+            returnValue++;
+    }
     {
         // Single process
         settings.jointSuppressionReport = true;
@@ -839,6 +904,7 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
             if (!_settings->library.markupFile(i->first)
                 || !_settings->library.processMarkupAfterCode(i->first)) {
                 returnValue += cppcheck.check(i->first);
+                flushResults();
                 processedsize += i->second;
                 if (!settings.quiet)
                     reportStatus(c + 1, _files.size(), processedsize, totalfilesize);
@@ -850,16 +916,28 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
         c = 0;
         for (std::list<ImportProject::FileSettings>::const_iterator fs = settings.project.fileSettings.begin(); fs != settings.project.fileSettings.end(); ++fs) {
             returnValue += cppcheck.check(*fs);
+            flushResults();
             ++c;
             if (!settings.quiet)
                 reportStatus(c, settings.project.fileSettings.size(), c, settings.project.fileSettings.size());
         }
 
+        // scripts from the batch manifest
+        c = 0;
+        for (std::list<ImportProject::VirtualFile>::const_iterator vf = settings.project.virtualFiles.begin(); vf != settings.project.virtualFiles.end(); ++vf) {
+            returnValue += cppcheck.check(vf->filename, vf->content);
+            flushResults();
+            ++c;
+            if (!settings.quiet)
+                reportStatus(c, settings.project.virtualFiles.size(), c, settings.project.virtualFiles.size());
+        }
+
         // second loop to parse all markup files which may not work until all
         // c/cpp files have been parsed and checked
         for (std::map<std::string, std::size_t>::const_iterator i = _files.begin(); i != _files.end(); ++i) {
             if (_settings->library.markupFile(i->first) && _settings->library.processMarkupAfterCode(i->first)) {
                 returnValue += cppcheck.check(i->first);
+                flushResults();
                 processedsize += i->second;
                 if (!settings.quiet)
                     reportStatus(c + 1, _files.size(), processedsize, totalfilesize);
@@ -879,6 +957,11 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
                 if (err && returnValue == 0)
                     returnValue = settings.exitCode;
             }
+            for (const ImportProject::VirtualFile &vf : settings.project.virtualFiles) {
+                const bool err = reportUnmatchedSuppressions(settings.nomsg.getUnmatchedLocalSuppressions(vf.filename, enableUnusedFunctionCheck));
+                if (err && returnValue == 0)
+                    returnValue = settings.exitCode;
+            }
         }
 
         const bool err = reportUnmatchedSuppressions(settings.nomsg.getUnmatchedGlobalSuppressions(enableUnusedFunctionCheck));
@@ -906,9 +989,15 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
 
     if (settings.xml) {
         reportErr(ErrorLogger::ErrorMessage::getXMLFooter());
+    } else if (settings.outputFormat == Settings::OUTPUT_SARIF) {
+        writeResult(ErrorLogger::ErrorMessage::getSARIFFooter());
     }
+    flushResults();
 
     _settings = nullptr;
+    if (crashOutputFd > 2)
+        closeCrashOutput(crashOutputFd);
+    crashOutputFd = -1;
     if (returnValue)
         return settings.exitCode;
     return 0;
@@ -946,14 +1035,68 @@ void CppCheckExecutor::reportErr(const std::string &errmsg)
 
     _errorList.insert(errmsg);
     if (errorOutput)
-        *errorOutput << errmsg << std::endl;
+        writeResult(errmsg);
     else {
-        std::cerr << ansiToOEM(errmsg, (_settings == nullptr) ? true : !_settings->xml) << std::endl;
+        writeResult(ansiToOEM(errmsg, (_settings == nullptr) ? true : !_settings->xml));
+    }
+}
+
+void CppCheckExecutor::writeResult(const std::string &result)
+{
+    // the buffer may be reallocated, the crash handlers must not read it meanwhile
+    crashResultsSize = 0;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    resultBuffer += result;
+    resultBuffer += '\n';
+    publishResults();
+    if (resultBuffer.size() >= 64 * 1024)
+        flushResults();
+}
+
+void CppCheckExecutor::publishResults()
+{
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    crashResults = resultBuffer.data();
+    crashResultsSize = static_cast<std::sig_atomic_t>(resultBuffer.size());
+}
+
+void CppCheckExecutor::flushResults()
+{
+    if (resultBuffer.empty())
+        return;
+    crashResultsSize = 0;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    std::ostream &out = errorOutput ? static_cast<std::ostream &>(*errorOutput) : std::cerr;
+    out.write(resultBuffer.data(), static_cast<std::streamsize>(resultBuffer.size()));
+    out.flush();
+    resultBuffer.clear();
+}
+
+void CppCheckExecutor::flushActiveResults()
+{
+    const int fd = crashOutputFd;
+    const char *data = crashResults;
+    std::size_t size = static_cast<std::size_t>(crashResultsSize);
+    if (fd < 0 || !data)
+        return;
+    crashResultsSize = 0;
+    while (size > 0) {
+#if defined(_WIN32)
+        const int written = _write(fd, data, static_cast<unsigned int>(size));
+#else
+        const ssize_t written = write(fd, data, size);
+#endif
+        if (written <= 0)
+            break;
+        data += written;
+        size -= static_cast<std::size_t>(written);
     }
 }
 
 void CppCheckExecutor::reportOut(const std::string &outmsg)
 {
+    // keep the order of the results and the other output on the console
+    flushResults();
     std::cout << ansiToOEM(outmsg, true) << std::endl;
 }
 
@@ -1001,6 +1144,17 @@ void CppCheckExecutor::reportErr(const ErrorLogger::ErrorMessage &msg)
 {
     if (errorlist) {
         reportOut(msg.toXML());
+    } else if (_settings->outputFormat == Settings::OUTPUT_JSONL || _settings->outputFormat == Settings::OUTPUT_SARIF) {
+        resultLine.clear();
+        if (_settings->outputFormat == Settings::OUTPUT_JSONL)
+            msg.appendJSON(resultLine);
+        else
+            msg.appendSARIF(resultLine);
+        if (!_errorList.insert(resultLine).second)
+            return;
+        if (_settings->outputFormat == Settings::OUTPUT_SARIF && sarifResultCount++ > 0)
+            resultLine.insert(resultLine.begin(), ',');
+        writeResult(resultLine);
     } else if (_settings->xml) {
         reportErr(msg.toXML());
     } else {
@@ -1018,9 +1172,11 @@ FILE* CppCheckExecutor::getExceptionOutput()
     return exceptionOutput;
 }
 
-bool CppCheckExecutor::tryLoadLibrary(Library& destination, const char* basepath, const char* filename)
+bool CppCheckExecutor::tryLoadLibrary(Library& destination, const char* basepath, const char* filename, bool *complete)
 {
     const Library::Error err = destination.load(basepath, filename);
+    if (complete && err.errorcode != Library::OK)
+        *complete = false;
 
     if (err.errorcode == Library::UNKNOWN_ELEMENT)
         std::cout << "cppcheck: Found unknown elements in configuration file '" << filename << "': " << err.reason << std::endl;
@@ -1061,3 +1217,25 @@ bool CppCheckExecutor::tryLoadLibrary(Library& destination, const char* basepath
     }
     return true;
 }
+
+bool CppCheckExecutor::tryLoadLibraries(Library& destination, const char* basepath, const std::vector<std::string> &filenames, const std::string &cacheDir)
+{
+    // relative library paths are searched in the current and in the executable path
+    std::string key = std::string(basepath) + '\n' + Path::getCurrentPath();
+    for (const std::string &filename : filenames)
+        key += '\n' + filename;
+
+    if (!cacheDir.empty() && destination.loadSnapshot(cacheDir, key))
+        return true;
+
+    bool complete = true;
+    for (const std::string &filename : filenames) {
+        if (!tryLoadLibrary(destination, basepath, filename.c_str(), &complete))
+            return false;
+    }
+
+    // warnings of incomplete libraries are shown on every run
+    if (!cacheDir.empty() && complete && !destination.saveSnapshot(cacheDir, key))
+        std::cout << "cppcheck: Failed to write library snapshot to '" << cacheDir << "'." << std::endl;
+    return true;
+}
@@ -21,11 +21,14 @@
 
 #include "errorlogger.h"
 
+#include <csignal>
 #include <cstdio>
 #include <ctime>
+#include <list>
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 class CppCheck;
 class Library;
@@ -100,11 +103,26 @@ public:
     */
     static FILE* getExceptionOutput();
 
+    /**
+     * Write the buffered results of the running check, used by the signal and exception handlers.
+     * Only the complete results are written with write(), it is async-signal-safe.
+     */
+    static void flushActiveResults();
+
     /**
     * Tries to load a library and prints warning/error messages
+    * @param complete set to false if the library was not loaded completely, e.g. because of unknown XML elements
+    * @return false, if an error occurred (except unknown XML elements)
+    */
+    static bool tryLoadLibrary(Library& destination, const char* basepath, const char* filename, bool *complete = nullptr);
+
+    /**
+    * Loads the libraries, from a snapshot in cacheDir if possible, and prints warning/error messages.
+    * The snapshot is written after the libraries were loaded completely.
+    * @param cacheDir directory of the library snapshots, empty => no snapshot
     * @return false, if an error occurred (except unknown XML elements)
     */
-    static bool tryLoadLibrary(Library& destination, const char* basepath, const char* filename);
+    static bool tryLoadLibraries(Library& destination, const char* basepath, const std::vector<std::string> &filenames, const std::string &cacheDir);
 
 protected:
 
@@ -157,6 +175,12 @@ private:
     */
     int check_internal(CppCheck& cppcheck, int argc, const char* const argv[]);
 
+    /** Append a result line to the result buffer */
+    void writeResult(const std::string &result);
+
+    /** Write the buffered results to the error output */
+    void flushResults();
+
     /**
      * Pointer to current settings; set while check() is running.
      */
@@ -172,6 +196,11 @@ private:
      */
     std::map<std::string, std::size_t> _files;
 
+    /**
+     * Panels given as file that can't be read, reported with the results
+     */
+    std::list<ErrorLogger::ErrorMessage> _panelErrors;
+
     /**
      * Report progress time
      */
@@ -182,11 +211,43 @@ private:
      */
     static FILE* exceptionOutput;
 
+    /**
+     * Output of the results when the process crashes, -1 if no check is running
+     */
+    static int crashOutputFd;
+
+    /**
+     * The complete results in the result buffer, written when the process crashes.
+     * The size is 0 while the buffer is changed.
+     */
+    static const char * volatile crashResults;
+    static volatile std::sig_atomic_t crashResultsSize;
+
+    /** Make the changed result buffer known to the crash handlers */
+    void publishResults();
+
     /**
      * Error output
      */
     std::ofstream *errorOutput;
 
+    /**
+     * Results that are not written yet. They are written in large blocks,
+     * when the buffer is full, before other output, after each file and
+     * when the process crashes.
+     */
+    std::string resultBuffer;
+
+    /**
+     * Reused for formatting the JSON and SARIF results
+     */
+    std::string resultLine;
+
+    /**
+     * Number of SARIF results written (separated by commas)
+     */
+    std::size_t sarifResultCount;
+
     /**
      * Has --errorlist been given?
      */
@@ -36,6 +36,7 @@ else()
 endif()
 
 option(BUILD_TESTS          "Build tests"                                                   OFF)
+option(BUILD_BENCHMARKS     "Build benchmarks"                                              OFF)
 
 option(HAVE_RULES           "Usage of rules (needs PCRE library and headers)"               OFF)
 
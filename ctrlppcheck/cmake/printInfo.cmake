@@ -28,6 +28,7 @@ message( STATUS "USE_MATCHCOMPILER_OPT = ${USE_MATCHCOMPILER_OPT}" )
 message( STATUS )
 message( STATUS "BUILD_SHARED_LIBS =     ${BUILD_SHARED_LIBS}" )
 message( STATUS "BUILD_TESTS =           ${BUILD_TESTS}" )
+message( STATUS "BUILD_BENCHMARKS =      ${BUILD_BENCHMARKS}" )
 message( STATUS )
 message( STATUS "HAVE_RULES =            ${HAVE_RULES}" )
 message( STATUS )
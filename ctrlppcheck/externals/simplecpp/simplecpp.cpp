@@ -23,6 +23,7 @@
 #include "simplecpp.h"
 
 #include <algorithm>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <exception>
@@ -38,6 +39,8 @@
 #include <windows.h>
 #undef ERROR
 #undef TRUE
+#else
+#include <unistd.h>
 #endif
 
 static bool isHex(const std::string &s)
@@ -196,6 +199,12 @@ simplecpp::TokenList::TokenList(std::istream &istr, std::vector<std::string> &fi
     readfile(istr,filename,outputList);
 }
 
+simplecpp::TokenList::TokenList(const unsigned char *data, std::size_t size, std::vector<std::string> &filenames, const std::string &filename, OutputList *outputList)
+    : frontToken(NULL), backToken(NULL), files(filenames)
+{
+    readfile(data,size,filename,outputList);
+}
+
 simplecpp::TokenList::TokenList(const TokenList &other) : frontToken(NULL), backToken(NULL), files(other.files)
 {
     *this = other;
@@ -269,7 +278,61 @@ std::string simplecpp::TokenList::stringify() const
     return ret.str();
 }
 
-static unsigned char readChar(std::istream &istr, unsigned int bom)
+namespace {
+    /**
+     * Lexer input from a memory buffer. get(), peek(), unget() and good()
+     * behave like those of std::istream, including the state after reading
+     * past the end, but without the per character overhead of the stream.
+     */
+    class BufferStream {
+    public:
+        BufferStream(const unsigned char *data, std::size_t size) : mData(data), mSize(size), mPos(0), mEof(false), mFail(false) {}
+
+        int get() {
+            if (!good()) {
+                mFail = true;
+                return EOF;
+            }
+            if (mPos < mSize)
+                return mData[mPos++];
+            mEof = mFail = true;
+            return EOF;
+        }
+
+        int peek() {
+            if (!good()) {
+                mFail = true;
+                return EOF;
+            }
+            if (mPos < mSize)
+                return mData[mPos];
+            mEof = true;
+            return EOF;
+        }
+
+        void unget() {
+            mEof = false;
+            if (mFail || mPos == 0)
+                mFail = true;
+            else
+                --mPos;
+        }
+
+        bool good() const {
+            return !mEof && !mFail;
+        }
+
+    private:
+        const unsigned char * const mData;
+        const std::size_t mSize;
+        std::size_t mPos;
+        bool mEof;
+        bool mFail;
+    };
+}
+
+template<class Stream>
+static unsigned char readChar(Stream &istr, unsigned int bom)
 {
     unsigned char ch = (unsigned char)istr.get();
 
@@ -300,7 +363,8 @@ static unsigned char readChar(std::istream &istr, unsigned int bom)
     return ch;
 }
 
-static unsigned char peekChar(std::istream &istr, unsigned int bom)
+template<class Stream>
+static unsigned char peekChar(Stream &istr, unsigned int bom)
 {
     unsigned char ch = (unsigned char)istr.peek();
 
@@ -321,14 +385,16 @@ static unsigned char peekChar(std::istream &istr, unsigned int bom)
     return ch;
 }
 
-static void ungetChar(std::istream &istr, unsigned int bom)
+template<class Stream>
+static void ungetChar(Stream &istr, unsigned int bom)
 {
     istr.unget();
     if (bom == 0xfeff || bom == 0xfffe)
         istr.unget();
 }
 
-static unsigned char prevChar(std::istream &istr, unsigned int bom)
+template<class Stream>
+static unsigned char prevChar(Stream &istr, unsigned int bom)
 {
     ungetChar(istr, bom);
     ungetChar(istr, bom);
@@ -337,7 +403,8 @@ static unsigned char prevChar(std::istream &istr, unsigned int bom)
     return c;
 }
 
-static unsigned short getAndSkipBOM(std::istream &istr)
+template<class Stream>
+static unsigned short getAndSkipBOM(Stream &istr)
 {
     const int ch1 = istr.peek();
 
@@ -401,6 +468,18 @@ static bool isStringLiteralPrefix(const std::string &str)
 }
 
 void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filename, OutputList *outputList)
+{
+    readStream(istr, filename, outputList);
+}
+
+void simplecpp::TokenList::readfile(const unsigned char *data, std::size_t size, const std::string &filename, OutputList *outputList)
+{
+    BufferStream istr(data, size);
+    readStream(istr, filename, outputList);
+}
+
+template<class Stream>
+void simplecpp::TokenList::readStream(Stream &istr, const std::string &filename, OutputList *outputList)
 {
     std::stack<simplecpp::Location> loc;
 
@@ -1077,7 +1156,8 @@ void simplecpp::TokenList::removeComments()
     }
 }
 
-std::string simplecpp::TokenList::readUntil(std::istream &istr, const Location &location, const char start, const char end, OutputList *outputList, unsigned int bom)
+template<class Stream>
+std::string simplecpp::TokenList::readUntil(Stream &istr, const Location &location, const char start, const char end, OutputList *outputList, unsigned int bom)
 {
     std::string ret;
     ret += start;
@@ -1145,6 +1225,94 @@ unsigned int simplecpp::TokenList::fileIndex(const std::string &filename)
     return files.size() - 1U;
 }
 
+// token image: magic, format, size and hash of the code, tokens (line, column, string), hash of the image
+static const char tokenImageMagic[] = "simplecpp-tokens";
+static const unsigned int tokenImageFormat = 1U;
+
+/** FNV-1a hash */
+static unsigned long long hashData(const char *data, std::size_t size)
+{
+    unsigned long long h = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < size; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/** little endian, the image is the same on all platforms */
+static void putNumber(std::string &image, unsigned long long value, unsigned int bytes)
+{
+    for (unsigned int i = 0; i < bytes; ++i)
+        image += static_cast<char>((value >> (8U * i)) & 0xffU);
+}
+
+static unsigned long long getNumber(const std::string &image, std::size_t &pos, unsigned int bytes)
+{
+    unsigned long long value = 0;
+    for (unsigned int i = 0; i < bytes; ++i)
+        value |= static_cast<unsigned long long>(static_cast<unsigned char>(image[pos++])) << (8U * i);
+    return value;
+}
+
+std::string simplecpp::TokenList::image(const std::string &data) const
+{
+    std::string ret(tokenImageMagic, sizeof(tokenImageMagic));
+    putNumber(ret, tokenImageFormat, 4U);
+    putNumber(ret, data.size(), 8U);
+    putNumber(ret, hashData(data.data(), data.size()), 8U);
+    for (const Token *tok = cfront(); tok; tok = tok->next) {
+        putNumber(ret, tok->location.line, 4U);
+        putNumber(ret, tok->location.col, 4U);
+        putNumber(ret, tok->str().size(), 4U);
+        ret += tok->str();
+    }
+    putNumber(ret, hashData(ret.data(), ret.size()), 8U);
+    return ret;
+}
+
+/** Is it an intact image of the tokens of the code? */
+static bool isTokenImageOf(const std::string &image, const std::string &data)
+{
+    const std::size_t headerSize = sizeof(tokenImageMagic) + 4U + 8U + 8U;
+    if (image.size() < headerSize + 8U || image.compare(0, sizeof(tokenImageMagic), tokenImageMagic, sizeof(tokenImageMagic)) != 0)
+        return false;
+    const std::size_t end = image.size() - 8U;
+    std::size_t pos = end;
+    if (getNumber(image, pos, 8U) != hashData(image.data(), end))
+        return false;
+    pos = sizeof(tokenImageMagic);
+    return getNumber(image, pos, 4U) == tokenImageFormat && getNumber(image, pos, 8U) == data.size() &&
+           getNumber(image, pos, 8U) == hashData(data.data(), data.size());
+}
+
+bool simplecpp::TokenList::readImage(const std::string &image, const std::string &filename, const std::string &data)
+{
+    if (!isTokenImageOf(image, data))
+        return false;
+    const std::size_t end = image.size() - 8U;
+    std::size_t pos = sizeof(tokenImageMagic) + 4U + 8U + 8U;
+
+    Location location(files);
+    location.fileIndex = fileIndex(filename);
+    while (pos < end) {
+        if (end - pos < 12U) {
+            clear();
+            return false;
+        }
+        location.line = static_cast<unsigned int>(getNumber(image, pos, 4U));
+        location.col = static_cast<unsigned int>(getNumber(image, pos, 4U));
+        const std::size_t size = static_cast<std::size_t>(getNumber(image, pos, 4U));
+        if (size == 0U || size > end - pos) {
+            clear();
+            return false;
+        }
+        push_back(new Token(image.substr(pos, size), location));
+        pos += size;
+    }
+    return true;
+}
+
 
 namespace simplecpp {
 
@@ -1528,10 +1696,17 @@ static bool isCtrlFile(const std::string &path)
     return extension == ".ctl";
 }
 
+/** position of the scripts or panels directory in the path of a ctrl file, the project directory is in front of it */
+static std::string::size_type ctrlProjectDirEnd(const std::string &sourcefile)
+{
+    const std::string::size_type pos = sourcefile.find("/scripts/");
+    return (pos != std::string::npos) ? pos : sourcefile.find("/panels/");
+}
+
 
 /// @warning we dont check ctrl share libraries (.dll)
 /// @warning we dont crypted ctrl libs (.ctc)
-static std::string openHeader(std::ifstream &f, const simplecpp::DUI &dui, const std::string &sourcefile, const std::string &header, bool systemheader)
+static std::string lookupHeader(std::ifstream &f, const simplecpp::DUI &dui, const std::string &sourcefile, const std::string &header, bool systemheader)
 {
     if (isAbsolutePath(header)) {
         // is absolute path given.
@@ -1543,7 +1718,7 @@ static std::string openHeader(std::ifstream &f, const simplecpp::DUI &dui, const
     {
         // is ctrl code
         // try to find the ctrl lib relative to project directory.
-        const size_t pos = sourcefile.find("/scripts/");
+        const size_t pos = ctrlProjectDirEnd(sourcefile);
 
         if ( pos == std::string::npos ) {
             return "";
@@ -1588,6 +1763,174 @@ static std::string openHeader(std::ifstream &f, const simplecpp::DUI &dui, const
     return "";
 }
 
+/**
+ * Resolved headers of the whole run, including the headers that were not
+ * found. Every #uses of a library is otherwise searched again with a failing
+ * open() in each include path.
+ */
+class HeaderResolutionCache {
+public:
+    HeaderResolutionCache() : hits(0), misses(0) {}
+
+    /** the results depend on the include paths, they are cleared when the include paths change */
+    void setIncludePaths(const std::list<std::string> &includePaths) {
+        if (includePaths != mIncludePaths) {
+            mIncludePaths = includePaths;
+            mResolved.clear();
+        }
+    }
+
+    std::map<std::string, std::string> &resolved() {
+        return mResolved;
+    }
+
+    unsigned long long hits;
+    unsigned long long misses;
+
+private:
+    std::list<std::string> mIncludePaths;
+    std::map<std::string, std::string> mResolved;  // key => resolved path, empty if not found
+};
+
+static HeaderResolutionCache headerResolutionCache;
+
+/** Read an opened file with one read, false if its size is unknown */
+static bool readData(std::ifstream &f, std::string &data)
+{
+    f.seekg(0, std::ios::end);
+    const std::streamoff size = f.tellg();
+    f.seekg(0, std::ios::beg);
+    if (size <= 0 || !f.good()) {
+        f.clear();
+        return false;
+    }
+    data.resize(static_cast<std::size_t>(size));
+    f.read(&data[0], size);
+    data.resize(static_cast<std::size_t>(f.gcount()));
+    return true;
+}
+
+/** The token image of a file, the hash of the path tells apart the files with the same name */
+static std::string tokenImageFileName(const std::string &dir, const std::string &filename)
+{
+    std::ostringstream ret;
+    ret << dir;
+    if (!dir.empty() && dir[dir.size() - 1U] != '/' && dir[dir.size() - 1U] != '\\')
+        ret << '/';
+    ret << filename.substr(filename.find_last_of("/\\") + 1U) << '-' << std::hex << hashData(filename.data(), filename.size()) << ".tokens";
+    return ret.str();
+}
+
+/**
+ * Write the token image of a file. Another process may check the same file
+ * with the same image directory: an intact image is not written again, and
+ * the image is written to a temporary file that is renamed, so that a reader
+ * never sees a partly written image.
+ */
+static void writeTokenImage(const std::string &imageFileName, const std::string &image, const std::string &data)
+{
+    std::ifstream fimage(imageFileName.c_str(), std::ios::in | std::ios::binary);
+    std::string current;
+    if (fimage.is_open() && readData(fimage, current) && isTokenImageOf(current, data))
+        return;
+    fimage.close();
+
+    std::ostringstream tempFileName;
+#ifdef SIMPLECPP_WINDOWS
+    tempFileName << imageFileName << '.' << GetCurrentProcessId() << ".tmp";
+#else
+    tempFileName << imageFileName << '.' << getpid() << ".tmp";
+#endif
+    {
+        std::ofstream fout(tempFileName.str().c_str(), std::ios::binary);
+        fout.write(image.data(), image.size());
+        if (!fout.flush()) {
+            fout.close();
+            std::remove(tempFileName.str().c_str());
+            return;
+        }
+    }
+#ifdef SIMPLECPP_WINDOWS
+    const bool renamed = MoveFileExA(tempFileName.str().c_str(), imageFileName.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    const bool renamed = std::rename(tempFileName.str().c_str(), imageFileName.c_str()) == 0;
+#endif
+    if (!renamed)
+        std::remove(tempFileName.str().c_str());
+}
+
+/**
+ * Tokenize an opened file, it is read into memory with one read. With a
+ * token image directory the tokens are read from the image of the file, the
+ * image is written when the file is lexed.
+ */
+static simplecpp::TokenList *readTokenList(std::ifstream &f, std::vector<std::string> &files, const std::string &filename, const simplecpp::DUI &dui, simplecpp::OutputList *outputList)
+{
+    std::string data;
+    if (!readData(f, data)) {
+        // size unknown => read the stream
+        return new simplecpp::TokenList(f, files, filename, outputList);
+    }
+    if (dui.tokenImageDir.empty())
+        return new simplecpp::TokenList(reinterpret_cast<const unsigned char *>(data.data()), data.size(), files, filename, outputList);
+
+    const std::string imageFileName = tokenImageFileName(dui.tokenImageDir, filename);
+    std::ifstream fimage(imageFileName.c_str(), std::ios::in | std::ios::binary);
+    std::string image;
+    if (fimage.is_open() && readData(fimage, image)) {
+        simplecpp::TokenList *tokens = new simplecpp::TokenList(files);
+        if (tokens->readImage(image, filename, data))
+            return tokens;
+        delete tokens;
+    }
+    fimage.close();
+
+    // the messages of the lexer are not in the image, such files are lexed every time
+    simplecpp::OutputList outputs;
+    simplecpp::TokenList *tokens = new simplecpp::TokenList(reinterpret_cast<const unsigned char *>(data.data()), data.size(), files, filename, &outputs);
+    if (outputs.empty()) {
+        writeTokenImage(imageFileName, tokens->image(data), data);
+    } else if (outputList) {
+        outputList->splice(outputList->end(), outputs);
+    }
+    return tokens;
+}
+
+static std::string openHeader(std::ifstream &f, const simplecpp::DUI &dui, const std::string &sourcefile, const std::string &header, bool systemheader)
+{
+    // the lookup only depends on the project directory of ctrl files and on the directory of other files
+    std::string key;
+    const std::string::size_type scripts = isCtrlFile(sourcefile) ? ctrlProjectDirEnd(sourcefile) : std::string::npos;
+    if (scripts != std::string::npos)
+        key = "ctrl:" + sourcefile.substr(0, scripts);
+    else
+        key = (isCtrlFile(sourcefile) ? "ctrl:" : "c:") + sourcefile.substr(0, sourcefile.find_last_of("\\/") + 1U);
+    key += systemheader ? '<' : '"';
+    key += header;
+
+    headerResolutionCache.setIncludePaths(dui.includePaths);
+    std::map<std::string, std::string> &resolved = headerResolutionCache.resolved();
+    const std::map<std::string, std::string>::const_iterator it = resolved.find(key);
+    if (it != resolved.end()) {
+        ++headerResolutionCache.hits;
+        if (it->second.empty())
+            return "";
+        f.open(it->second.c_str());
+        return f.is_open() ? it->second : "";
+    }
+
+    ++headerResolutionCache.misses;
+    const std::string path = lookupHeader(f, dui, sourcefile, header, systemheader);
+    resolved[key] = path;
+    return path;
+}
+
+void simplecpp::getHeaderCacheStatistics(unsigned long long *hits, unsigned long long *misses)
+{
+    *hits = headerResolutionCache.hits;
+    *misses = headerResolutionCache.misses;
+}
+
 static std::string getFileName(const std::map<std::string, simplecpp::TokenList *> &filedata, const std::string &sourcefile, const std::string &header, const simplecpp::DUI &dui, bool systemheader)
 {
     if (filedata.empty()) {
@@ -1599,7 +1942,7 @@ static std::string getFileName(const std::map<std::string, simplecpp::TokenList
     if (isCtrlFile(sourcefile))
     {
         ///@todo search ctrl files also in included pathes
-        const size_t pos = sourcefile.find("/scripts/");
+        const size_t pos = ctrlProjectDirEnd(sourcefile);
         if (pos == std::string::npos) {
             return "";
         }
@@ -1653,11 +1996,11 @@ std::map<std::string, simplecpp::TokenList*> simplecpp::load(const simplecpp::To
         if (ret.find(filename) != ret.end())
             continue;
 
-        std::ifstream fin(filename.c_str());
+        std::ifstream fin(filename.c_str(), std::ios::in | std::ios::binary);
         if (!fin.is_open())
             continue;
 
-        TokenList *tokenlist = new TokenList(fin, fileNumbers, filename, outputList);
+        TokenList *tokenlist = readTokenList(fin, fileNumbers, filename, dui, outputList);
         if (!tokenlist->front()) {
             delete tokenlist;
             continue;
@@ -1697,7 +2040,7 @@ std::map<std::string, simplecpp::TokenList*> simplecpp::load(const simplecpp::To
         if (!f.is_open())
             continue;
 
-        TokenList *tokens = new TokenList(f, fileNumbers, header2, outputList);
+        TokenList *tokens = readTokenList(f, fileNumbers, header2, dui, outputList);
         ret[header2] = tokens;
         if (tokens->front())
             filelist.push_back(tokens->front());
@@ -1906,7 +2249,7 @@ static bool preprocessSharedPtr(simplecpp::TokenList &output, const simplecpp::T
 /**
  * Function preprocess token
  */
-static bool preprocessToken(simplecpp::TokenList &output, const simplecpp::Token **tok1, std::map<std::string, simplecpp::UserDefinedValue> defines,  std::vector<std::string> &files, simplecpp::OutputList *outputList)
+static bool preprocessToken(simplecpp::TokenList &output, const simplecpp::Token **tok1, const std::map<std::string, simplecpp::UserDefinedValue> &defines,  std::vector<std::string> &files, simplecpp::OutputList *outputList)
 {
   const simplecpp::Token *tok = *tok1;
 
@@ -2098,7 +2441,7 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
                     std::ifstream f;
                     header2 = openHeader(f, dui, rawtok->location.file(), header, systemheader);
                     if (f.is_open()) {
-                        TokenList *tokens = new TokenList(f, files, header2, outputList);
+                        TokenList *tokens = readTokenList(f, files, header2, dui, outputList);
                         filedata[header2] = tokens;
                     }
                 }
@@ -179,6 +179,8 @@ namespace simplecpp {
     public:
         explicit TokenList(std::vector<std::string> &filenames);
         TokenList(std::istream &istr, std::vector<std::string> &filenames, const std::string &filename=std::string(), OutputList *outputList = 0);
+        /** Tokenize the content of a memory buffer, faster than reading it through a stream */
+        TokenList(const unsigned char *data, std::size_t size, std::vector<std::string> &filenames, const std::string &filename=std::string(), OutputList *outputList = 0);
         TokenList(const TokenList &other);
         ~TokenList();
         TokenList &operator=(const TokenList &other);
@@ -193,10 +195,24 @@ namespace simplecpp {
         std::string stringify() const;
 
         void readfile(std::istream &istr, const std::string &filename=std::string(), OutputList *outputList = 0);
+        void readfile(const unsigned char *data, std::size_t size, const std::string &filename=std::string(), OutputList *outputList = 0);
         void constFold();
 
         void removeComments();
 
+        /**
+         * Image of the tokens of a file, they are read again with readImage()
+         * without lexing the code. The image contains no addresses.
+         * @param data code of the file, the image is only valid for the same code
+         */
+        std::string image(const std::string &data) const;
+
+        /**
+         * Read the tokens of a file from its image
+         * @return false if the image is damaged or the code of the file changed
+         */
+        bool readImage(const std::string &image, const std::string &filename, const std::string &data);
+
         Token *front() {
             return frontToken;
         }
@@ -257,7 +273,11 @@ namespace simplecpp {
         void constFoldLogicalOp(Token *tok);
         void constFoldQuestionOp(Token **tok1);
 
-        std::string readUntil(std::istream &istr, const Location &location, const char start, const char end, OutputList *outputList, unsigned int bom);
+        template<class Stream>
+        void readStream(Stream &istr, const std::string &filename, OutputList *outputList);
+
+        template<class Stream>
+        std::string readUntil(Stream &istr, const Location &location, const char start, const char end, OutputList *outputList, unsigned int bom);
 
         std::string lastLine(int maxsize=100000) const;
 
@@ -286,6 +306,8 @@ namespace simplecpp {
         std::set<std::string> undefined;
         std::list<std::string> includePaths;
         std::list<std::string> includes;
+        /** directory of the token images of the loaded files, empty => the files are lexed */
+        std::string tokenImageDir;
     };
 
     SIMPLECPP_LIB std::map<std::string, TokenList*> load(const TokenList &rawtokens, std::vector<std::string> &filenames, const DUI &dui, OutputList *outputList = 0);
@@ -310,6 +332,13 @@ namespace simplecpp {
     /** Simplify path */
     SIMPLECPP_LIB std::string simplifyPath(std::string path);
 
+    /**
+     * Statistics of the header resolution cache
+     * @param hits headers resolved from the cache
+     * @param misses headers searched in the file system
+     */
+    SIMPLECPP_LIB void getHeaderCacheStatistics(unsigned long long *hits, unsigned long long *misses);
+
     /** Convert Cygwin path to Windows path */
     SIMPLECPP_LIB std::string convertCygwinToWindowsPath(const std::string &cygwinPath);
 }
@@ -27,6 +27,7 @@
 #include "token.h"
 #include "valueflow.h"
 
+#include <algorithm>
 #include <list>
 #include <stack>
 
@@ -432,6 +433,105 @@ bool isSameExpression(const Token *tok1, const Token *tok2, const Library &libra
     return commutativeEquals;
 }
 
+static std::size_t combineHash(std::size_t seed, std::size_t value)
+{
+    return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+std::size_t ExpressionHasher::hash(const Token *tok)
+{
+    if (!tok)
+        return 1;
+    const std::unordered_map<const Token *, std::size_t>::const_iterator it = mTokenHash.find(tok);
+    if (it != mTokenHash.end())
+        return it->second;
+
+    std::size_t h = 0;
+    // Same normalizations as in isSameExpression: this.x => x, !!x => x
+    if (tok->str() == "." && tok->astOperand1() && tok->astOperand1()->str() == "this")
+        h = hash(tok->astOperand2());
+    else if (Token::simpleMatch(tok, "!") && Token::simpleMatch(tok->astOperand1(), "!") && !Token::simpleMatch(tok->astParent(), "="))
+        h = hash(tok->astOperand1()->astOperand1());
+    else if (mFollowVar && Token::Match(tok, "%var%") && getVariableInitExpression(tok->variable()))
+        h = hashVariable(tok);
+    else {
+        const std::size_t h1 = hash(tok->astOperand1());
+        const std::size_t h2 = hash(tok->astOperand2());
+        if (h1 != 0 && h2 != 0) {
+            // operands of < > and <= >= can be swapped, commutative operators
+            // are compared in both orders
+            if (Token::Match(tok, "<|>|<=|>=")) {
+                h = std::hash<std::string>()(tok->str().size() == 1U ? "<" : "<=");
+                h = combineHash(h, std::min(h1, h2));
+                h = combineHash(h, std::max(h1, h2));
+            } else {
+                h = combineHash(std::hash<std::string>()(tok->str()), tok->varId());
+                if (tok->isBinaryOp() && Token::Match(tok, "%or%|%oror%|+|*|&|&&|^|==|!=")) {
+                    h = combineHash(h, std::min(h1, h2));
+                    h = combineHash(h, std::max(h1, h2));
+                } else {
+                    h = combineHash(h, h1);
+                    h = combineHash(h, h2);
+                }
+            }
+            if (h == 0)
+                h = 1;
+        }
+    }
+    mTokenHash[tok] = h;
+    return h;
+}
+
+std::size_t ExpressionHasher::hashVariable(const Token *tok)
+{
+    // A variable may be replaced by its initialization expression in
+    // isSameExpression, so all its occurrences get the hash of that expression.
+    const Variable *var = tok->variable();
+    const std::unordered_map<const Variable *, std::size_t>::const_iterator it = mVariableHash.find(var);
+    if (it != mVariableHash.end())
+        return it->second;
+    // recursive initialization => not hashable
+    mVariableHash[var] = 0;
+    const std::size_t h = hash(getVariableInitExpression(var));
+    mVariableHash[var] = h;
+    return h;
+}
+
+ExpressionBuckets::ExpressionBuckets(ExpressionHasher &hasher, const std::vector<const Token *> &exprs)
+    : mHasher(hasher)
+{
+    for (std::size_t i = 0; i < exprs.size(); ++i) {
+        if (exprs[i])
+            mBuckets[mHasher.hash(exprs[i])].push_back(i);
+    }
+}
+
+static void appendIndexes(const std::vector<std::size_t> &bucket, std::size_t first, std::vector<std::size_t> &ret)
+{
+    ret.insert(ret.end(), std::lower_bound(bucket.begin(), bucket.end(), first), bucket.end());
+}
+
+std::vector<std::size_t> ExpressionBuckets::candidates(const Token *tok, std::size_t first) const
+{
+    std::vector<std::size_t> ret;
+    const std::size_t h = mHasher.hash(tok);
+    if (h == 0) {
+        // may be the same as any expression
+        for (const std::pair<const std::size_t, std::vector<std::size_t>> &bucket : mBuckets)
+            appendIndexes(bucket.second, first, ret);
+    } else {
+        // the expressions with hash 0 may be the same as any expression
+        std::unordered_map<std::size_t, std::vector<std::size_t>>::const_iterator it = mBuckets.find(h);
+        if (it != mBuckets.end())
+            appendIndexes(it->second, first, ret);
+        it = mBuckets.find(0);
+        if (it != mBuckets.end())
+            appendIndexes(it->second, first, ret);
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
 bool isEqualKnownValue(const Token * const tok1, const Token * const tok2)
 {
     return tok1->hasKnownValue() && tok2->hasKnownValue() && tok1->values() == tok2->values();
@@ -832,8 +932,75 @@ bool isVariableChangedByFunctionCall(const Token *tok, const Settings *settings,
     return arg && !arg->isConst() && arg->isReference();
 }
 
+/** Is the variable token changed at this location? */
+static bool isVariableChangedAt(const Token *tok, const Settings *settings)
+{
+    if (Token::Match(tok->astParent(), "++|--"))
+        return true;
+
+    if (tok->astParent() && tok->astParent()->isAssignmentOp() && tok == tok->astParent()->astOperand1())
+        return true;
+
+    if (isLikelyStreamRead(tok->previous()))
+        return true;
+
+    // Member function call
+    if (Token::Match(tok, "%name% . %name% (")) {
+        const Variable *var = tok->variable();
+        bool isConst = var && var->isConst();
+        if (!isConst && var) {
+            const ValueType * valueType = var->valueType();
+            isConst = (valueType && valueType->constness == 1);
+        }
+
+        const Token *ftok = tok->tokAt(2);
+        const Function * fun = ftok->function();
+        if (!isConst && (!fun || !fun->isConst()))
+            return true;
+    }
+
+    const Token *ftok = tok;
+    while (ftok && (!Token::Match(ftok, "[({[]") || ftok->isCast()))
+        ftok = ftok->astParent();
+
+    if (ftok && Token::Match(ftok->link(), ") !!{")) {
+        bool inconclusive = false;
+        bool isChanged = isVariableChangedByFunctionCall(tok, settings, &inconclusive);
+        isChanged |= inconclusive;
+        if (isChanged)
+            return true;
+    }
+
+    const Token *parent = tok->astParent();
+    while (Token::Match(parent, ".|::"))
+        parent = parent->astParent();
+    if (parent && parent->tokType() == Token::eIncDecOp)
+        return true;
+
+    return false;
+}
+
+static const VariableChangeIndex *getVariableChangeIndex(const Token *start, const Token *end, const Settings *settings)
+{
+    const Scope *scope = start->scope();
+    while (scope && scope->type != Scope::eFunction)
+        scope = scope->nestedIn;
+    if (!scope || !scope->check)
+        return nullptr;
+    const VariableChangeIndex *index = scope->check->getVariableChangeIndex(scope);
+    if (!index || index->settings() != settings || !index->contains(start, end))
+        return nullptr;
+    return index;
+}
+
 bool isVariableChanged(const Token *start, const Token *end, const unsigned int varid, bool globalvar, const Settings *settings)
 {
+    if (varid && start) {
+        const VariableChangeIndex *index = getVariableChangeIndex(start, end, settings);
+        if (index)
+            return index->isChanged(start, end, varid, globalvar);
+    }
+
     for (const Token *tok = start; tok != end; tok = tok->next()) {
         if (tok->varId() != varid) {
             if (globalvar && Token::Match(tok, "%name% ("))
@@ -842,49 +1009,54 @@ bool isVariableChanged(const Token *start, const Token *end, const unsigned int
             continue;
         }
 
-        const Token *tok2 = tok;
-
-        if (Token::Match(tok2->astParent(), "++|--"))
-            return true;
-
-        if (tok2->astParent() && tok2->astParent()->isAssignmentOp() && tok2 == tok2->astParent()->astOperand1())
+        if (isVariableChangedAt(tok, settings))
             return true;
+    }
+    return false;
+}
 
-        if (isLikelyStreamRead(tok->previous()))
-            return true;
+VariableChangeIndex::VariableChangeIndex(const Scope *functionScope, const Settings *settings)
+    : mSettings(settings)
+{
+    unsigned int pos = 0;
+    for (const Token *tok = functionScope->bodyStart; tok != functionScope->bodyEnd; tok = tok->next(), ++pos) {
+        mPosition[tok] = pos;
+        if (tok->varId() && isVariableChangedAt(tok, settings))
+            mChanges[tok->varId()].push_back(pos);
+        if (Token::Match(tok, "%name% ("))
+            mCalls.emplace_back(pos, tok->varId());
+    }
+    // the end of the body and the token after it are valid range ends
+    mPosition[functionScope->bodyEnd] = pos;
+    if (functionScope->bodyEnd->next())
+        mPosition[functionScope->bodyEnd->next()] = pos + 1;
+}
 
-        // Member function call
-        if (Token::Match(tok, "%name% . %name% (")) {
-            const Variable *var = tok->variable();
-            bool isConst = var && var->isConst();
-            if (!isConst && var) {
-                const ValueType * valueType = var->valueType();
-                isConst = (valueType && valueType->constness == 1);
-            }
+bool VariableChangeIndex::contains(const Token *start, const Token *end) const
+{
+    const std::unordered_map<const Token *, unsigned int>::const_iterator it1 = mPosition.find(start);
+    const std::unordered_map<const Token *, unsigned int>::const_iterator it2 = mPosition.find(end);
+    return it1 != mPosition.end() && it2 != mPosition.end() && it1->second <= it2->second;
+}
 
-            const Token *ftok = tok->tokAt(2);
-            const Function * fun = ftok->function();
-            if (!isConst && (!fun || !fun->isConst()))
-                return true;
-        }
+bool VariableChangeIndex::isChanged(const Token *start, const Token *end, unsigned int varid, bool globalvar) const
+{
+    const unsigned int first = mPosition.at(start);
+    const unsigned int last = mPosition.at(end);
 
-        const Token *ftok = tok;
-        while (ftok && (!Token::Match(ftok, "[({[]") || ftok->isCast()))
-            ftok = ftok->astParent();
+    const std::unordered_map<unsigned int, std::vector<unsigned int>>::const_iterator changes = mChanges.find(varid);
+    if (changes != mChanges.end()) {
+        const std::vector<unsigned int>::const_iterator it = std::lower_bound(changes->second.begin(), changes->second.end(), first);
+        if (it != changes->second.end() && *it < last)
+            return true;
+    }
 
-        if (ftok && Token::Match(ftok->link(), ") !!{")) {
-            bool inconclusive = false;
-            bool isChanged = isVariableChangedByFunctionCall(tok, settings, &inconclusive);
-            isChanged |= inconclusive;
-            if (isChanged)
+    if (globalvar) {
+        std::vector<std::pair<unsigned int, unsigned int>>::const_iterator it = std::lower_bound(mCalls.begin(), mCalls.end(), std::make_pair(first, 0U));
+        for (; it != mCalls.end() && it->first < last; ++it) {
+            if (it->second != varid)
                 return true;
         }
-
-        const Token *parent = tok->astParent();
-        while (Token::Match(parent, ".|::"))
-            parent = parent->astParent();
-        if (parent && parent->tokType() == Token::eIncDecOp)
-            return true;
     }
     return false;
 }
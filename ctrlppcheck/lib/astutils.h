@@ -22,13 +22,17 @@
 #define astutilsH
 //---------------------------------------------------------------------------
 
+#include <cstddef>
 #include <functional>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "errorlogger.h"
 
 class Library;
+class Scope;
 class Settings;
 class Token;
 class Variable;
@@ -73,6 +77,54 @@ bool precedes(const Token * tok1, const Token * tok2);
 
 bool isSameExpression(const Token *tok1, const Token *tok2, const Library& library, bool pure, bool followVar, ErrorPath* errors=nullptr);
 
+/**
+ * @brief Memoized structural hash of AST subtrees.
+ * Expressions that isSameExpression() may consider equal always get the same
+ * hash, so candidates with different hashes can be skipped without a full
+ * comparison. The hash is independent of 'pure', with followVar the variables
+ * are hashed by their initialization expression.
+ */
+class ExpressionHasher {
+public:
+    explicit ExpressionHasher(bool followVar) : mFollowVar(followVar) {}
+
+    /** 0 => expression can't be hashed and may be the same as any other expression */
+    std::size_t hash(const Token *tok);
+
+    /** false => isSameExpression(tok1, tok2, ..) is false */
+    bool mayBeSame(const Token *tok1, const Token *tok2) {
+        const std::size_t h1 = hash(tok1);
+        const std::size_t h2 = hash(tok2);
+        return h1 == 0 || h2 == 0 || h1 == h2;
+    }
+
+private:
+    std::size_t hashVariable(const Token *tok);
+
+    const bool mFollowVar;
+    std::unordered_map<const Token *, std::size_t> mTokenHash;
+    std::unordered_map<const Variable *, std::size_t> mVariableHash;
+};
+
+/**
+ * @brief Expressions of a list indexed by their hash.
+ * The expressions that may be the same as a given expression are found
+ * without comparing it with every expression of the list.
+ */
+class ExpressionBuckets {
+public:
+    /** null expressions are not indexed */
+    ExpressionBuckets(ExpressionHasher &hasher, const std::vector<const Token *> &exprs);
+
+    /** Indexes of the expressions from 'first' on that may be the same as tok, ascending */
+    std::vector<std::size_t> candidates(const Token *tok, std::size_t first) const;
+
+private:
+    ExpressionHasher &mHasher;
+    /** hash => indexes, ascending */
+    std::unordered_map<std::size_t, std::vector<std::size_t>> mBuckets;
+};
+
 bool isEqualKnownValue(const Token * const tok1, const Token * const tok2);
 
 bool isDifferentKnownValues(const Token * const tok1, const Token * const tok2);
@@ -125,6 +177,40 @@ bool isVariableChanged(const Token *start, const Token *end, const unsigned int
 
 bool isVariableChanged(const Variable * var, const Settings *settings);
 
+/**
+ * @brief Def-use index of a function body.
+ * Stores for every variable the positions where it is (possibly) changed and
+ * the positions of all function calls. The index is built once per function
+ * (see SymbolDatabase::getVariableChangeIndex()) so that isVariableChanged()
+ * queries inside the function are binary searches instead of token scans.
+ */
+class VariableChangeIndex {
+public:
+    VariableChangeIndex(const Scope *functionScope, const Settings *settings);
+
+    /** Can the range [start,end) be answered by this index? */
+    bool contains(const Token *start, const Token *end) const;
+
+    /** Same result as isVariableChanged(start, end, varid, globalvar, settings) */
+    bool isChanged(const Token *start, const Token *end, unsigned int varid, bool globalvar) const;
+
+    const Settings *settings() const {
+        return mSettings;
+    }
+
+private:
+    const Settings *mSettings;
+
+    /** position of every token in the function body */
+    std::unordered_map<const Token *, unsigned int> mPosition;
+
+    /** varid => sorted positions where the variable is changed */
+    std::unordered_map<unsigned int, std::vector<unsigned int>> mChanges;
+
+    /** sorted positions of "%name% (" with the varid of the name token */
+    std::vector<std::pair<unsigned int, unsigned int>> mCalls;
+};
+
 /** Determines the number of arguments - if token is a function call or macro
  * @param start token which is supposed to be the function/macro name.
  * \return Number of arguments
@@ -195,7 +195,7 @@ bool CalculationsSimplifier::simplifyCalculations(Token* frontToken, Token *back
         }
 
         if (Token::Match(tok->previous(), "(|&&|%oror% %char% %comp% %num% &&|%oror%|)")) {
-            tok->str(MathLib::toString(MathLib::toLongNumber(tok->str())));
+            tok->str(MathLib::toString(tok->getIntNumber()));
         }
 
         if (tok->isNumber()) {
@@ -314,12 +314,12 @@ bool CalculationsSimplifier::simplifyCalculations(Token* frontToken, Token *back
             }
 
             if (Token::Match(tok, "%num% %comp% %num%") &&
-                MathLib::isInt(tok->str()) &&
-                MathLib::isInt(tok->strAt(2))) {
+                tok->isIntNumber() &&
+                tok->tokAt(2)->isIntNumber()) {
                 if (Token::Match(tok->previous(), "(|&&|%oror%") && Token::Match(tok->tokAt(3), ")|&&|%oror%|?")) {
-                    const MathLib::bigint op1(MathLib::toLongNumber(tok->str()));
+                    const MathLib::bigint op1(tok->getIntNumber());
                     const std::string &cmp(tok->next()->str());
-                    const MathLib::bigint op2(MathLib::toLongNumber(tok->strAt(2)));
+                    const MathLib::bigint op2(tok->tokAt(2)->getIntNumber());
 
                     std::string result;
 
@@ -345,4 +345,4 @@ bool CalculationsSimplifier::simplifyCalculations(Token* frontToken, Token *back
         }
     }
     return ret;
-}
\ No newline at end of file
+}
\ No newline at end of file
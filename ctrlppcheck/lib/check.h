@@ -74,6 +74,22 @@ public:
     /** run checks, the token list is simplified */
     virtual void runSimplifiedChecks(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger) = 0;
 
+    /** Optional analysis results, these are only computed if some check needs them */
+    enum Needs {
+        NEEDS_VALUEFLOW = 0x1,  ///< ValueFlow values in the normal token list
+        NEEDS_SIMPLIFIED = 0x2  ///< simplified token list for runSimplifiedChecks()
+    };
+
+    /**
+     * Which optional analysis results does the check use with the given settings.
+     * Tokens, AST, symbol database and value types are always available.
+     * @return bitmask of Needs
+     */
+    virtual unsigned int neededResults(const Settings *settings) const {
+        (void)settings;
+        return NEEDS_VALUEFLOW | NEEDS_SIMPLIFIED;
+    }
+
     /** get error messages */
     virtual void getErrorMessages(ErrorLogger *errorLogger, const Settings *settings) const = 0;
 
@@ -168,7 +184,7 @@ protected:
         ErrorPath errorPath;
         if (!value) {
             errorPath.emplace_back(errtok,bug);
-        } else if (mSettings->verbose || mSettings->xml || !mSettings->templateLocation.empty()) {
+        } else if (mSettings->verbose || mSettings->xml || mSettings->outputFormat != Settings::OUTPUT_TEXT || !mSettings->templateLocation.empty()) {
             errorPath = value->errorPath;
             errorPath.emplace_back(errtok,bug);
         } else {
@@ -69,6 +69,12 @@ void CheckReturnValueOfFunction::returnValueMatch(void)
         const bool hasNoReturnType = declType == scope->function->name();
         bool hasReturn = false;
 
+        // interned, the return values of the same type share it. Classes are
+        // no ctrl types, they are compared by name
+        ValueType declValueType;
+        declValueType.type = ValueType::typeFromString(declType);
+        const ValueType *declVt = mTokenizer->list.internValueType(declValueType);
+
         for (const Token *tok = scope->bodyStart->next(); tok && (tok != scope->bodyEnd); tok = tok->next())
         {
             if (!Token::simpleMatch(tok, "return"))
@@ -108,9 +114,11 @@ void CheckReturnValueOfFunction::returnValueMatch(void)
                     /// @todo throw some debug here.
                     continue;
                 }
+                const bool canCast = declVt->isKnownType() ?
+                                     retValueType->canCastTo(*declVt) :
+                                     (declType == retType || declType == retValueType->typeToString());
                 if (prioWarning &&
-                    (declType != retType) &&
-                    !retValueType->canCastTo(declType) &&
+                    !canCast &&
                     mSettings->inconclusive)
                 {
                     returnValueNotMatchError(tok, retType, declType);
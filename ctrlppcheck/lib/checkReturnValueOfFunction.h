@@ -47,6 +47,10 @@ public:
         (void)errorLogger;
     }
 
+    unsigned int neededResults(const Settings * /*settings*/) const OVERRIDE {
+        return 0;
+    }
+
     /** @brief %Check if a function return values mathces with declaration */
     void returnValueMatch();
 
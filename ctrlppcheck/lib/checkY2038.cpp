@@ -30,6 +30,19 @@ static const CWE CWE704(704U); // Incorrect Type Conversion or Cast
 static const struct CWE CWE758(758U); // Reliance on Undefined, Unspecified, or Implementation-Defined Behavior
 
 
+//---------------------------------------------------------------------------
+/** Symbol name for the error message, the error list has no tokens */
+static std::string symbolName(const Token *tok, const char *defaultName)
+{
+  return tok ? tok->str() : defaultName;
+}
+
+//---------------------------------------------------------------------------
+static std::string typeName(const ValueType *valType)
+{
+  return valType ? valType->str() : "unknown";
+}
+
 //---------------------------------------------------------------------------
 const ValueType* CheckY2038::getValType(const Token *tok)
 {
@@ -65,14 +78,14 @@ const ValueType* CheckY2038::getValType(const Token *tok)
     ValueType valType2;
     valType2.type = ValueType::typeFromString(type);
 
-    return new ValueType(valType2);
+    return mTokenizer->list.internValueType(valType2);
   }
   // explicit cast
   else if ( Token::Match(tok->previous(), "( %type% )"))
   {
     ValueType valType2;
     valType2.type = ValueType::typeFromString(tok->str());
-    return new ValueType(valType2);
+    return mTokenizer->list.internValueType(valType2);
   }
 
   return nullptr;
@@ -210,20 +223,18 @@ void CheckY2038::timeVarCastFunction(const Token *tok)
     const unsigned int fArgNr = argnr + 1;
     std::string argValueType = mSettings->library.valueTypeArg(tok, fArgNr);
 
-    Token *argVar = new Token();
     const std::string argName = mSettings->library.getArgName(tok, fArgNr);
 
     if ( argName.empty() || argName == "variadic" )
       break; // ignore variadic arguments
-    
-    argVar->str("Argument " + argName + " of function " + tok->str() + "()");
-    argVar->linenr(tok->linenr());
-   // argVar = tok;
-    ValueType *type;
-    type = new ValueType();
-    type->type = ValueType::typeFromString(argValueType);
-    argVar->setValueType(type);
-    checkConversion(argVar, arg);
+
+    Token argVar;
+    argVar.str("Argument " + argName + " of function " + tok->str() + "()");
+    argVar.linenr(tok->linenr());
+    ValueType type;
+    type.type = ValueType::typeFromString(argValueType);
+    argVar.setValueType(mTokenizer->list.internValueType(type));
+    checkConversion(&argVar, arg);
   }
 }
 
@@ -274,6 +285,8 @@ void CheckY2038::checkConversion(const Token *left, const Token *right)
 
      if ( !valTypeLeft || !valTypeRight )
        return; // defensive, no body know, but somehow it happens
+     if ( valTypeLeft == valTypeRight )
+       return; // the same interned value type, nothing is converted
  // Do not warn about assignment with NULL
     if (FwdAnalysis::isNullOperand(right))
       return;
@@ -443,7 +456,7 @@ void CheckY2038::y2038canNotCastError(const Token *left, const Token *right, Sev
   if ( left && (!mSettings->isEnabled(prio) || (inconclusive && !mSettings->inconclusive) ) )
     return;
   reportError(left, prio, "y2038canNotCastError",
-              "$symbol:" + right->str() + "\n" + "$symbol:" + left->str() + "\n" +
+              "$symbol:" + symbolName(right, "value") + "\n" + "$symbol:" + symbolName(left, "timeVar") + "\n" +
               "The value of " + getVarName(right) + " can not be safely casted to " + getVarName(left) + ".",
               CWE758, inconclusive);
 }
@@ -454,8 +467,8 @@ void CheckY2038::y2038overflow(const Token *left, const Token *right, Severity::
   if ( left && (!mSettings->isEnabled(prio) || (inconclusive && !mSettings->inconclusive) ) )
     return;
   reportError(left, prio, "y2038overflow",
-              "$symbol:" + right->str() + "\n" + "$symbol:" + left->str() + "\n" +
-              "Possible value over-flow from " + getValType(right)->str() + " to " + getValType(left)->str() + "\n" +
+              "$symbol:" + symbolName(right, "value") + "\n" + "$symbol:" + symbolName(left, "timeVar") + "\n" +
+              "Possible value over-flow from " + typeName(getValType(right)) + " to " + typeName(getValType(left)) + "\n" +
               "Possible value over-flow when January 19th, 2038 at 03:14:07 GMT reached. The value of " + getVarName(right) + " is not safely casted to " + getVarName(left) + ".",
               CWE758, inconclusive);
 }
@@ -464,11 +477,11 @@ void CheckY2038::y2038overflow(const Token *left, const Token *right, Severity::
 //---------------------------------------------------------------------------
 void CheckY2038::y2038valueLost(const Token *left, const Token *right, Severity::SeverityType prio, bool inconclusive)
 {
-  if ( !left || !right || (!mSettings->isEnabled(prio) || (inconclusive && !mSettings->inconclusive) ) )
+  if ( left && (!right || !mSettings->isEnabled(prio) || (inconclusive && !mSettings->inconclusive) ) )
     return;
   reportError(right, prio, "y2038valueLost",
-              "$symbol:" + right->str() + "\n" + "$symbol:" + left->str() + "\n" +
-              "Possible value lost from " + getValType(right)->str() + " to " + getValType(left)->str() + "\n" +
+              "$symbol:" + symbolName(right, "value") + "\n" + "$symbol:" + symbolName(left, "timeVar") + "\n" +
+              "Possible value lost from " + typeName(getValType(right)) + " to " + typeName(getValType(left)) + "\n" +
               "Possible value lost when January 19th, 2038 at 03:14:07 GMT reached. The value of " + getVarName(right) + " is not safely casted to " + getVarName(left) + ".",
               CWE758, inconclusive);
 }
\ No newline at end of file
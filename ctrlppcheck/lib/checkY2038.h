@@ -47,6 +47,11 @@ public:
         (void)errorLogger;
     }
 
+    unsigned int neededResults(const Settings * /*settings*/) const OVERRIDE {
+        // only the value types are used
+        return 0;
+    }
+
     /** @brief %Check if a function return values mathces with declaration */
     void timeVarCast();
 
@@ -436,7 +436,7 @@ void CheckBool::checkComparisonOfBoolExpressionWithInt()
                 continue;
 
             if (numTok->isNumber()) {
-                const MathLib::bigint num = MathLib::toLongNumber(numTok->str());
+                const MathLib::bigint num = numTok->getIntNumber();
                 if (num==0 &&
                     (numInRhs ? Token::Match(tok, ">|==|!=")
                      : Token::Match(tok, "<|==|!=")))
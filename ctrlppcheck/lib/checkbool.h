@@ -69,6 +69,13 @@ public:
         (void)errorLogger;
     }
 
+    unsigned int neededResults(const Settings *settings) const OVERRIDE {
+        // all bool checks are warnings
+        if (settings->isEnabled(Settings::WARNING))
+            return NEEDS_VALUEFLOW;
+        return 0;
+    }
+
     /** @brief %Check for comparison of variable of type bool*/
     void checkComparisonOfBoolWithRelationOperator();
 
@@ -73,6 +73,11 @@ public:
         (void)errorLogger;
     }
 
+    unsigned int neededResults(const Settings * /*settings*/) const OVERRIDE {
+        // arrayIndex() and bufferOverflow() report errors, always enabled
+        return NEEDS_VALUEFLOW;
+    }
+
     void getErrorMessages(ErrorLogger *errorLogger, const Settings *settings) const OVERRIDE {
         CheckBufferOverrun c(nullptr, settings, errorLogger);
         c.arrayIndexError(nullptr, nullptr, nullptr);
@@ -77,6 +77,10 @@ public:
         (void)errorLogger;
     }
 
+    unsigned int neededResults(const Settings * /*settings*/) const OVERRIDE {
+        return 0;
+    }
+
 
     /** @brief %Check that all class constructors are ok */
     void constructors();
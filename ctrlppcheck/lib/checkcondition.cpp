@@ -34,10 +34,13 @@
 #include <cstddef>
 #include <limits>
 #include <list>
+#include <memory>
 #include <ostream>
 #include <set>
 #include <stack>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 // CWE ids used
 static const struct CWE CWE398(398U);   // Indicator of Poor Code Quality
@@ -91,7 +94,7 @@ void CheckCondition::assignIf()
 
             if (Token::Match(tok->next(), "%num% [&|]")) {
                 bitop = tok->strAt(2).at(0);
-                num = MathLib::toLongNumber(tok->next()->str());
+                num = tok->next()->getIntNumber();
             } else {
                 const Token *endToken = Token::findsimplematch(tok, ";");
 
@@ -177,7 +180,7 @@ bool CheckCondition::assignIfParseScope(const Token * const assignTok,
 
     for (const Token *tok2 = startTok; tok2; tok2 = tok2->next()) {
         if ((bitop == '&') && Token::Match(tok2->tokAt(2), "%varid% %cop% %num% ;", varid) && tok2->strAt(3) == std::string(1U, bitop)) {
-            const MathLib::bigint num2 = MathLib::toLongNumber(tok2->strAt(4));
+            const MathLib::bigint num2 = tok2->tokAt(4)->getIntNumber();
             if (0 == (num & num2))
                 mismatchingBitAndError(assignTok, num, tok2, num2);
         }
@@ -185,7 +188,7 @@ bool CheckCondition::assignIfParseScope(const Token * const assignTok,
             return true;
         }
         if (bitop == '&' && Token::Match(tok2, "%varid% &= %num% ;", varid)) {
-            const MathLib::bigint num2 = MathLib::toLongNumber(tok2->strAt(2));
+            const MathLib::bigint num2 = tok2->tokAt(2)->getIntNumber();
             if (0 == (num & num2))
                 mismatchingBitAndError(assignTok, num, tok2, num2);
         }
@@ -220,7 +223,7 @@ bool CheckCondition::assignIfParseScope(const Token * const assignTok,
                 }
                 if (Token::Match(tok2,"&&|%oror%|( %varid% ==|!= %num% &&|%oror%|)", varid)) {
                     const Token *vartok = tok2->next();
-                    const MathLib::bigint num2 = MathLib::toLongNumber(vartok->strAt(2));
+                    const MathLib::bigint num2 = vartok->tokAt(2)->getIntNumber();
                     if ((num & num2) != ((bitop=='&') ? num2 : num)) {
                         const std::string& op(vartok->strAt(1));
                         const bool alwaysTrue = op == "!=";
@@ -344,7 +347,7 @@ void CheckCondition::comparison()
             std::swap(expr1,expr2);
         if (!expr2->isNumber())
             continue;
-        const MathLib::bigint num2 = MathLib::toLongNumber(expr2->str());
+        const MathLib::bigint num2 = expr2->getIntNumber();
         if (num2 < 0)
             continue;
         if (!Token::Match(expr1,"[&|]"))
@@ -435,8 +438,8 @@ bool CheckCondition::isOverlappingCond(const Token * const cond1, const Token *
         if (!isSameExpression(expr1, expr2, mSettings->library, pure, false))
             return false;
 
-        const MathLib::bigint value1 = MathLib::toLongNumber(num1->str());
-        const MathLib::bigint value2 = MathLib::toLongNumber(num2->str());
+        const MathLib::bigint value1 = num1->getIntNumber();
+        const MathLib::bigint value2 = num2->getIntNumber();
         if (cond2->str() == "&")
             return ((value1 & value2) == value2);
         return ((value1 & value2) > 0);
@@ -451,6 +454,8 @@ void CheckCondition::duplicateCondition()
 
     const SymbolDatabase *const symbolDatabase = mTokenizer->getSymbolDatabase();
 
+    ExpressionHasher hasher(true);
+
     for (const Scope &scope : symbolDatabase->scopeList) {
         if (scope.type != Scope::eIf)
             continue;
@@ -473,6 +478,8 @@ void CheckCondition::duplicateCondition()
         const Token *cond2 = tok2->tokAt(2)->astOperand2();
         if (!cond2)
             continue;
+        if (!hasher.mayBeSame(cond1, cond2))
+            continue;
 
         bool modified = false;
         visitAstNodes(cond1, [&](const Token *tok3) {
@@ -509,34 +516,67 @@ void CheckCondition::multiCondition()
 
     const SymbolDatabase* const symbolDatabase = mTokenizer->getSymbolDatabase();
 
+    ExpressionHasher hasher(false);
+
+    // The conditions of an 'else if' chain. Every condition is compared with
+    // the following ones that may be the same, they are found by their hash.
+    struct ElseIfChain {
+        std::vector<const Token *> parens;  ///< '(' of the conditions
+        std::vector<const Token *> conditions;
+        std::unique_ptr<ExpressionBuckets> buckets;
+    };
+    std::list<ElseIfChain> chains;
+    std::unordered_map<const Token *, std::pair<const ElseIfChain *, std::size_t>> chainOfParen;
+
     for (const Scope &scope : symbolDatabase->scopeList) {
         if (scope.type != Scope::eIf)
             continue;
 
-        const Token * const cond1 = scope.classDef->next()->astOperand2();
+        // the scopes are in the order of the code, the first 'if' of a chain is seen first
+        const Token * const paren = scope.classDef->next();
+        if (chainOfParen.find(paren) == chainOfParen.end()) {
+            chains.emplace_back();
+            ElseIfChain &chain = chains.back();
+            const Token *tok2 = paren;
+            for (;;) {
+                chainOfParen[tok2] = std::make_pair(&chain, chain.parens.size());
+                chain.parens.push_back(tok2);
+                chain.conditions.push_back(tok2->astOperand2());
+                tok2 = tok2->link();
+                if (!Token::simpleMatch(tok2, ") {"))
+                    break;
+                tok2 = tok2->linkAt(1);
+                if (!Token::simpleMatch(tok2, "} else { if ("))
+                    break;
+                tok2 = tok2->tokAt(4);
+            }
+            chain.buckets.reset(new ExpressionBuckets(hasher, chain.conditions));
+        }
+
+        const ElseIfChain &chain = *chainOfParen[paren].first;
+        const std::size_t index = chainOfParen[paren].second;
+        const Token * const cond1 = chain.conditions[index];
 
         if (!cond1)
         {  // defensive
             continue;
         }
 
-        const Token *tok2 = scope.classDef->next();
+        std::vector<std::size_t> candidates;
+        if (cond1->str() == "&") {
+            // bitwise overlap 'x&7' is not a same expression
+            for (std::size_t i = index + 1; i < chain.conditions.size(); ++i)
+                candidates.push_back(i);
+        } else {
+            candidates = chain.buckets->candidates(cond1, index + 1);
+        }
 
-        for (;;) {
-            tok2 = tok2->link();
-            if (!Token::simpleMatch(tok2, ") {"))
-                break;
-            tok2 = tok2->linkAt(1);
-            if (!Token::simpleMatch(tok2, "} else { if ("))
-                break;
-            tok2 = tok2->tokAt(4);
-
-            if (/*cond1 &&*/
-                tok2->astOperand2() &&
+        for (const std::size_t i : candidates) {
+            if (chain.conditions[i] &&
                 // !cond1->hasKnownIntValue() &&
-                // !tok2->astOperand2()->hasKnownIntValue() &&
-                isOverlappingCond(cond1, tok2->astOperand2()))
-                multiConditionError(tok2, cond1->linenr());
+                // !chain.conditions[i]->hasKnownIntValue() &&
+                isOverlappingCond(cond1, chain.conditions[i]))
+                multiConditionError(chain.parens[i], cond1->linenr());
         }
     }
 }
@@ -579,6 +619,8 @@ void CheckCondition::multiCondition2()
 
     const SymbolDatabase *symbolDatabase = mTokenizer->getSymbolDatabase();
 
+    ExpressionHasher hasher(true);
+
     for (const Scope &scope : symbolDatabase->scopeList) {
         const Token *condTok = nullptr;
         if (scope.type == Scope::eIf || scope.type == Scope::eWhile)
@@ -691,7 +733,8 @@ void CheckCondition::multiCondition2()
                                 if (!isReturnVar && isOppositeCond(false, firstCondition, cond2, mSettings->library, true, true, &errorPath)) {
                                     if (!isAliased(vars))
                                         oppositeInnerConditionError(firstCondition, cond2, errorPath);
-                                } else if (!isReturnVar && isSameExpression(firstCondition, cond2, mSettings->library, true, true, &errorPath)) {
+                                } else if (!isReturnVar && hasher.mayBeSame(firstCondition, cond2) &&
+                                           isSameExpression(firstCondition, cond2, mSettings->library, true, true, &errorPath)) {
                                     identicalInnerConditionError(firstCondition, cond2, errorPath);
                                 }
                             }
@@ -708,6 +751,7 @@ void CheckCondition::multiCondition2()
                                 tokens2.push(secondCondition->astOperand1());
                                 tokens2.push(secondCondition->astOperand2());
                             } else if ((!cond1->hasKnownIntValue() || !secondCondition->hasKnownIntValue()) &&
+                                       hasher.mayBeSame(cond1, secondCondition) &&
                                        isSameExpression(cond1, secondCondition, mSettings->library, true, true, &errorPath)) {
                                 if (!isAliased(vars))
                                     identicalConditionAfterEarlyExitError(cond1, secondCondition, errorPath);
@@ -73,6 +73,13 @@ public:
         (void)errorLogger;
     }
 
+    unsigned int neededResults(const Settings *settings) const OVERRIDE {
+        // all condition checks are warnings or style
+        if (settings->isEnabled(Settings::WARNING) || settings->isEnabled(Settings::STYLE))
+            return NEEDS_VALUEFLOW;
+        return 0;
+    }
+
     /** mismatching assignment / comparison */
     void assignIf();
 
@@ -79,6 +79,11 @@ public:
         checkFunctions.checkMathFunctions();
     }
 
+    unsigned int neededResults(const Settings * /*settings*/) const OVERRIDE {
+        // invalidFunctionUsage() reports errors on the simplified token list
+        return NEEDS_VALUEFLOW | NEEDS_SIMPLIFIED;
+    }
+
     /** Check for functions that should not be used */
     void checkProhibitedFunctions();
 
@@ -60,6 +60,10 @@ public:
         checkInternal.checkStlUsage();
     }
 
+    unsigned int neededResults(const Settings *settings) const OVERRIDE {
+        return settings->isEnabled(Settings::INTERNAL) ? NEEDS_SIMPLIFIED : 0;
+    }
+
     /** @brief %Check if a simple pattern is used inside Token::Match or Token::findmatch */
     void checkTokenMatchPatterns();
 
@@ -63,6 +63,11 @@ public:
         checkIO.checkFileUsage();
     }
 
+    unsigned int neededResults(const Settings * /*settings*/) const OVERRIDE {
+        // printf/scanf arguments use values, checkFileUsage() reports errors on the simplified token list
+        return NEEDS_VALUEFLOW | NEEDS_SIMPLIFIED;
+    }
+
     /** @brief %Check usage of files*/
     void checkFileUsage();
 
@@ -18,6 +18,7 @@
 #include <cstddef>
 #include <list>
 #include <ostream>
+#include <regex>
 #include <stack>
 //-----------------------------------------------------------------------------
 
@@ -79,7 +80,7 @@ std::string getExePath()
 //-----------------------------------------------------------------------------
 void CheckNaming::checkVariableNaming()
 {
-    if (!mSettings->isEnabled(Settings::STYLE))
+    if (!mSettings->isEnabled(Settings::STYLE) || !mRules)
         return;
 
     const SymbolDatabase *symbolDatabase = mTokenizer->getSymbolDatabase();
@@ -92,40 +93,28 @@ void CheckNaming::checkVariableNaming()
 
         mFileName = mTokenizer->list.file(var->nameToken());
 
-        //get complete rule id
-        std::list<std::string> variableFlags = getVariableFlags(var);
-        std::string ruleId = getRuleId(variableFlags);
+        //search the rules for the complete rule id (cached)
+        const RuleMatch &match = getRuleMatch(getVariableRuleId(var));
 
-        //search if there is an rule for it (cached)
-        const Settings::Rule *rule = getRule(ruleId);
-
-        if (rule && !rule->pattern.empty())
+        if (match.rule)
         {
-            //if yes: than check name with preprocessed regex
-            if (!std::regex_match(var->name(), preProcessRegex(rule->pattern.c_str())))
+            //if there is a rule: check name with the compiled regex
+            if (!matchesRule(var->name(), match.rule))
             {
-                namingError(var->nameToken(), rule);
+                namingError(var->nameToken(), &match.rule->rule);
             }
         }
         else
         {
-            //if no:
-            //get Rule for each single rule id (cached)
+            //if not: check the rule of each single flag
             std::list<const Settings::Rule *> rules;
 
-            for (std::string id : variableFlags)
+            for (const NamingRule *rule : match.flagRules)
             {
-                const Settings::Rule *rule = getRule(id);
-
-                if (rule && !rule->pattern.empty())
+                if (!matchesRule(var->name(), rule))
                 {
-                    //check each rule with the name
-                    if (!std::regex_match(var->name(), preProcessRegex(rule->pattern.c_str())))
-                    {
-                        //report each error
-                        rules.push_back(rule);
-                        //namingError(var->nameToken(), rule);
-                    }
+                    //report each error
+                    rules.push_back(&rule->rule);
                 }
             }
 
@@ -139,7 +128,7 @@ void CheckNaming::checkVariableNaming()
 
 void CheckNaming::checkFunctionNaming()
 {
-    /*if (!mSettings->isEnabled(Settings::STYLE))
+    /*if (!mSettings->isEnabled(Settings::STYLE) || !mRules)
         return;
 
     const SymbolDatabase *symbolDatabase = mTokenizer->getSymbolDatabase();
@@ -159,40 +148,28 @@ void CheckNaming::checkFunctionNaming()
 
         mFileName = mTokenizer->list.file(function->token);
 
-        //get complete rule id
-        std::list<std::string> functionFlags = getFunctionFlags(function);
-        std::string ruleId = getRuleId(functionFlags);
-
-        //search if there is an rule for it (cached)
-        const Settings::Rule *rule = getRule(ruleId);
+        //search the rules for the complete rule id (cached)
+        const RuleMatch &match = getRuleMatch(getFunctionRuleId(function));
 
-        if (rule && !rule->pattern.empty())
+        if (match.rule)
         {
-            //if yes: than check name with preprocessed regex
-            if (!std::regex_match(function->name(), preProcessRegex(rule->pattern.c_str())))
+            //if there is a rule: check name with the compiled regex
+            if (!matchesRule(function->name(), match.rule))
             {
-                namingError(function->token, rule);
+                namingError(function->token, &match.rule->rule);
             }
         }
         else
         {
-            //if no:
-            //get Rule for each single rule id (cached)
+            //if not: check the rule of each single flag
             std::list<const Settings::Rule *> rules;
 
-            for (std::string id : functionFlags)
+            for (const NamingRule *rule : match.flagRules)
             {
-                const Settings::Rule *rule = getRule(id);
-
-                if (rule && !rule->pattern.empty())
+                if (!matchesRule(function->name(), rule))
                 {
-                    //check each rule with the name
-                    if (!std::regex_match(function->name(), preProcessRegex(rule->pattern.c_str())))
-                    {
-                        //report each error
-                        rules.push_back(rule);
-                        //namingError(var->nameToken(), rule);
-                    }
+                    //report each error
+                    rules.push_back(&rule->rule);
                 }
             }
 
@@ -206,7 +183,7 @@ void CheckNaming::checkFunctionNaming()
 
 void CheckNaming::checkClassNaming()
 {
-    /*if (!mSettings->isEnabled(Settings::STYLE))
+    /*if (!mSettings->isEnabled(Settings::STYLE) || !mRules)
         return;
 
     const SymbolDatabase *symbolDatabase = mTokenizer->getSymbolDatabase();
@@ -219,13 +196,13 @@ void CheckNaming::checkClassNaming()
 
         mFileName = mTokenizer->list.getOrigFile(scope->classDef);
 
-        const Settings::Rule *rule = getRule("class");
+        const NamingRule *rule = getRuleMatch("class").rule;
 
-        if (rule && !rule->pattern.empty())
+        if (rule)
         {
-            if (!std::regex_match(scope->className, preProcessRegex(rule->pattern.c_str())))
+            if (!matchesRule(scope->className, rule))
             {
-                namingError(scope->classDef, rule);
+                namingError(scope->classDef, &rule->rule);
             }
         }
     }*/
@@ -242,28 +219,33 @@ const std::vector<std::string> splitString(const std::string &s) {
     return words;
 }
 
-const Settings::Rule *CheckNaming::getRule(const std::string &ruleId)
+const CheckNaming::NamingRule *CheckNaming::getRule(const std::string &ruleId) const
 {
-    std::list<Settings::Rule>::const_iterator it = std::find_if(mRules.begin(), mRules.end(),
-                                                                [ruleId](const Settings::Rule &rule) {
-                                                                        std::vector<std::string> ruleParts = splitString(rule.id);
-                                                                        std::vector<std::string> ruleIdParts = splitString(ruleId);
-
-                                                                        if ( ruleParts.size() != ruleIdParts.size() ) {
-                                                                            return false;
-                                                                        }
-
-                                                                        for (int i = 0; i < ruleIdParts.size(); i++) // access by reference to avoid copying
-                                                                        {
-                                                                            if ( ruleIdParts[i] != ruleParts[i] && ruleParts[i] != "*" )
-                                                                            {
-                                                                                return false;
-                                                                            }
-                                                                        }
-
-                                                                        return true;
-                                                                    });
-    if (it == mRules.end())
+    if (!mRules)
+    {
+        return nullptr;
+    }
+
+    const std::vector<std::string> ruleIdParts = splitString(ruleId);
+    std::vector<NamingRule>::const_iterator it = std::find_if(mRules->rules.begin(), mRules->rules.end(),
+                                                              [&ruleIdParts](const NamingRule &rule) {
+                                                                      const std::vector<std::string> &ruleParts = rule.idParts;
+
+                                                                      if ( ruleParts.size() != ruleIdParts.size() ) {
+                                                                          return false;
+                                                                      }
+
+                                                                      for (std::size_t i = 0; i < ruleIdParts.size(); i++)
+                                                                      {
+                                                                          if ( ruleIdParts[i] != ruleParts[i] && ruleParts[i] != "*" )
+                                                                          {
+                                                                              return false;
+                                                                          }
+                                                                      }
+
+                                                                      return true;
+                                                                  });
+    if (it == mRules->rules.end())
     {
         return nullptr;
     }
@@ -271,7 +253,67 @@ const Settings::Rule *CheckNaming::getRule(const std::string &ruleId)
     return &*it;
 }
 
-std::regex CheckNaming::preProcessRegex(const std::string &origRegexString)
+const CheckNaming::RuleMatch &CheckNaming::getRuleMatch(const std::string &ruleId)
+{
+    std::unordered_map<std::string, RuleMatch>::const_iterator it = mRuleMatches.find(ruleId);
+    if (it != mRuleMatches.end())
+    {
+        return it->second;
+    }
+
+    RuleMatch match;
+    match.rule = getRule(ruleId);
+
+    if (!match.rule)
+    {
+        //the rule id is a space separated list of flags, get the rule of each single flag
+        std::string::size_type start = 0;
+        for (;;)
+        {
+            const std::string::size_type end = ruleId.find(' ', start);
+            const NamingRule *rule = getRule(ruleId.substr(start, end == std::string::npos ? end : end - start));
+
+            if (rule)
+            {
+                match.flagRules.push_back(rule);
+            }
+
+            if (end == std::string::npos)
+            {
+                break;
+            }
+            start = end + 1;
+        }
+    }
+
+    return mRuleMatches[ruleId] = match;
+}
+
+bool CheckNaming::matchesRule(const std::string &name, const NamingRule *rule)
+{
+    if (!rule->usesFileName)
+    {
+        //the pattern is compiled when the rule file is loaded
+        return rule->regex->match(name, nullptr) == Regex::MATCH;
+    }
+
+    //the pattern is bound to the file name and compiled once per file
+    std::vector<std::shared_ptr<const Regex>> &fileRegex = mFileRegex[mFileName];
+    if (fileRegex.empty())
+    {
+        fileRegex.resize(mRules->rules.size());
+    }
+
+    std::shared_ptr<const Regex> &regex = fileRegex[rule - mRules->rules.data()];
+    if (!regex)
+    {
+        regex = Regex::create(preProcessRegex(rule->rule.pattern), mSettings->regexEngine);
+    }
+
+    return regex->match(name, nullptr) == Regex::MATCH;
+}
+
+std::string CheckNaming::preProcessRegex(const std::string &origRegexString) const
 {
     std::string newRegexString = origRegexString;
     std::string fileName = mFileName.substr(0, mFileName.find_last_of("."));
@@ -285,10 +327,10 @@ std::regex CheckNaming::preProcessRegex(const std::string &origRegexString)
     std::transform(fileName.begin(), fileName.end(), fileName.begin(), ::tolower);
     replaceAll(newRegexString, "%fileName_allLower%", fileName);
 
-    return std::regex(newRegexString);
+    return newRegexString;
 }
 
-void CheckNaming::replaceAll(std::string &str, const std::string &from, const std::string &to)
+void CheckNaming::replaceAll(std::string &str, const std::string &from, const std::string &to) const
 {
     if (from.empty())
         return;
@@ -300,110 +342,81 @@ void CheckNaming::replaceAll(std::string &str, const std::string &from, const st
     }
 }
 
-std::list<std::string> CheckNaming::getVariableFlags(const Variable *var)
+std::string CheckNaming::getVariableRuleId(const Variable *var) const
 {
-
-    std::list<std::string> variableFlags;
+    //the rule id is the space separated list of the variable flags
 
     //const
-    if (var->isConst())
-    {
-        variableFlags.push_back("const");
-    }
-    else
-    {
-        variableFlags.push_back("nonconst");
-    }
+    std::string ruleId = var->isConst() ? "const" : "nonconst";
 
     //int | float | long | bool | char
     if (var->valueType())
     {
-        variableFlags.push_back(var->valueType()->typeToString());
+        ruleId += ' ';
+        ruleId += var->valueType()->typeToString();
     }
 
     //local | argument | global
     if (var->isLocal())
     {
-        variableFlags.push_back("local");
+        ruleId += " local";
     }
     else if (var->isArgument())
     {
-        variableFlags.push_back("argument");
+        ruleId += " argument";
     }
     else if (var->isGlobal()) //isGlobal does not differ between manager global and script global
     {
-        variableFlags.push_back("global");
+        ruleId += " global";
     }
 
-    return variableFlags;
+    return ruleId;
 }
 
-std::list<std::string> CheckNaming::getFunctionFlags(const Function *function)
+std::string CheckNaming::getFunctionRuleId(const Function *function) const
 {
-
-    std::list<std::string> functionFlags;
+    //the rule id is the space separated list of the function flags
 
     if (function->isConstructor())
     {
-        functionFlags.push_back("ctor");
+        return "ctor";
     }
     else if (function->isDestructor())
     {
-        functionFlags.push_back("dtor");
+        return "dtor";
     }
-    else
-    {
-        //const
-        if (function->isConst())
-        {
-            functionFlags.push_back("const");
-        }
-        else
-        {
-            functionFlags.push_back("nonconst");
-        }
 
-        if (function->isStatic())
-        {
-            functionFlags.push_back("static");
-        }
-        else if (function->isStaticLocal())
-        {
-            functionFlags.push_back("static_local");
-        }
+    //const
+    std::string ruleId = function->isConst() ? "const" : "nonconst";
 
-        if (function->hasBody())
-        {
-            functionFlags.push_back("function");
-        }
-        //class method | normal
+    if (function->isStatic())
+    {
+        ruleId += " static";
+    }
+    else if (function->isStaticLocal())
+    {
+        ruleId += " static_local";
     }
 
-    return functionFlags;
-}
-
-std::string CheckNaming::getRuleId(const std::list<std::string> &variableFlags)
-{
-    std::string path;
-
-    for (std::string s : variableFlags)
+    if (function->hasBody())
     {
-        path += (path.empty() ? "" : " ") + s;
+        ruleId += " function";
     }
+    //class method | normal
 
-    return path;
+    return ruleId;
 }
 
-void CheckNaming::loadNamingRules()
+std::shared_ptr<const NamingRuleFile> CheckNaming::loadNamingRules(const Settings &settings)
 {
     const std::string rulesPath_dev = getExePath() + "../../../WinCCOA_QualityChecks/data/ctrlPpCheck/rule/variableNaming.xml";
     const std::string rulesPath_live = getExePath() + "../../data/ctrlPpCheck/rule/variableNaming.xml";
     std::string rulesPath = doesFileExist(rulesPath_live) ? rulesPath_live : rulesPath_dev;
 
-    if (!mSettings->namingRuleFile.empty() && doesFileExist(mSettings->namingRuleFile))
+    if (!settings.namingRuleFile.empty() && doesFileExist(settings.namingRuleFile))
     {
-        std::cout << "cppcheck: naming check: custom rule file path =  " + mSettings->namingRuleFile << std::endl;
-        rulesPath = mSettings->namingRuleFile;
+        std::cout << "cppcheck: naming check: custom rule file path =  " + settings.namingRuleFile << std::endl;
+        rulesPath = settings.namingRuleFile;
     }
     else
     {
@@ -422,12 +435,13 @@ void CheckNaming::loadNamingRules()
         else
         {
             std::cout << "cppcheck: warning: standard naming rule file does not exist" << std::endl;
-            return;
+            return nullptr;
         }
     }
 
     tinyxml2::XMLDocument doc;
     std::list<std::string> ids;
+    std::shared_ptr<NamingRuleFile> rules = std::make_shared<NamingRuleFile>();
     if (doc.LoadFile(rulesPath.c_str()) == tinyxml2::XML_SUCCESS)
     {
         tinyxml2::XMLElement *node = doc.FirstChildElement();
@@ -457,8 +471,25 @@ void CheckNaming::loadNamingRules()
             {
                 if (std::find(ids.begin(), ids.end(), rule.id) == ids.end())
                 {
+                    NamingRule namingRule;
+                    namingRule.rule = rule;
+                    namingRule.idParts = splitString(rule.id);
+                    namingRule.usesFileName = rule.pattern.find("%fileName") != std::string::npos;
+                    if (!namingRule.usesFileName)
+                    {
+                        try
+                        {
+                            namingRule.regex = Regex::create(rule.pattern, settings.regexEngine);
+                        }
+                        catch (const std::regex_error &e)
+                        {
+                            std::cout << "cppcheck: error: invalid naming rule pattern: " + rule.pattern + " (" + e.what() + "). The rule " + rule.id + " is not used" << std::endl;
+                            continue;
+                        }
+                    }
+
                     ids.push_back(rule.id);
-                    mRules.push_back(rule);
+                    rules->rules.push_back(namingRule);
                 }
                 else
                 {
@@ -469,12 +500,12 @@ void CheckNaming::loadNamingRules()
                 }
             }
         }
+
+        return rules;
     }
-    else
-    {
-        std::cout << "cppcheck: error: unable to load rule-file: " + rulesPath << std::endl;
-        return;
-    }
+
+    std::cout << "cppcheck: error: unable to load rule-file: " + rulesPath << std::endl;
+    return nullptr;
 }
 
 bool CheckNaming::doesFileExist(const std::string &filePath)
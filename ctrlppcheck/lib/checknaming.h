@@ -5,14 +5,38 @@
 //-----------------------------------------------------------------------------
 
 #include "check.h"
+#include "regex.h"
 #include "settings.h"
-#include <regex>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 class ErrorLogger;
 class Settings;
 class Token;
 class Tokenizer;
 
+/** @brief Parsed naming rule file, loaded once and shared by all checked files */
+struct CPPCHECKLIB NamingRuleFile
+{
+    /** @brief Naming rule, prepared when the rule file is loaded */
+    struct Rule
+    {
+        Settings::Rule rule;
+        /** rule id split into its flags, "*" matches every flag */
+        std::vector<std::string> idParts;
+        /** the pattern contains a %fileName..% placeholder and is compiled per file */
+        bool usesFileName;
+        /** compiled pattern if it does not depend on the file name */
+        std::shared_ptr<const Regex> regex;
+    };
+
+    std::vector<Rule> rules;
+};
+
 /// @addtogroup Checks
 /// @{
 
@@ -28,7 +52,7 @@ public:
 
     /** @brief This constructor is used when running checks. */
     CheckNaming(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger)
-        : Check(myName(), tokenizer, settings, errorLogger)
+        : Check(myName(), tokenizer, settings, errorLogger), mRules(settings ? settings->namingRules : nullptr)
     {
     }
 
@@ -43,7 +67,6 @@ public:
         CheckNaming checkNaming(tokenizer, settings, errorLogger);
 
         // Checks
-        checkNaming.loadNamingRules();
         checkNaming.checkVariableNaming();
         //checkNaming.checkFunctionNaming();
         //checkNaming.checkClassNaming();
@@ -57,6 +80,10 @@ public:
         (void)errorLogger;
     }
 
+    unsigned int neededResults(const Settings * /*settings*/) const OVERRIDE {
+        return 0;
+    }
+
     /** @brief %Check for variable naming */
     void checkVariableNaming();
     /** @brief %Check for function naming */
@@ -64,19 +91,40 @@ public:
     /** @brief %Check for class naming */
     void checkClassNaming();
 
+    /**
+     * @brief Load the naming rule file (--naming-rule-file or the standard file) and compile its patterns
+     * @return the rules, nullptr if there is no rule file
+     */
+    static std::shared_ptr<const NamingRuleFile> loadNamingRules(const Settings &settings);
+
 private:
-    std::list<Settings::Rule> mRules;
-    std::string mFileName;
+    typedef NamingRuleFile::Rule NamingRule;
 
-    void loadNamingRules();
-    bool doesFileExist(const std::string &filePath);
-    void xmlGetText(tinyxml2::XMLElement *element, std::string &value);
-    const Settings::Rule *getRule(const std::string &ruleId);
-    std::regex preProcessRegex(const std::string &origRegexString);
-    void replaceAll(std::string &str, const std::string &from, const std::string &to);
-    std::list<std::string> getVariableFlags(const Variable *var);
-    std::list<std::string> getFunctionFlags(const Function *var);
-    std::string getRuleId(const std::list<std::string> &variableFlags);
+    /** @brief Rules for a rule id (a combination of flags) */
+    struct RuleMatch
+    {
+        /** rule for the complete rule id */
+        const NamingRule *rule;
+        /** rules for the single flags, used if there is no rule for the complete rule id */
+        std::vector<const NamingRule *> flagRules;
+    };
+
+    std::shared_ptr<const NamingRuleFile> mRules;
+    std::string mFileName;
+    /** rules by rule id (cached) */
+    std::unordered_map<std::string, RuleMatch> mRuleMatches;
+    /** compiled patterns of the rules using the file name, by file and rule index (cached) */
+    std::map<std::string, std::vector<std::shared_ptr<const Regex>>> mFileRegex;
+
+    static bool doesFileExist(const std::string &filePath);
+    static void xmlGetText(tinyxml2::XMLElement *element, std::string &value);
+    const NamingRule *getRule(const std::string &ruleId) const;
+    const RuleMatch &getRuleMatch(const std::string &ruleId);
+    bool matchesRule(const std::string &name, const NamingRule *rule);
+    std::string preProcessRegex(const std::string &origRegexString) const;
+    void replaceAll(std::string &str, const std::string &from, const std::string &to) const;
+    std::string getVariableRuleId(const Variable *var) const;
+    std::string getFunctionRuleId(const Function *function) const;
 
     // Error messages..
     void namingError(const Token *tok, const Settings::Rule *rule);
@@ -1353,6 +1353,8 @@ void CheckOther::checkDuplicateBranch()
 
     const SymbolDatabase *symbolDatabase = mTokenizer->getSymbolDatabase();
 
+    ExpressionHasher hasher(true);
+
     for (const Scope & scope : symbolDatabase->scopeList) {
         if (scope.type != Scope::eIf)
             continue;
@@ -1383,6 +1385,9 @@ void CheckOther::checkDuplicateBranch()
                 continue;
             if (branchTop1->str() != branchTop2->str())
                 continue;
+            if (!hasher.mayBeSame(branchTop1->astOperand1(), branchTop2->astOperand1()) ||
+                !hasher.mayBeSame(branchTop1->astOperand2(), branchTop2->astOperand2()))
+                continue;
             if (isSameExpression(branchTop1->astOperand1(), branchTop2->astOperand1(), mSettings->library, true, true, &errorPath) &&
                 isSameExpression(branchTop1->astOperand2(), branchTop2->astOperand2(), mSettings->library, true, true, &errorPath))
                 duplicateBranchError(scope.classDef, scope.bodyEnd->next(), errorPath);
@@ -1453,6 +1458,9 @@ void CheckOther::checkDuplicateExpression()
         if (scope.type != Scope::eFunction)
             continue;
 
+        // cheap pre-check before isSameExpression(.., followVar=true)
+        ExpressionHasher hasher(true);
+
         for (const Token *tok = scope.bodyStart; tok && tok != scope.bodyEnd; tok = tok->next()) {
             if (tok->str() == "=" && Token::Match(tok->astOperand1(), "%var%")) {
                 const Token * endStatement = Token::findsimplematch(tok, ";");
@@ -1500,7 +1508,8 @@ void CheckOther::checkDuplicateExpression()
             if (tok->isOp() && tok->astOperand1() && !Token::Match(tok, "+|*|<<|>>|+=|*=|<<=|>>=")) {
                 if (Token::Match(tok, "==|!=|-") && astIsFloat(tok->astOperand1(), true))
                     continue;
-                if (isSameExpression(tok->astOperand1(), tok->astOperand2(), mSettings->library, true, true, &errorPath))
+                if (hasher.mayBeSame(tok->astOperand1(), tok->astOperand2()) &&
+                    isSameExpression(tok->astOperand1(), tok->astOperand2(), mSettings->library, true, true, &errorPath))
                 {
                     if (isWithoutSideEffects(tok->astOperand1()))
                     {
@@ -1528,13 +1537,14 @@ void CheckOther::checkDuplicateExpression()
                 {
                     oppositeExpressionError(tok, errorPath);
                 } else if (!Token::Match(tok, "[-/%]")) { // These operators are not associative
-                    if (styleEnabled && tok->astOperand2() && tok->str() == tok->astOperand1()->str() && isSameExpression(tok->astOperand2(), tok->astOperand1()->astOperand2(), mSettings->library, true, true, &errorPath) && isWithoutSideEffects(tok->astOperand2()))
+                    if (styleEnabled && tok->astOperand2() && tok->str() == tok->astOperand1()->str() && hasher.mayBeSame(tok->astOperand2(), tok->astOperand1()->astOperand2()) && isSameExpression(tok->astOperand2(), tok->astOperand1()->astOperand2(), mSettings->library, true, true, &errorPath) && isWithoutSideEffects(tok->astOperand2()))
                         duplicateExpressionError(tok->astOperand2(), tok->astOperand1()->astOperand2(), tok, errorPath);
                     else if (tok->astOperand2() && isConstExpression(tok->astOperand1(), mSettings->library, true))
                     {
                         const Token *ast1 = tok->astOperand1();
                         while (ast1 && tok->str() == ast1->str()) {
-                            if (isSameExpression(ast1->astOperand1(), tok->astOperand2(), mSettings->library, true, true, &errorPath) &&
+                            if (hasher.mayBeSame(ast1->astOperand1(), tok->astOperand2()) &&
+                                isSameExpression(ast1->astOperand1(), tok->astOperand2(), mSettings->library, true, true, &errorPath) &&
                                 isWithoutSideEffects(ast1->astOperand1()) &&
                                 isWithoutSideEffects(ast1->astOperand2()))
                                 // Probably the message should be changed to 'duplicate expressions X in condition or something like that'.
@@ -1546,7 +1556,8 @@ void CheckOther::checkDuplicateExpression()
             } else if (styleEnabled && tok->astOperand1() && tok->astOperand2() && tok->str() == ":" && tok->astParent() && tok->astParent()->str() == "?") {
                 if (!tok->astOperand1()->values().empty() && !tok->astOperand2()->values().empty() && isEqualKnownValue(tok->astOperand1(), tok->astOperand2()))
                     duplicateValueTernaryError(tok);
-                else if (isSameExpression(tok->astOperand1(), tok->astOperand2(), mSettings->library, false, true, &errorPath))
+                else if (hasher.mayBeSame(tok->astOperand1(), tok->astOperand2()) &&
+                         isSameExpression(tok->astOperand1(), tok->astOperand2(), mSettings->library, false, true, &errorPath))
                     duplicateExpressionTernaryError(tok, errorPath);
             }
         }
@@ -93,6 +93,13 @@ public:
         checkOther.checkMisusedScopedObject();
     }
 
+    unsigned int neededResults(const Settings *settings) const OVERRIDE {
+        // clarifyStatement() and checkMisusedScopedObject() use the simplified token list
+        if (settings->isEnabled(Settings::WARNING) || settings->isEnabled(Settings::STYLE))
+            return NEEDS_VALUEFLOW | NEEDS_SIMPLIFIED;
+        return NEEDS_VALUEFLOW;
+    }
+
     /** @brief Clarify calculation for ".. a * b ? .." */
     void clarifyCalculation();
 
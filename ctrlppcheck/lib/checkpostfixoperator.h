@@ -57,6 +57,10 @@ public:
     void runSimplifiedChecks(const Tokenizer * /*tokenizer*/, const Settings * /*settings*/, ErrorLogger * /*errorLogger*/) OVERRIDE {
     }
 
+    unsigned int neededResults(const Settings * /*settings*/) const OVERRIDE {
+        return 0;
+    }
+
     /** Check postfix operators */
     void postfixOperator();
 
@@ -63,6 +63,10 @@ public:
     void runSimplifiedChecks(const Tokenizer* /*tokenizer*/, const Settings* /*settings*/, ErrorLogger* /*errorLogger*/) OVERRIDE {
     }
 
+    unsigned int neededResults(const Settings * /*settings*/) const OVERRIDE {
+        return 0;
+    }
+
 
     /** @brief %Check for suspicious calculations with sizeof results */
     void suspiciousSizeofCalculation();
@@ -65,6 +65,11 @@ public:
         checkStl.negativeIndex();
     }
 
+    unsigned int neededResults(const Settings * /*settings*/) const OVERRIDE {
+        // negativeIndex() reports errors on the simplified token list
+        return NEEDS_VALUEFLOW | NEEDS_SIMPLIFIED;
+    }
+
 
 
     /**
@@ -70,6 +70,11 @@ public:
         (void)errorLogger;
     }
 
+    unsigned int neededResults(const Settings * /*settings*/) const OVERRIDE {
+        // stringLiteralWrite() and sprintfOverlappingData() report errors, always enabled
+        return NEEDS_VALUEFLOW;
+    }
+
     /** @brief undefined behaviour, writing string literal */
     void stringLiteralWrite();
 
@@ -66,6 +66,11 @@ public:
         (void)errorLogger;
     }
 
+    unsigned int neededResults(const Settings * /*settings*/) const OVERRIDE {
+        // checkTooBigBitwiseShift() and checkIntegerOverflow() report errors, always enabled
+        return NEEDS_VALUEFLOW;
+    }
+
     /** @brief %Check for bitwise shift with too big right operand */
     void checkTooBigBitwiseShift();
 
@@ -33,7 +33,10 @@
 #include <cstdlib>
 #include <cstring>
 #include <istream>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 //---------------------------------------------------------------------------
 
 
@@ -48,11 +51,14 @@ static const struct CWE CWE561(561U);   // Dead Code
 // FUNCTION USAGE - Check for unused functions etc
 //---------------------------------------------------------------------------
 
-void CheckUnusedFunctions::parseTokens(const Tokenizer &tokenizer, const char FileName[], const Settings *settings)
+void CheckUnusedFunctions::parseTokens(const Tokenizer &tokenizer, const char FileName[], const Settings *settings, MyFileInfo &fileInfo) const
 {
     const bool doMarkup = settings->library.markupFile(FileName);
     const SymbolDatabase* symbolDatabase = tokenizer.getSymbolDatabase();
 
+    // body start => declaration, to attribute the calls to the calling function
+    std::unordered_map<const Token *, MyFileInfo::FunctionDecl *> bodyStarts;
+
     // Function declarations..
     for (std::size_t i = 0; i < symbolDatabase->functionScopes.size(); i++) {
         const Scope* scope = symbolDatabase->functionScopes[i];
@@ -71,26 +77,37 @@ void CheckUnusedFunctions::parseTokens(const Tokenizer &tokenizer, const char Fi
         if (retDef && retDef->str() == ">")
             continue;
         
-        mFunctionDecl.emplace_back(func);
-
-        FunctionUsage &usage = mFunctions[func->name()];
-
-        if (!usage.lineNumber)
-            usage.lineNumber = func->token->linenr();
-
-        // No filename set yet..
-        if (usage.filename.empty()) {
-            usage.filename = tokenizer.list.getSourceFilePath();
-        }
-        // Multiple files => filename = "+"
-        else if (usage.filename != tokenizer.list.getSourceFilePath()) {
-            //func.filename = "+";
-            usage.usedOtherFile |= usage.usedSameFile;
-        }
+        MyFileInfo::FunctionDecl decl;
+        decl.functionName = func->name();
+        decl.fileName = tokenizer.list.getSourceFilePath();
+        decl.lineNumber = func->token->linenr();
+        decl.argCount = static_cast<unsigned int>(func->argCount());
+        fileInfo.functionDecls.push_back(decl);
+        bodyStarts[scope->bodyStart] = &fileInfo.functionDecls.back();
     }
 
+    MyFileInfo::FunctionDecl *caller = nullptr;
+    const Token *callerEnd = nullptr;
+    const auto addCall = [&](const std::string &name) {
+        fileInfo.functionCalls.insert(name);
+        if (caller)
+            caller->calls.insert(name);
+        else
+            fileInfo.rootCalls.insert(name);
+    };
+
     // Function usage..
     for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
+        if (tok == callerEnd) {
+            caller = nullptr;
+            callerEnd = nullptr;
+        } else if (!caller && tok->str() == "{") {
+            const std::unordered_map<const Token *, MyFileInfo::FunctionDecl *>::const_iterator it = bodyStarts.find(tok);
+            if (it != bodyStarts.end()) {
+                caller = it->second;
+                callerEnd = tok->link();
+            }
+        }
 
         // parsing of library code to find called functions
         if (settings->library.isexecutableblock(FileName, tok->str())) {
@@ -110,17 +127,7 @@ void CheckUnusedFunctions::parseTokens(const Tokenizer &tokenizer, const char Fi
                 } else if (markupVarToken->str() == settings->library.blockend(FileName))
                     scope--;
                 else if (!settings->library.iskeyword(FileName, markupVarToken->str())) {
-                    mFunctionCalls.insert(markupVarToken->str());
-                    if (mFunctions.find(markupVarToken->str()) != mFunctions.end())
-                        mFunctions[markupVarToken->str()].usedOtherFile = true;
-                    else if (markupVarToken->next()->str() == "(") {
-                        FunctionUsage &func = mFunctions[markupVarToken->str()];
-                        func.filename = tokenizer.list.getSourceFilePath();
-                        if (func.filename.empty() || func.filename == "+")
-                            func.usedOtherFile = true;
-                        else
-                            func.usedSameFile = true;
-                    }
+                    addCall(markupVarToken->str());
                 }
                 markupVarToken = markupVarToken->next();
             }
@@ -132,19 +139,11 @@ void CheckUnusedFunctions::parseTokens(const Tokenizer &tokenizer, const char Fi
             while (propToken && propToken->str() != ")") {
                 if (settings->library.isexportedprefix(tok->str(), propToken->str())) {
                     const Token* nextPropToken = propToken->next();
-                    const std::string& value = nextPropToken->str();
-                    if (mFunctions.find(value) != mFunctions.end()) {
-                        mFunctions[value].usedOtherFile = true;
-                    }
-                    mFunctionCalls.insert(value);
+                    addCall(nextPropToken->str());
                 }
                 if (settings->library.isexportedsuffix(tok->str(), propToken->str())) {
                     const Token* prevPropToken = propToken->previous();
-                    const std::string& value = prevPropToken->str();
-                    if (value != ")" && mFunctions.find(value) != mFunctions.end()) {
-                        mFunctions[value].usedOtherFile = true;
-                    }
-                    mFunctionCalls.insert(value);
+                    addCall(prevPropToken->str());
                 }
                 propToken = propToken->next();
             }
@@ -157,8 +156,7 @@ void CheckUnusedFunctions::parseTokens(const Tokenizer &tokenizer, const char Fi
                 while (propToken && propToken->str() != ")") {
                     const std::string& value = propToken->str();
                     if (!value.empty()) {
-                        mFunctions[value].usedOtherFile = true;
-                        mFunctionCalls.insert(value);
+                        addCall(value);
                         break;
                     }
                     propToken = propToken->next();
@@ -166,27 +164,28 @@ void CheckUnusedFunctions::parseTokens(const Tokenizer &tokenizer, const char Fi
             }
         }
 
-        if (settings->library.isreflection(tok->str())) {
+        // callback given by name, e.g. dpConnect("cb", ..)
+        if (settings->library.isreflection(tok->str()) && Token::simpleMatch(tok->next(), "(")) {
             const int argIndex = settings->library.reflectionArgument(tok->str());
-            if (argIndex >= 0) {
-                const Token * funcToken = tok->next();
-                int index = 0;
-                std::string value;
-                while (funcToken) {
-                    if (funcToken->str()==",") {
-                        if (++index == argIndex)
-                            break;
-                        value.clear();
-                    } else
-                        value += funcToken->str();
-                    funcToken = funcToken->next();
-                }
-                if (index == argIndex) {
-                    value = value.substr(1, value.length() - 2);
-                    mFunctions[value].usedOtherFile = true;
-                    mFunctionCalls.insert(value);
+            const Token * const endPar = tok->next()->link();
+            const Token * funcToken = tok->tokAt(2);
+            int index = 1;
+            std::string value;
+            while (funcToken && funcToken != endPar) {
+                if (funcToken->str() == ",") {
+                    if (index == argIndex)
+                        break;
+                    ++index;
+                    value.clear();
+                } else {
+                    value += funcToken->str();
+                    if (Token::Match(funcToken, "(|[") && funcToken->link())
+                        funcToken = funcToken->link();
                 }
+                funcToken = funcToken->next();
             }
+            if (index == argIndex && value.size() > 2 && value[0] == '\"' && value[value.size() - 1] == '\"')
+                addCall(value.substr(1, value.size() - 2));
         }
 
         const Token *funcname = nullptr;
@@ -220,17 +219,8 @@ void CheckUnusedFunctions::parseTokens(const Tokenizer &tokenizer, const char Fi
                 funcname = nullptr;
         }
 
-        if (funcname) {
-            FunctionUsage &func = mFunctions[ funcname->str()];
-            const std::string& called_from_file = tokenizer.list.getSourceFilePath();
-
-            if (func.filename.empty() || func.filename == "+" || func.filename != called_from_file)
-                func.usedOtherFile = true;
-            else
-                func.usedSameFile = true;
-
-            mFunctionCalls.insert(funcname->str());
-        }
+        if (funcname)
+            addCall(funcname->str());
     }
 }
 
@@ -284,39 +274,26 @@ static bool isOperatorFunction(const std::string & funcName)
 
 
 
-bool CheckUnusedFunctions::check(ErrorLogger * const errorLogger, const Settings& settings)
+void CheckUnusedFunctions::unusedFunctionError(ErrorLogger * const errorLogger,
+        const std::string &filename, unsigned int lineNumber,
+        const std::string &funcname)
 {
-    bool errors = false;
-    for (std::map<std::string, FunctionUsage>::const_iterator it = mFunctions.begin(); it != mFunctions.end(); ++it) {
-        const FunctionUsage &func = it->second;
-        if (func.usedOtherFile || func.filename.empty())
-            continue;
-        if (it->first == "main" ||
-            (settings.isWindowsPlatform() && (it->first == "WinMain" || it->first == "_tmain")) ||
-            it->first == "if")
-            continue;
-        if (!func.usedSameFile) {
-            if (isOperatorFunction(it->first))
-                continue;
-            std::string filename;
-            if (func.filename != "+")
-                filename = func.filename;
-            unusedFunctionError(errorLogger, filename, func.lineNumber, it->first);
-            errors = true;
-        } else if (! func.usedOtherFile) {
-            /** @todo add error message "function is only used in <file> it can be static" */
-            /*
-            std::ostringstream errmsg;
-            errmsg << "The function '" << it->first << "' is only used in the file it was declared in so it should have local linkage.";
-            mErrorLogger->reportErr( errmsg.str() );
-            errors = true;
-            */
-        }
+    std::list<ErrorLogger::ErrorMessage::FileLocation> locationList;
+    if (!filename.empty()) {
+        ErrorLogger::ErrorMessage::FileLocation fileLoc;
+        fileLoc.setfile(filename);
+        fileLoc.line = lineNumber;
+        locationList.push_back(fileLoc);
     }
-    return errors;
+
+    const ErrorLogger::ErrorMessage errmsg(locationList, emptyString, Severity::style, "$symbol:" + funcname + "\nThe function is never used: '$symbol'", "unusedFunction", CWE561, false);
+    if (errorLogger)
+        errorLogger->reportErr(errmsg);
+    else
+        reportError(errmsg);
 }
 
-void CheckUnusedFunctions::unusedFunctionError(ErrorLogger * const errorLogger,
+void CheckUnusedFunctions::unreachableFunctionError(ErrorLogger * const errorLogger,
         const std::string &filename, unsigned int lineNumber,
         const std::string &funcname)
 {
@@ -328,7 +305,12 @@ void CheckUnusedFunctions::unusedFunctionError(ErrorLogger * const errorLogger,
         locationList.push_back(fileLoc);
     }
 
-    const ErrorLogger::ErrorMessage errmsg(locationList, emptyString, Severity::style, "$symbol:" + funcname + "\nThe function is never used: '$symbol'", "unusedFunction", CWE561, false);
+    const ErrorLogger::ErrorMessage errmsg(locationList, emptyString, Severity::style,
+                                           "$symbol:" + funcname + "\n"
+                                           "The function '$symbol' is never called from an entry point.\n"
+                                           "The function '$symbol' is only called by functions that are never used or not reachable "
+                                           "from an entry point like main(), so it is never executed.",
+                                           "unreachableFunction", CWE561, false);
     if (errorLogger)
         errorLogger->reportErr(errmsg);
     else
@@ -340,103 +322,132 @@ Check::FileInfo *CheckUnusedFunctions::getFileInfo(const Tokenizer *tokenizer, c
     if (!settings->isEnabled(Settings::UNUSED_FUNCTION))
         return nullptr;
 
-    return nullptr;
-}
-
-bool CheckUnusedFunctions::analyseWholeProgram(const CTU::FileInfo *ctu, const std::list<Check::FileInfo*> &fileInfo, const Settings& settings, ErrorLogger &errorLogger)
-{
-    (void)ctu;
-    (void)fileInfo;
-    return check(&errorLogger, settings);
-}
-
-CheckUnusedFunctions::FunctionDecl::FunctionDecl(const Function *f)
-    : functionName(f->name()), lineNumber(f->token->linenr())
-{
+    MyFileInfo *fileInfo = new MyFileInfo;
+    parseTokens(*tokenizer, tokenizer->list.getSourceFilePath().c_str(), settings, *fileInfo);
+    return fileInfo;
 }
 
-std::string CheckUnusedFunctions::analyzerInfo() const
+std::string CheckUnusedFunctions::MyFileInfo::toString() const
 {
     std::ostringstream ret;
-    for (std::list<FunctionDecl>::const_iterator it = mFunctionDecl.begin(); it != mFunctionDecl.end(); ++it) {
+    for (const FunctionDecl &decl : functionDecls) {
         ret << "    <functiondecl"
-            << " functionName=\"" << ErrorLogger::toxml(it->functionName) << '\"'
-            << " lineNumber=\"" << it->lineNumber << "\"/>\n";
+            << " functionName=\"" << ErrorLogger::escapeXml(decl.functionName) << '\"'
+            << " fileName=\"" << ErrorLogger::escapeXml(decl.fileName) << '\"'
+            << " lineNumber=\"" << decl.lineNumber << '\"'
+            << " argCount=\"" << decl.argCount << "\"/>\n";
+        for (const std::string &call : decl.calls) {
+            ret << "    <functionedge"
+                << " caller=\"" << ErrorLogger::escapeXml(decl.functionName) << '\"'
+                << " functionName=\"" << ErrorLogger::escapeXml(call) << "\"/>\n";
+        }
+    }
+    for (const std::string &call : functionCalls) {
+        ret << "    <functioncall functionName=\"" << ErrorLogger::escapeXml(call) << "\"/>\n";
     }
-    for (std::set<std::string>::const_iterator it = mFunctionCalls.begin(); it != mFunctionCalls.end(); ++it) {
-        ret << "    <functioncall functionName=\"" << ErrorLogger::toxml(*it) << "\"/>\n";
+    for (const std::string &call : rootCalls) {
+        ret << "    <functionroot functionName=\"" << ErrorLogger::escapeXml(call) << "\"/>\n";
     }
     return ret.str();
 }
 
-namespace {
-    struct Location {
-        Location() : lineNumber(0) {}
-        Location(const std::string &f, const int l) : fileName(f), lineNumber(l) {}
-        std::string fileName;
-        int lineNumber;
-    };
+Check::FileInfo * CheckUnusedFunctions::loadFileInfoFromXml(const tinyxml2::XMLElement *xmlElement) const
+{
+    MyFileInfo *fileInfo = new MyFileInfo;
+    for (const tinyxml2::XMLElement *e = xmlElement->FirstChildElement(); e; e = e->NextSiblingElement()) {
+        const char* functionName = e->Attribute("functionName");
+        if (functionName == nullptr)
+            continue;
+        if (std::strcmp(e->Name(), "functioncall") == 0) {
+            fileInfo->functionCalls.insert(functionName);
+        } else if (std::strcmp(e->Name(), "functiondecl") == 0) {
+            MyFileInfo::FunctionDecl decl;
+            decl.functionName = functionName;
+            const char* fileName = e->Attribute("fileName");
+            if (fileName)
+                decl.fileName = fileName;
+            decl.lineNumber = e->UnsignedAttribute("lineNumber");
+            decl.argCount = e->UnsignedAttribute("argCount");
+            fileInfo->functionDecls.push_back(decl);
+        } else if (std::strcmp(e->Name(), "functionedge") == 0) {
+            // the edges follow their declaration
+            const char* caller = e->Attribute("caller");
+            if (caller && !fileInfo->functionDecls.empty() && fileInfo->functionDecls.back().functionName == caller)
+                fileInfo->functionDecls.back().calls.insert(functionName);
+        } else if (std::strcmp(e->Name(), "functionroot") == 0) {
+            fileInfo->rootCalls.insert(functionName);
+        }
+    }
+    return fileInfo;
 }
 
-void CheckUnusedFunctions::analyseWholeProgram(ErrorLogger * const errorLogger, const std::string &buildDir)
+bool CheckUnusedFunctions::analyseWholeProgram(const CTU::FileInfo *ctu, const std::list<Check::FileInfo*> &fileInfo, const Settings& settings, ErrorLogger &errorLogger)
 {
-    std::map<std::string, Location> decls;
-    std::set<std::string> calls;
-
-    const std::string filesTxt(buildDir + "/files.txt");
-    std::ifstream fin(filesTxt.c_str());
-    std::string filesTxtLine;
-    while (std::getline(fin, filesTxtLine)) {
-        const std::string::size_type firstColon = filesTxtLine.find(':');
-        if (firstColon == std::string::npos)
-            continue;
-        const std::string::size_type secondColon = filesTxtLine.find(':', firstColon+1);
-        if (secondColon == std::string::npos)
-            continue;
-        const std::string xmlfile = buildDir + '/' + filesTxtLine.substr(0,firstColon);
-        const std::string sourcefile = filesTxtLine.substr(secondColon+1);
+    (void)ctu;
 
-        tinyxml2::XMLDocument doc;
-        const tinyxml2::XMLError error = doc.LoadFile(xmlfile.c_str());
-        if (error != tinyxml2::XML_SUCCESS)
+    // Project wide symbol index and call graph, built once from the summaries of all files
+    std::unordered_map<std::string, const MyFileInfo::FunctionDecl *> decls;
+    std::unordered_map<std::string, std::vector<const std::set<std::string> *> > callees;
+    std::unordered_set<std::string> calls;
+    std::vector<const MyFileInfo::FunctionDecl *> declOrder;
+    std::vector<std::string> worklist;
+    for (const Check::FileInfo *fi1 : fileInfo) {
+        const MyFileInfo *fi = dynamic_cast<const MyFileInfo *>(fi1);
+        if (!fi)
             continue;
+        for (const MyFileInfo::FunctionDecl &decl : fi->functionDecls) {
+            if (decls.emplace(decl.functionName, &decl).second)
+                declOrder.push_back(&decl);
+            callees[decl.functionName].push_back(&decl.calls);
+        }
+        calls.insert(fi->functionCalls.begin(), fi->functionCalls.end());
+        worklist.insert(worklist.end(), fi->rootCalls.begin(), fi->rootCalls.end());
+    }
 
-        const tinyxml2::XMLElement * const rootNode = doc.FirstChildElement();
-        if (rootNode == nullptr)
-            continue;
+    const auto isEntryPoint = [&settings](const std::string &functionName) {
+        return functionName == "main" ||
+               (settings.isWindowsPlatform() && (functionName == "WinMain" || functionName == "_tmain")) ||
+               settings.library.isentrypoint(functionName);
+    };
 
-        for (const tinyxml2::XMLElement *e = rootNode->FirstChildElement(); e; e = e->NextSiblingElement()) {
-            if (std::strcmp(e->Name(), "FileInfo") != 0)
-                continue;
-            const char *checkattr = e->Attribute("check");
-            if (checkattr == nullptr || std::strcmp(checkattr,"CheckUnusedFunctions") != 0)
-                continue;
-            for (const tinyxml2::XMLElement *e2 = e->FirstChildElement(); e2; e2 = e2->NextSiblingElement()) {
-                const char* functionName = e2->Attribute("functionName");
-                if (functionName == nullptr)
-                    continue;
-                if (std::strcmp(e2->Name(),"functioncall") == 0) {
-                    calls.insert(functionName);
-                    continue;
-                } else if (std::strcmp(e2->Name(),"functiondecl") == 0) {
-                    const char* lineNumber = e2->Attribute("lineNumber");
-                    if (lineNumber)
-                        decls[functionName] = Location(sourcefile, std::atoi(lineNumber));
-                }
+    // Reachability from the entry points. Without an entry point (e.g. a
+    // library is checked alone) nothing is reported as unreachable.
+    bool hasEntryPoint = false;
+    for (const MyFileInfo::FunctionDecl *decl : declOrder) {
+        if (isEntryPoint(decl->functionName)) {
+            hasEntryPoint = true;
+            worklist.push_back(decl->functionName);
+        }
+    }
+    std::unordered_set<std::string> reachable;
+    while (hasEntryPoint && !worklist.empty()) {
+        const std::string functionName = worklist.back();
+        worklist.pop_back();
+        if (!reachable.insert(functionName).second)
+            continue;
+        const std::unordered_map<std::string, std::vector<const std::set<std::string> *> >::const_iterator it = callees.find(functionName);
+        if (it == callees.end())
+            continue;
+        for (const std::set<std::string> *functionCalls : it->second) {
+            for (const std::string &callee : *functionCalls) {
+                if (reachable.find(callee) == reachable.end())
+                    worklist.push_back(callee);
             }
         }
     }
 
-    for (std::map<std::string, Location>::const_iterator decl = decls.begin(); decl != decls.end(); ++decl) {
-        const std::string &functionName = decl->first;
-
-        if (functionName == "main" || functionName == "WinMain" || functionName == "_tmain" ||
-            functionName == "if")
+    bool errors = false;
+    for (const MyFileInfo::FunctionDecl *decl : declOrder) {
+        const std::string &functionName = decl->functionName;
+        if (isEntryPoint(functionName) || functionName == "if" || isOperatorFunction(functionName))
             continue;
-
-        if (calls.find(functionName) == calls.end() && !isOperatorFunction(functionName)) {
-            const Location &loc = decl->second;
-            unusedFunctionError(errorLogger, loc.fileName, loc.lineNumber, functionName);
-        }
+        if (calls.find(functionName) == calls.end())
+            unusedFunctionError(&errorLogger, decl->fileName, decl->lineNumber, functionName);
+        else if (hasEntryPoint && reachable.find(functionName) == reachable.end())
+            unreachableFunctionError(&errorLogger, decl->fileName, decl->lineNumber, functionName);
+        else
+            continue;
+        errors = true;
     }
+    return errors;
 }
@@ -26,7 +26,6 @@
 #include "config.h"
 
 #include <list>
-#include <map>
 #include <set>
 #include <string>
 
@@ -50,37 +49,62 @@ public:
         : Check(myName(), tokenizer, settings, errorLogger) {
     }
 
-    static void clear() {
-        instance.mFunctions.clear();
-        instance.mFunctionCalls.clear();
-    }
-
-    // Parse current tokens and determine..
-    // * Check what functions are used
-    // * What functions are declared
-    void parseTokens(const Tokenizer &tokenizer, const char FileName[], const Settings *settings);
-
-    // Return true if an error is reported.
-    bool check(ErrorLogger * const errorLogger, const Settings& settings);
+    /** @brief Per file summary of the declared and the called functions */
+    class MyFileInfo : public Check::FileInfo {
+    public:
+        struct FunctionDecl {
+            FunctionDecl() : lineNumber(0), argCount(0) {}
+            std::string functionName;
+            std::string fileName;
+            unsigned int lineNumber;
+            unsigned int argCount;
+            /** names that are called / referenced in the body (call graph edges) */
+            std::set<std::string> calls;
+        };
+
+        /** functions defined in this file */
+        std::list<FunctionDecl> functionDecls;
+
+        /** names of all functions that are called / referenced in this file */
+        std::set<std::string> functionCalls;
+
+        /**
+         * names that are referenced outside of the bodies of functionDecls,
+         * e.g. in class methods, global initializations or markup code. They
+         * are treated as reachable.
+         */
+        std::set<std::string> rootCalls;
+
+        /** serialize the summary, can be read again with loadFileInfoFromXml() */
+        std::string toString() const OVERRIDE;
+    };
 
     /** @brief Parse current TU and extract file info */
     Check::FileInfo *getFileInfo(const Tokenizer *tokenizer, const Settings *settings) const OVERRIDE;
 
-    /** @brief Analyse all file infos for all TU */
+    Check::FileInfo * loadFileInfoFromXml(const tinyxml2::XMLElement *xmlElement) const OVERRIDE;
+
+    /**
+     * @brief Analyse all file infos for all TU. The summaries are merged into
+     * a project wide call graph: functions that are never referenced are
+     * unused, referenced functions that can't be reached from an entry point
+     * (main, library entry points, referenced outside of functions) are
+     * unreachable.
+     * The index only exists after all files are checked, it is not queried
+     * by the checks of a single file. Those see the #uses libraries of the
+     * file in the symbol database already. The summaries of unchanged files
+     * come from the cache dir (ResultCache).
+     */
     bool analyseWholeProgram(const CTU::FileInfo *ctu, const std::list<Check::FileInfo*> &fileInfo, const Settings& settings, ErrorLogger &errorLogger) OVERRIDE;
 
     static CheckUnusedFunctions instance;
 
-    std::string analyzerInfo() const;
-
-    /** @brief Combine and analyze all analyzerInfos for all TUs */
-    static void analyseWholeProgram(ErrorLogger * const errorLogger, const std::string &buildDir);
-
 private:
 
     void getErrorMessages(ErrorLogger *errorLogger, const Settings *settings) const OVERRIDE {
         CheckUnusedFunctions c(nullptr, settings, errorLogger);
         c.unusedFunctionError(errorLogger, emptyString, 0, "funcName");
+        c.unreachableFunctionError(errorLogger, emptyString, 0, "funcName");
     }
 
     /**
@@ -90,41 +114,36 @@ private:
                                     const std::string &filename, unsigned int lineNumber,
                                     const std::string &funcname);
 
+    static void unreachableFunctionError(ErrorLogger * const errorLogger,
+                                         const std::string &filename, unsigned int lineNumber,
+                                         const std::string &funcname);
+
     /**
      * Dummy implementation, just to provide error for --errorlist
      */
     void runSimplifiedChecks(const Tokenizer* /*tokenizer*/, const Settings* /*settings*/, ErrorLogger* /*errorLogger*/) OVERRIDE {
     }
 
+    unsigned int neededResults(const Settings * /*settings*/) const OVERRIDE {
+        return 0;
+    }
+
     static std::string myName() {
         return "Unused functions";
     }
 
     std::string classInfo() const OVERRIDE {
-        return "Check for functions that are never called\n";
+        return "Check for functions that are never called\n"
+               "- functions that are never referenced\n"
+               "- functions that are not reachable from an entry point (e.g. only called by unused functions)\n";
     }
 
-    class CPPCHECKLIB FunctionUsage {
-    public:
-        FunctionUsage() : lineNumber(0), usedSameFile(false), usedOtherFile(false) {
-        }
-
-        std::string filename;
-        unsigned int lineNumber;
-        bool   usedSameFile;
-        bool   usedOtherFile;
-    };
-
-    std::map<std::string, FunctionUsage> mFunctions;
-
-    class CPPCHECKLIB FunctionDecl {
-    public:
-        explicit FunctionDecl(const Function *f);
-        std::string functionName;
-        unsigned int lineNumber;
-    };
-    std::list<FunctionDecl> mFunctionDecl;
-    std::set<std::string> mFunctionCalls;
+    /**
+     * Parse current tokens and determine..
+     * * Check what functions are used
+     * * What functions are declared
+     */
+    void parseTokens(const Tokenizer &tokenizer, const char FileName[], const Settings *settings, MyFileInfo &fileInfo) const;
 };
 /// @}
 //---------------------------------------------------------------------------
@@ -68,6 +68,13 @@ public:
         (void)errorLogger;
     }
 
+    unsigned int neededResults(const Settings *settings) const OVERRIDE {
+        // only checkFunctionVariableUsage() uses values, it reports warnings and style
+        if (settings->isEnabled(Settings::WARNING) || settings->isEnabled(Settings::STYLE))
+            return NEEDS_VALUEFLOW;
+        return 0;
+    }
+
     /** @brief %Check for unused function variables */
     void checkFunctionVariableUsage_iterateScopes(const Scope* const scope, Variables& variables);
     void checkFunctionVariableUsage();
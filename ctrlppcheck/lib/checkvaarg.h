@@ -54,6 +54,10 @@ public:
         check.va_list_usage();
     }
 
+    unsigned int neededResults(const Settings * /*settings*/) const OVERRIDE {
+        return NEEDS_SIMPLIFIED;
+    }
+
     void va_start_argument();
     void va_list_usage();
 
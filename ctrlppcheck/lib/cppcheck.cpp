@@ -1,13 +1,15 @@
 #include "cppcheck.h"
 
 #include "check.h"
-#include "checkunusedfunctions.h"
+#include "checknaming.h"
 #include "ctu.h"
 #include "library.h"
 #include "mathlib.h"
+#include "memoryusage.h"
 #include "path.h"
 #include "platform.h"
 #include "preprocessor.h" // Preprocessor
+#include "resultcache.h"
 #include "suppressions.h"
 #include "timer.h"
 #include "token.h"
@@ -19,8 +21,10 @@
 #include <tinyxml2.h>
 #include <algorithm>
 #include <cstring>
+#include <fstream>
 #include <new>
 #include <set>
+#include <sstream>
 #include <stdexcept>
 #include <vector>
 
@@ -35,6 +39,9 @@ static const char ExtraVersion[] = "";
 
 static TimerResults S_timerResults;
 
+/** Largest analysis data of a file, per subsystem (--showtime=memory) */
+static MemoryUsage S_peakMemoryUsage;
+
 // CWE ids used
 static const CWE CWE398(398U);  // Indicator of Poor Code Quality
 
@@ -54,18 +61,38 @@ static std::vector<std::string> split(const std::string &str, const std::string
 
 //----------------------------------------------------------------------------------------------------------------------------------------
 CppCheck::CppCheck(ErrorLogger &errorLogger, bool useGlobalSuppressions)
-    : mErrorLogger(errorLogger), mExitCode(0), mSuppressInternalErrorFound(false), mUseGlobalSuppressions(useGlobalSuppressions), mSimplify(true)
+    : mErrorLogger(errorLogger), mExitCode(0), mSuppressInternalErrorFound(false), mUseGlobalSuppressions(useGlobalSuppressions), mSimplify(true), mNamingRulesLoaded(false), mResultCache(nullptr)
 {
 }
 
 //----------------------------------------------------------------------------------------------------------------------------------------
 CppCheck::~CppCheck()
 {
+    if (mSettings.showtime == SHOWTIME_MEMORY) {
+        // the whole program analysis data, estimated by the size of the serialized data
+        std::size_t fileInfoSize = 0;
+        for (const Check::FileInfo *fi : mFileInfo)
+            fileInfoSize += fi->toString().size();
+        std::cout << "Peak memory of a file: " << S_peakMemoryUsage.toString() << std::endl;
+        std::cout << "Whole program analysis data: " << MemoryUsage::toMiB(fileInfoSize) << " (" << mFileInfo.size() << " file info(s))" << std::endl;
+        std::cout << "Peak process memory: " << MemoryUsage::toMiB(MemoryUsage::peakProcessMemory()) << std::endl;
+    }
     while (!mFileInfo.empty()) {
         delete mFileInfo.back();
         mFileInfo.pop_back();
     }
     S_timerResults.ShowResults(mSettings.showtime);
+    if (mSettings.showtime != SHOWTIME_NONE && mSettings.showtime != SHOWTIME_QUIET) {
+        unsigned long long hits, misses;
+        simplecpp::getHeaderCacheStatistics(&hits, &misses);
+        std::cout << "Header resolution cache: " << hits << " hit(s), " << misses << " miss(es)" << std::endl;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------
+TimerResults &CppCheck::timerResults()
+{
+    return S_timerResults;
 }
 
 //----------------------------------------------------------------------------------------------------------------------------------------
@@ -80,18 +107,34 @@ const char * CppCheck::extraVersion()
     return ExtraVersion;
 }
 
+//----------------------------------------------------------------------------------------------------------------------------------------
+/** Read the complete file with one read, an unreadable file is empty */
+static std::string readFileContent(const std::string &path)
+{
+    std::ifstream fin(path, std::ios::in | std::ios::binary | std::ios::ate);
+    std::string content;
+    if (!fin.is_open())
+        return content;
+    const std::streamoff size = fin.tellg();
+    if (size > 0) {
+        content.resize(static_cast<std::size_t>(size));
+        fin.seekg(0);
+        fin.read(&content[0], size);
+        content.resize(static_cast<std::size_t>(fin.gcount()));
+    }
+    return content;
+}
+
 //----------------------------------------------------------------------------------------------------------------------------------------
 unsigned int CppCheck::check(const std::string &path)
 {
-    std::ifstream fin(path);
-    return checkFile(Path::simplifyPath(path), emptyString, fin);
+    return checkFile(Path::simplifyPath(path), emptyString, readFileContent(path));
 }
 
 //----------------------------------------------------------------------------------------------------------------------------------------
 unsigned int CppCheck::check(const std::string &path, const std::string &content)
 {
-    std::istringstream iss(content);
-    return checkFile(Path::simplifyPath(path), emptyString, iss);
+    return checkFile(Path::simplifyPath(path), emptyString, content);
 }
 
 //----------------------------------------------------------------------------------------------------------------------------------------
@@ -103,40 +146,11 @@ unsigned int CppCheck::check(const ImportProject::FileSettings &fs)
     if (fs.platformType != Settings::Unspecified) {
         temp.mSettings.platform(fs.platformType);
     }
-    std::ifstream fin(fs.filename);
-    return temp.checkFile(Path::simplifyPath(fs.filename), fs.cfg, fin);
+    return temp.checkFile(Path::simplifyPath(fs.filename), fs.cfg, readFileContent(fs.filename));
 }
 
 //----------------------------------------------------------------------------------------------------------------------------------------
-size_t CppCheck::getCountOfLines(std::istream &is)
-{
-    // skip when bad
-    if (is.bad())
-        return 0;
-    // save state
-    std::istream::iostate state_backup = is.rdstate();
-    // clear state
-    is.clear();
-    std::streampos pos_backup = is.tellg();
-
-    is.seekg(0);
-    size_t line_cnt;
-    size_t lf_cnt = std::count(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>(), '\n');
-    line_cnt = lf_cnt;
-    // if the file is not end with '\n' , then line_cnt should plus 1  
-    is.unget();
-    if (is.get() != '\n') { ++line_cnt; }
-
-    // recover state
-    is.clear(); // previous reading may set eofbit
-    is.seekg(pos_backup);
-    is.setstate(state_backup);
-
-    return line_cnt;
-}
-
-//----------------------------------------------------------------------------------------------------------------------------------------
-unsigned int CppCheck::checkFile(const std::string& filename, const std::string &cfgname, std::istream& fileStream)
+unsigned int CppCheck::checkFile(const std::string& filename, const std::string &cfgname, const std::string &content)
 {   
     mExitCode = 0;
     mSuppressInternalErrorFound = false;
@@ -148,6 +162,12 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
     if (mSettings.terminated())
         return mExitCode;
 
+    // the naming rules are parsed and compiled once for all files
+    if (!mNamingRulesLoaded && mSettings.isEnabled(Settings::STYLE)) {
+        mSettings.namingRules = CheckNaming::loadNamingRules(mSettings);
+        mNamingRulesLoaded = true;
+    }
+
     if (!mSettings.quiet) {
         std::string fixedpath = Path::simplifyPath(filename);
         fixedpath = Path::toNativeSeparators(fixedpath);
@@ -162,16 +182,17 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
         }
     }
 
-    CheckUnusedFunctions checkUnusedFunctions(nullptr, nullptr, nullptr);
-
     bool internalErrorFound(false);
+    std::unique_ptr<ResultCache> resultCache;
     try {
         Preprocessor preprocessor(mSettings, this);
         std::set<std::string> configurations;
 
         simplecpp::OutputList outputList;
         std::vector<std::string> files;
-        simplecpp::TokenList tokens1(fileStream, files, filename, &outputList);
+        Timer timerTokens1("simplecpp::TokenList", mSettings.showtime, &S_timerResults);
+        simplecpp::TokenList tokens1(reinterpret_cast<const unsigned char *>(content.data()), content.size(), files, filename, &outputList);
+        timerTokens1.Stop();
 
         // If there is a syntax error, report it and stop
         for (const simplecpp::Output &output : outputList) {
@@ -205,16 +226,23 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             }
         }
 
+        Timer timerLoadFiles("Preprocessor::loadFiles", mSettings.showtime, &S_timerResults);
         preprocessor.loadFiles(tokens1, files);
+        timerLoadFiles.Stop();
 
         // write dump file xml prolog
+        // The dump is written element by element, give the stream a large buffer.
+        // It must be declared before the stream, which flushes into it when closed.
+        std::vector<char> fdumpBuffer;
         std::ofstream fdump;
         if (mSettings.dump) {
             const std::string dumpfile(mSettings.dumpFile.empty() ? (filename + ".dump") : mSettings.dumpFile);
+            fdumpBuffer.resize(1024U * 1024U);
+            fdump.rdbuf()->pubsetbuf(fdumpBuffer.data(), fdumpBuffer.size());
             fdump.open(dumpfile);
             if (fdump.is_open()) {
-                fdump << "<?xml version=\"1.0\"?>" << std::endl;
-                fdump << "<dumps>" << std::endl;
+                fdump << "<?xml version=\"1.0\"?>\n";
+                fdump << "<dumps>\n";
                 fdump << "  <platform"
                       << " name=\"" << mSettings.platformString() << '\"'
                       << " char_bit=\"" << mSettings.char_bit << '\"'
@@ -224,17 +252,17 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
                       << " long_long_bit=\"" << mSettings.long_long_bit << '\"'
                       << " pointer_bit=\"" << (mSettings.sizeof_pointer * mSettings.char_bit) << '\"'
                       << "/>\n";
-                fdump << "  <rawtokens>" << std::endl;
+                fdump << "  <rawtokens>\n";
                 for (unsigned int i = 0; i < files.size(); ++i)
-                    fdump << "    <file index=\"" << i << "\" name=\"" << ErrorLogger::toxml(files[i]) << "\"/>" << std::endl;
+                    fdump << "    <file index=\"" << i << "\" name=\"" << ErrorLogger::toxml(files[i]) << "\"/>\n";
                 for (const simplecpp::Token *tok = tokens1.cfront(); tok; tok = tok->next) {
                     fdump << "    <tok "
                           << "fileIndex=\"" << tok->location.fileIndex << "\" "
                           << "linenr=\"" << tok->location.line << "\" "
                           << "str=\"" << ErrorLogger::toxml(tok->str()) << "\""
-                          << "/>" << std::endl;
+                          << "/>\n";
                 }
-                fdump << "  </rawtokens>" << std::endl;
+                fdump << "  </rawtokens>\n";
             }
         }
 
@@ -246,6 +274,22 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
         tokens1.removeComments();
         preprocessor.removeComments();
 
+        // Use the cached results if the code, the #uses files and the settings are unchanged
+        if (!mSettings.cacheDir.empty() && !mSettings.dump && !mSettings.preprocessOnly && !mSettings.checkConfiguration &&
+            !mSettings.debugnormal && !mSettings.debugwarnings && !mSettings.debugSimplified) {
+            Timer t("ResultCache::load", mSettings.showtime, &S_timerResults);
+            resultCache.reset(new ResultCache(mSettings.cacheDir, filename, preprocessor.calculateChecksum(tokens1, getToolinfo())));
+            std::list<ErrorLogger::ErrorMessage> errors;
+            if (resultCache->load(errors, mFileInfo)) {
+                t.Stop();
+                for (const ErrorLogger::ErrorMessage &errmsg : errors)
+                    reportErr(errmsg);
+                return finishFile(filename, false);
+            }
+            mResultCache = resultCache.get();
+            mResultCache->startRecording();
+        }
+
         // Get directives
         preprocessor.setDirectives(tokens1);
         preprocessor.simplifyPragmaAsm(&tokens1);
@@ -254,6 +298,7 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
 
         Timer t("Preprocessor::getConfigs", mSettings.showtime, &S_timerResults);
         configurations = preprocessor.getConfigs(tokens1);
+        t.Stop();
 
         if (mSettings.checkConfiguration) {
             for (const std::string &config : configurations)
@@ -280,6 +325,13 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             break;
         }
 
+        // ValueFlow and the simplified token list are only computed when needed
+        const unsigned int needs = neededResults();
+
+        // peak memory of the analysis data of the configurations
+        const bool measureMemory = mSettings.maxMemory > 0 || mSettings.showtime == SHOWTIME_MEMORY;
+        MemoryUsage fileMemoryUsage;
+
         std::set<unsigned long long> checksums;
         unsigned int checkCount = 0;
         bool hasValidConfig = false;
@@ -317,6 +369,7 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             Tokenizer mTokenizer(&mSettings, this);
             if (mSettings.showtime != SHOWTIME_NONE)
                 mTokenizer.setTimerResults(&S_timerResults);
+            mTokenizer.setValueFlowEnabled((needs & Check::NEEDS_VALUEFLOW) != 0);
 
             try {
                 bool result;
@@ -328,6 +381,18 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
                 timer.Stop();
                 hasValidConfig = true;
 
+                // the simplecpp token lists are kept until the configuration is checked
+                MemoryUsage memoryUsage;
+                if (measureMemory) {
+                    memoryUsage.addSimplecpp(tokens1);
+                    for (const std::pair<const std::string, simplecpp::TokenList *> &uses : preprocessor.getTokenLists()) {
+                        if (uses.second)
+                            memoryUsage.addSimplecpp(*uses.second);
+                    }
+                    memoryUsage.addSimplecpp(tokensP);
+                    mTokenizer.setMemoryBudget(mSettings.maxMemory, memoryUsage.total());
+                }
+
                 // If only errors are printed, print filename after the check
                 if (!mSettings.quiet && (!mCurrentConfig.empty() || checkCount > 1)) {
                     std::string fixedpath = Path::simplifyPath(filename);
@@ -352,12 +417,21 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
                 if (!result)
                     continue;
 
+                std::size_t memoryUsed = 0;
+                if (measureMemory) {
+                    MemoryUsage normalMemoryUsage(memoryUsage);
+                    normalMemoryUsage.addTokens(mTokenizer.list);
+                    normalMemoryUsage.addSymbolDatabase(*mTokenizer.getSymbolDatabase());
+                    fileMemoryUsage.peak(normalMemoryUsage);
+                    memoryUsed = normalMemoryUsage.total();
+                }
+
                 // dump xml if --dump
                 if (mSettings.dump && fdump.is_open()) {
-                    fdump << "<dump cfg=\"" << ErrorLogger::toxml(mCurrentConfig) << "\">" << std::endl;
+                    fdump << "<dump cfg=\"" << ErrorLogger::toxml(mCurrentConfig) << "\">\n";
                     preprocessor.dump(fdump);
                     mTokenizer.dump(fdump);
-                    fdump << "</dump>" << std::endl;
+                    fdump << "</dump>\n";
                 }
 
                 // Skip if we already met the same simplified token list
@@ -375,7 +449,14 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
                 checkNormalTokens(mTokenizer);
 
                 // simplify more if required, skip rest of iteration if failed
-                if (mSimplify) {
+                if (mSimplify && !(needs & Check::NEEDS_SIMPLIFIED)) {
+                    // no check or rule needs it, list the step as skipped in --showtime
+                    Timer timer3("Tokenizer::simplifyTokenList2 (skipped)", mSettings.showtime, &S_timerResults);
+                } else if (mSimplify && mSettings.maxMemory > 0 && memoryUsed > mSettings.maxMemory) {
+                    // the memory budget is used up, the checks of the normal token list are done
+                    mTokenizer.memoryBudgetError("The check of the simplified token list", memoryUsed);
+                    Timer timer3("Tokenizer::simplifyTokenList2 (skipped)", mSettings.showtime, &S_timerResults);
+                } else if (mSimplify) {
                     if (!mSettings.experimentalFast) {
                         // if further simplification fails then skip rest of iteration
                         Timer timer3("Tokenizer::simplifyTokenList2", mSettings.showtime, &S_timerResults);
@@ -383,6 +464,11 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
                         timer3.Stop();
                         if (!result)
                             continue;
+                        if (measureMemory) {
+                            MemoryUsage simplifiedMemoryUsage(memoryUsage);
+                            simplifiedMemoryUsage.addTokens(mTokenizer.list);
+                            fileMemoryUsage.peak(simplifiedMemoryUsage);
+                        }
                     }
 
                     // Check simplified tokens
@@ -424,9 +510,15 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
                 }
             } catch (const std::exception& e) { // reference to the base of a polymorphic object
                 std::cout << "runCheckException: " << e.what() << std::endl; // information from length_error printed
+                mResultCache = nullptr; // the results are incomplete
             }
         }
 
+        if (mSettings.showtime == SHOWTIME_MEMORY && fileMemoryUsage.total() > 0) {
+            std::cout << "Memory of " << filename << ": " << fileMemoryUsage.toString() << std::endl;
+            S_peakMemoryUsage.peak(fileMemoryUsage);
+        }
+
         if (!hasValidConfig && configurations.size() > 1 && mSettings.isEnabled(Settings::INFORMATION)) {
             std::string msg;
             msg = "This file is not analyzed. Cppcheck failed to extract a valid configuration. Use -v for more details.";
@@ -449,7 +541,11 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
 
         // dumped all configs, close root </dumps> element now
         if (mSettings.dump && fdump.is_open())
-            fdump << "</dumps>" << std::endl;
+            fdump << "</dumps>\n";
+
+        // keep the complete results for the next run
+        if (mResultCache && !internalErrorFound && !mSettings.terminated() && !mResultCache->save())
+            mErrorLogger.reportOut("cppcheck: Failed to write the results to '" + mSettings.cacheDir + "'.");
 
     } catch (const std::runtime_error &e) {
         internalError(filename, e.what());
@@ -459,7 +555,14 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
         internalError(filename, e.errorMessage);
         mExitCode=1; // e.g. reflect a syntax error
     }
+    mResultCache = nullptr;
+
+    return finishFile(filename, internalErrorFound);
+}
 
+//----------------------------------------------------------------------------------------------------------------------------------------
+unsigned int CppCheck::finishFile(const std::string &filename, bool internalErrorFound)
+{
     // In jointSuppressionReport mode, unmatched suppressions are
     // collected after all files are processed
     if (!mSettings.jointSuppressionReport && (mSettings.isEnabled(Settings::INFORMATION) || mSettings.checkConfiguration)) {
@@ -498,6 +601,96 @@ void CppCheck::internalError(const std::string &filename, const std::string &msg
     }
 }
 
+//---------------------------------------------------------------------------
+// CppCheck - Settings that influence the results, part of the checksum of the cached results
+//---------------------------------------------------------------------------
+const std::string &CppCheck::getToolinfo()
+{
+    if (!mToolinfo.empty())
+        return mToolinfo;
+
+    std::ostringstream toolinfo;
+    toolinfo << version() << '\n'
+             << "enabled:";
+    for (int group = Settings::WARNING; group <= Settings::INTERNAL; group <<= 1)
+        toolinfo << (mSettings.isEnabled(static_cast<Settings::EnabledGroup>(group)) ? '1' : '0');
+    toolinfo << '\n'
+             << "flags:" << mSettings.inconclusive << mSettings.experimental << mSettings.experimentalFast
+             << mSettings.legacyKnownVariables << mSettings.checkLibrary << mSimplify << '\n'
+             << "output:" << mSettings.verbose << mSettings.xml << static_cast<int>(mSettings.outputFormat) << '\n'
+             << "templateLocation:" << mSettings.templateLocation << '\n'
+             << "maxConfigs:" << mSettings.maxConfigs << '\n'
+             << "maxMemory:" << mSettings.maxMemory << '\n'
+             << "platform:" << mSettings.platformString() << '\n'
+             << "project:" << Settings::projectName << '\n'
+             << "library:" << std::hex << mSettings.library.checksum() << std::dec << '\n';
+    for (const Settings::Rule &rule : mSettings.rules) {
+        toolinfo << "rule:" << rule.tokenlist << '\n' << rule.pattern << '\n' << rule.id << '\n'
+                 << rule.summary << '\n' << static_cast<int>(rule.severity) << ' ' << rule.budget << '\n';
+    }
+    toolinfo << "ruleMatchBudget:" << mSettings.ruleMatchBudget << '\n'
+             << "regexEngine:" << static_cast<int>(mSettings.regexEngine) << '\n'
+             // the global suppressions can skip the ValueFlow and the simplified token list
+             << "needs:" << neededResults() << '\n';
+    if (!mSettings.namingRuleFile.empty())
+        toolinfo << "namingRuleFile:" << mSettings.namingRuleFile << '\n' << readFileContent(mSettings.namingRuleFile) << '\n';
+
+    mToolinfo = toolinfo.str();
+    return mToolinfo;
+}
+
+//---------------------------------------------------------------------------
+// CppCheck - Optional analysis results that are needed in this run
+//---------------------------------------------------------------------------
+namespace {
+    /** Collects the ids of the errors a check can report */
+    class ErrorIdCollector : public ErrorLogger {
+    public:
+        void reportOut(const std::string & /*outmsg*/) OVERRIDE {}
+        void reportErr(const ErrorLogger::ErrorMessage &msg) OVERRIDE {
+            ids.insert(msg._id);
+        }
+        std::set<std::string> ids;
+    };
+}
+
+/** Are all errors of the check suppressed in all files, then its results are not needed */
+static bool allErrorsSuppressed(const Check &check, const Settings &settings)
+{
+    ErrorIdCollector collector;
+    check.getErrorMessages(&collector, &settings);
+    if (collector.ids.empty())
+        return false;
+    for (const std::string &id : collector.ids) {
+        if (!settings.nomsg.isSuppressedEverywhere(id))
+            return false;
+    }
+    return true;
+}
+
+unsigned int CppCheck::neededResults() const
+{
+    unsigned int needs = 0;
+
+    // the dump and the debug output contain the values
+    if (mSettings.dump || mSettings.debugnormal || mSettings.debugwarnings)
+        needs |= Check::NEEDS_VALUEFLOW;
+    if (mSettings.debugSimplified)
+        needs |= Check::NEEDS_SIMPLIFIED;
+
+    for (const Settings::Rule &rule : mSettings.rules) {
+        if (rule.tokenlist == "simple")
+            needs |= Check::NEEDS_SIMPLIFIED;
+    }
+
+    for (const Check *check : Check::instances()) {
+        if (!allErrorsSuppressed(*check, mSettings))
+            needs |= check->neededResults(&mSettings);
+    }
+
+    return needs;
+}
+
 //---------------------------------------------------------------------------
 // CppCheck - A function that checks a raw token list
 //---------------------------------------------------------------------------
@@ -530,12 +723,16 @@ void CppCheck::checkNormalTokens(const Tokenizer &tokenizer)
     CTU::FileInfo *fi1 = CTU::getFileInfo(&tokenizer);
     if (fi1) {
         mFileInfo.push_back(fi1);
+        if (mResultCache)
+            mResultCache->addFileInfo("ctu", fi1);
     }
 
     for (const Check *check : Check::instances()) {
         Check::FileInfo *fi = check->getFileInfo(&tokenizer, &mSettings);
         if (fi != nullptr) {
             mFileInfo.push_back(fi);
+            if (mResultCache)
+                mResultCache->addFileInfo(check->name(), fi);
         }
     }
 
@@ -571,6 +768,8 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
   (void)tokenlist;
   (void)tokenizer;
 
+  Timer timerRules("CppCheck::executeRules::" + tokenlist, mSettings.showtime, &S_timerResults);
+
   // Step 1:
   // Are there rules to execute?
   // check if some rule exist, performance , otherwise is unnecessary genereated source from tokenize in next step.
@@ -643,15 +842,44 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
     // do regExp
     try
     { 
-      std::regex r(rule.pattern.c_str());
-      std::smatch match;
-    
-      unsigned int lastPos = 0;
-    
-      while (regex_search(str, match, r))
+      std::shared_ptr<const Regex> &r = mRuleRegex[rule.pattern];
+      if (!r)
+        r = Regex::create(rule.pattern, mSettings.regexEngine);
+
+      if ( mSettings.verbose )
+        mErrorLogger.reportOut("regex engine:" + std::string(r->engineName()));
+
+      const unsigned long long ruleBudget = rule.budget ? rule.budget : mSettings.ruleMatchBudget;
+      unsigned long long budget = ruleBudget;
+      unsigned long long *budgetPtr = ruleBudget ? &budget : nullptr;
+
+      // std::regex can't be stopped, without the budget the rule could take forever
+      if (budgetPtr && !r->countsBudget())
+      {
+        const ErrorLogger::ErrorMessage errmsg(std::list<ErrorLogger::ErrorMessage::FileLocation>(),
+          emptyString,
+          Severity::error,
+          "Match budget of " + MathLib::toString(ruleBudget) + " can not be applied, the pattern is matched with std::regex. The rule is skipped. ID: " + rule.id + std::string(", Pattern: ") + rule.pattern,
+          "ruleCheck_budgetUnsupported",
+          false);
+
+        reportErr(errmsg);
+        continue;
+      }
+
+      std::size_t lastPos = 0;
+      std::size_t start = 0;
+      std::size_t matchPos, matchLength;
+
+      // the matches are found in ascending order, the location search continues at the last location
+      const Token *locTok = tokenizer.tokens();
+      std::size_t len = 0;
+
+      Regex::Result result;
+      while ((result = r->search(str, start, &matchPos, &matchLength, budgetPtr)) == Regex::MATCH)
       {
         /// @todo calculate correct line position
-        const unsigned int pos1 = match.position(0) + 1;
+        const std::size_t pos1 = matchPos - start + 1;
         lastPos += pos1;
     
         // determine location..
@@ -659,22 +887,22 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
         loc.setfile(tokenizer.list.getSourceFilePath());
         loc.line = 0;
     
-        std::size_t len = 0;
-        for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
-          len = len + 1U + tok->str().size();
-          if (len > lastPos) {
-            loc.setfile(tokenizer.list.getFiles().at(tok->fileIndex()));
-            loc.line = tok->linenr();
+        for (; locTok; locTok = locTok->next()) {
+          if (len + 1U + locTok->str().size() > lastPos) {
+            loc.setfile(tokenizer.list.getFiles().at(locTok->fileIndex()));
+            loc.line = locTok->linenr();
             break;
           }
+          len = len + 1U + locTok->str().size();
         }
     
         const std::list<ErrorLogger::ErrorMessage::FileLocation> callStack(1, loc);
     
         // Create error message
-        std::string summary = "$symbol:" + match.str() + "\n";
+        const std::string matchStr = str.substr(matchPos, matchLength);
+        std::string summary = "$symbol:" + matchStr + "\n";
         if (rule.summary.empty())
-          summary += "found '" + std::string(match.str()) + "'";
+          summary += "found '" + matchStr + "'";
         else
           summary += rule.summary;
 
@@ -684,8 +912,28 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
         reportErr(errmsg);
     
         // start again
-        lastPos += match.length();
-        str = match.suffix();  
+        lastPos += matchLength;
+        start = matchPos + matchLength;
+
+        // an empty match would be found again and again
+        if (matchLength == 0) {
+          if (start >= str.size())
+            break;
+          ++start;
+          ++lastPos;
+        }
+      }
+
+      if (result == Regex::BUDGET_EXCEEDED)
+      {
+        const ErrorLogger::ErrorMessage errmsg(std::list<ErrorLogger::ErrorMessage::FileLocation>(),
+          emptyString,
+          Severity::error,
+          "Match budget of " + MathLib::toString(ruleBudget) + " exceeded. ID: " + rule.id + std::string(", Pattern: ") + rule.pattern,
+          "ruleCheck_budgetExceeded",
+          false);
+
+        reportErr(errmsg);
       }
     }
     catch (const std::regex_error& e)
@@ -738,6 +986,10 @@ void CppCheck::reportErr(const ErrorLogger::ErrorMessage &msg)
 {
     mSuppressInternalErrorFound = false;
 
+    // the suppressions are applied again when the cached results are used
+    if (mResultCache)
+        mResultCache->addError(msg);
+
     if (!mSettings.library.reportErrors(msg.file0))
         return;
 
@@ -752,7 +1004,7 @@ void CppCheck::reportErr(const ErrorLogger::ErrorMessage &msg)
     errmsgUnique = errmsg;
 
     // Alert only about unique errors
-    if (std::find(mErrorList.begin(), mErrorList.end(), errmsgUnique) != mErrorList.end())
+    if (mErrorList.find(errmsgUnique) != mErrorList.end())
         return;
 
     const Suppressions::ErrorMessage errorMessage = msg.toSuppressionsErrorMessage();
@@ -772,8 +1024,9 @@ void CppCheck::reportErr(const ErrorLogger::ErrorMessage &msg)
     if (!mSettings.nofail.isSuppressed(errorMessage) && (mUseGlobalSuppressions || !mSettings.nomsg.isSuppressed(errorMessage)))
         mExitCode = 1;
 
-    mErrorList.push_back(errmsg);
+    mErrorList.insert(errmsg);
 
+    Timer timerReport("ErrorLogger::reportErr", mSettings.showtime, &S_timerResults);
     mErrorLogger.reportErr(msg);
 }
 
@@ -815,15 +1068,27 @@ void CppCheck::getErrorMessages()
         (*it)->getErrorMessages(this, &s);
 
     Preprocessor::getErrorMessages(this, &s);
+    Tokenizer::getErrorMessages(this, &s);
 }
 
 bool CppCheck::analyseWholeProgram()
 {
+    Timer timer("CppCheck::analyseWholeProgram", mSettings.showtime, &S_timerResults);
     bool errors = false;
     // Init CTU
     CTU::maxCtuDepth = mSettings.maxCtuDepth;
     // Analyse the tokens
     CTU::FileInfo ctu;
+    std::size_t functionCallCount = 0, nestedCallCount = 0;
+    for (const Check::FileInfo *fi : mFileInfo) {
+        const CTU::FileInfo *fi2 = dynamic_cast<const CTU::FileInfo *>(fi);
+        if (fi2) {
+            functionCallCount += fi2->functionCalls.size();
+            nestedCallCount += fi2->nestedCalls.size();
+        }
+    }
+    ctu.functionCalls.reserve(functionCallCount);
+    ctu.nestedCalls.reserve(nestedCallCount);
     for (const Check::FileInfo *fi : mFileInfo) {
         const CTU::FileInfo *fi2 = dynamic_cast<const CTU::FileInfo *>(fi);
         if (fi2) {
@@ -11,11 +11,14 @@
 #include "settings.h"
 
 #include <cstddef>
-#include <istream>
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_set>
 
+class ResultCache;
+class TimerResults;
 class Tokenizer;
 
 /// @addtogroup Core
@@ -89,6 +92,12 @@ public:
      */
     static const char * extraVersion();
 
+    /**
+     * @brief The times of the phases of all checked files, they are
+     * collected when Settings::showtime is set. Used by the benchmarks.
+     */
+    static TimerResults &timerResults();
+
     virtual void reportStatus(unsigned int fileindex, unsigned int filecount, std::size_t sizedone, std::size_t sizetotal);
 
     /**
@@ -124,19 +133,38 @@ public:
 
 private:
 
-    size_t getCountOfLines(std::istream &is);
-
     /** @brief There has been an internal error => Report information message */
     void internalError(const std::string &filename, const std::string &msg);
 
     /**
-     * @brief Check a file using stream
+     * @brief Check a file using its content
      * @param filename file name
      * @param cfgname  cfg name
-     * @param fileStream stream the file content can be read from
+     * @param content file content, it is tokenized without copying it
      * @return number of errors found
      */
-    unsigned int checkFile(const std::string& filename, const std::string &cfgname, std::istream& fileStream);
+    unsigned int checkFile(const std::string& filename, const std::string &cfgname, const std::string &content);
+
+    /**
+     * @brief Report the unmatched suppressions of the checked file and reset
+     * the state for the next file
+     * @param filename file name
+     * @param internalErrorFound was there an internal error?
+     * @return exit code
+     */
+    unsigned int finishFile(const std::string& filename, bool internalErrorFound);
+
+    /**
+     * @brief Settings and libraries that influence the results, the checksum
+     * of the cached results (--cache-dir) is calculated with them
+     */
+    const std::string &getToolinfo();
+
+    /**
+     * @brief Optional analysis results needed by the checks, rules and output options
+     * @return bitmask of Check::Needs
+     */
+    unsigned int neededResults() const;
 
     /**
      * @brief Check raw tokens
@@ -179,7 +207,8 @@ private:
      */
     virtual void reportOut(const std::string &outmsg) OVERRIDE;
 
-    std::list<std::string> mErrorList;
+    /** the reported messages of the current file, for the lookup of duplicates */
+    std::unordered_set<std::string> mErrorList;
     Settings mSettings;
 
     void reportProgress(const std::string &filename, const char stage[], const std::size_t value) OVERRIDE;
@@ -205,6 +234,18 @@ private:
 
     /** File info used for whole program analysis */
     std::list<Check::FileInfo*> mFileInfo;
+
+    /** Compiled rule patterns, by pattern */
+    std::map<std::string, std::shared_ptr<const Regex>> mRuleRegex;
+
+    /** Are the naming rules of mSettings loaded */
+    bool mNamingRulesLoaded;
+
+    /** Results of the checked file are recorded here when --cache-dir is used */
+    ResultCache *mResultCache;
+
+    /** See getToolinfo() */
+    std::string mToolinfo;
 };
 
 /// @}
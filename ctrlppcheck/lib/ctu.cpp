@@ -71,10 +71,10 @@ std::string CTU::FileInfo::toString() const
 std::string CTU::FileInfo::CallBase::toBaseXmlString() const
 {
     std::ostringstream out;
-    out << " " << ATTR_CALL_ID << "=\"" << callId << "\""
-        << " " << ATTR_CALL_FUNCNAME << "=\"" << callFunctionName << "\""
+    out << " " << ATTR_CALL_ID << "=\"" << ErrorLogger::escapeXml(callId) << "\""
+        << " " << ATTR_CALL_FUNCNAME << "=\"" << ErrorLogger::escapeXml(callFunctionName) << "\""
         << " " << ATTR_CALL_ARGNR << "=\"" << callArgNr << "\""
-        << " " << ATTR_LOC_FILENAME << "=\"" << location.fileName << "\""
+        << " " << ATTR_LOC_FILENAME << "=\"" << ErrorLogger::escapeXml(location.fileName) << "\""
         << " " << ATTR_LOC_LINENR << "=\"" << location.linenr << "\"";
     return out.str();
 }
@@ -84,7 +84,7 @@ std::string CTU::FileInfo::FunctionCall::toXmlString() const
     std::ostringstream out;
     out << "<function-call"
         << toBaseXmlString()
-        << " " << ATTR_CALL_ARGEXPR << "=\"" << callArgumentExpression << "\""
+        << " " << ATTR_CALL_ARGEXPR << "=\"" << ErrorLogger::escapeXml(callArgumentExpression) << "\""
         << " " << ATTR_CALL_ARGVALUETYPE << "=\"" << callValueType << "\""
         << " " << ATTR_CALL_ARGVALUE << "=\"" << callArgValue << "\"";
     if (warning)
@@ -95,9 +95,9 @@ std::string CTU::FileInfo::FunctionCall::toXmlString() const
         out << ">\n";
         for (const ErrorLogger::ErrorMessage::FileLocation &loc : callValuePath)
             out << "  <path"
-                << " " << ATTR_LOC_FILENAME << "=\"" << loc.getfile() << "\""
+                << " " << ATTR_LOC_FILENAME << "=\"" << ErrorLogger::escapeXml(loc.getfile(false)) << "\""
                 << " " << ATTR_LOC_LINENR << "=\"" << loc.line << "\""
-                << " " << ATTR_INFO << "=\"" << loc.getinfo() << "\"/>\n";
+                << " " << ATTR_INFO << "=\"" << ErrorLogger::escapeXml(loc.getinfo()) << "\"/>\n";
         out << "</function-call>";
     }
     return out.str();
@@ -106,9 +106,9 @@ std::string CTU::FileInfo::FunctionCall::toXmlString() const
 std::string CTU::FileInfo::NestedCall::toXmlString() const
 {
     std::ostringstream out;
-    out << "<function-call"
+    out << "<nested-call"
         << toBaseXmlString()
-        << " " << ATTR_MY_ID << "=\"" << myId << "\""
+        << " " << ATTR_MY_ID << "=\"" << ErrorLogger::escapeXml(myId) << "\""
         << " " << ATTR_MY_ARGNR << "=\"" << myArgNr << "\""
         << "/>";
     return out.str();
@@ -118,10 +118,10 @@ std::string CTU::FileInfo::UnsafeUsage::toString() const
 {
     std::ostringstream out;
     out << "    <unsafe-usage"
-        << " " << ATTR_MY_ID << "=\"" << myId << '\"'
+        << " " << ATTR_MY_ID << "=\"" << ErrorLogger::escapeXml(myId) << '\"'
         << " " << ATTR_MY_ARGNR << "=\"" << myArgNr << '\"'
-        << " " << ATTR_MY_ARGNAME << "=\"" << myArgumentName << '\"'
-        << " " << ATTR_LOC_FILENAME << "=\"" << location.fileName << '\"'
+        << " " << ATTR_MY_ARGNAME << "=\"" << ErrorLogger::escapeXml(myArgumentName) << '\"'
+        << " " << ATTR_LOC_FILENAME << "=\"" << ErrorLogger::escapeXml(location.fileName) << '\"'
         << " " << ATTR_LOC_LINENR << "=\"" << location.linenr << '\"'
         << "/>\n";
     return out.str();
@@ -163,7 +163,7 @@ static long long readAttrInt(const tinyxml2::XMLElement *e, const char *attr, bo
     const char *value = e->Attribute(attr);
     if (!value && error)
         *error = true;
-    return value ? std::atoi(value) : 0;
+    return value ? std::atoll(value) : 0;
 }
 
 bool CTU::FileInfo::CallBase::loadBaseFromXml(const tinyxml2::XMLElement *e)
@@ -194,6 +194,7 @@ bool CTU::FileInfo::FunctionCall::loadFromXml(const tinyxml2::XMLElement *e)
         loc.setfile(readAttrString(e2, ATTR_LOC_FILENAME, &error));
         loc.line = readAttrInt(e2, ATTR_LOC_LINENR, &error);
         loc.setinfo(readAttrString(e2, ATTR_INFO, &error));
+        callValuePath.push_back(loc);
     }
     return !error;
 }
@@ -223,16 +224,70 @@ void CTU::FileInfo::loadFromXml(const tinyxml2::XMLElement *xmlElement)
     }
 }
 
-std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> CTU::FileInfo::getCallsMap() const
+CTU::FileInfo::CallsMap::CallsMap(const FileInfo &fileInfo)
+{
+    // the nested calls are searched before the function calls
+    mCalls.reserve(fileInfo.nestedCalls.size() + fileInfo.functionCalls.size());
+    for (const CTU::FileInfo::NestedCall &nc : fileInfo.nestedCalls) {
+        const Call call = { nullptr, &nc };
+        mCalls[Key{nc.callId, nc.callArgNr}].calls.push_back(call);
+    }
+    for (const CTU::FileInfo::FunctionCall &fc : fileInfo.functionCalls) {
+        const Call call = { &fc, nullptr };
+        mCalls[Key{fc.callId, fc.callArgNr}].calls.push_back(call);
+    }
+}
+
+const CTU::FileInfo::CallBase *CTU::FileInfo::CallsMap::findPath(const std::string &callId, int callArgNr, InvalidValueType invalidValue, int index, bool warning) const
 {
-    std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> ret;
-    for (const CTU::FileInfo::NestedCall &nc : nestedCalls)
-        ret[nc.callId].push_back(&nc);
-    for (const CTU::FileInfo::FunctionCall &fc : functionCalls)
-        ret[fc.callId].push_back(&fc);
+    if (index >= CTU::maxCtuDepth || index >= MAX_DEPTH)
+        return nullptr;
+
+    const std::unordered_map<Key, Calls, KeyHash>::const_iterator it = mCalls.find(Key{callId, callArgNr});
+    if (it == mCalls.end())
+        return nullptr;
+
+    const Calls &calls = it->second;
+    const int valueIndex = (invalidValue == InvalidValueType::null) ? 0 : 1;
+    if (calls.memoKnown[valueIndex][warning][index])
+        return calls.memoPath[valueIndex][warning][index];
+
+    const CallBase *ret = nullptr;
+    for (const Call &c : calls.calls) {
+        const CTU::FileInfo::FunctionCall *functionCall = c.functionCall;
+        if (functionCall) {
+            if (!warning && functionCall->warning)
+                continue;
+            switch (invalidValue) {
+            case CTU::FileInfo::InvalidValueType::null:
+                if (functionCall->callValueType != ValueFlow::Value::INT || functionCall->callArgValue != 0)
+                    continue;
+                break;
+            case CTU::FileInfo::InvalidValueType::uninit:
+                if (functionCall->callValueType != ValueFlow::Value::UNINIT)
+                    continue;
+                break;
+            };
+            ret = functionCall;
+            break;
+        }
+
+        if (findPath(c.nestedCall->myId, static_cast<int>(c.nestedCall->myArgNr), invalidValue, index + 1, warning)) {
+            ret = c.nestedCall;
+            break;
+        }
+    }
+
+    calls.memoKnown[valueIndex][warning][index] = true;
+    calls.memoPath[valueIndex][warning][index] = ret;
     return ret;
 }
 
+CTU::FileInfo::CallsMap CTU::FileInfo::getCallsMap() const
+{
+    return CallsMap(*this);
+}
+
 std::list<CTU::FileInfo::UnsafeUsage> CTU::loadUnsafeUsageListFromXml(const tinyxml2::XMLElement *xmlElement)
 {
     std::list<CTU::FileInfo::UnsafeUsage> ret;
@@ -375,69 +430,25 @@ std::list<CTU::FileInfo::UnsafeUsage> CTU::getUnsafeUsage(const Tokenizer *token
     return unsafeUsage;
 }
 
-static bool findPath(const std::string &callId,
-                     unsigned int callArgNr,
-                     CTU::FileInfo::InvalidValueType invalidValue,
-                     const std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> &callsMap,
-                     const CTU::FileInfo::CallBase *path[10],
-                     int index,
-                     bool warning)
-{
-    if (index >= CTU::maxCtuDepth || index >= 10)
-        return false;
-
-    const std::map<std::string, std::list<const CTU::FileInfo::CallBase *>>::const_iterator it = callsMap.find(callId);
-    if (it == callsMap.end())
-        return false;
-
-    for (const CTU::FileInfo::CallBase *c : it->second) {
-        if (c->callArgNr != callArgNr)
-            continue;
-
-        const CTU::FileInfo::FunctionCall *functionCall = dynamic_cast<const CTU::FileInfo::FunctionCall *>(c);
-        if (functionCall) {
-            if (!warning && functionCall->warning)
-                continue;
-            switch (invalidValue) {
-            case CTU::FileInfo::InvalidValueType::null:
-                if (functionCall->callValueType != ValueFlow::Value::INT || functionCall->callArgValue != 0)
-                    continue;
-                break;
-            case CTU::FileInfo::InvalidValueType::uninit:
-                if (functionCall->callValueType != ValueFlow::Value::UNINIT)
-                    continue;
-                break;
-            };
-            path[index] = functionCall;
-            return true;
-        }
-
-        const CTU::FileInfo::NestedCall *nestedCall = dynamic_cast<const CTU::FileInfo::NestedCall *>(c);
-        if (!nestedCall)
-            continue;
-
-        if (findPath(nestedCall->myId, nestedCall->myArgNr, invalidValue, callsMap, path, index + 1, warning)) {
-            path[index] = nestedCall;
-            return true;
-        }
-    }
-
-    return false;
-}
-
 std::list<ErrorLogger::ErrorMessage::FileLocation> CTU::FileInfo::getErrorPath(InvalidValueType invalidValue,
         const CTU::FileInfo::UnsafeUsage &unsafeUsage,
-        const std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> &callsMap,
+        const CallsMap &callsMap,
         const char info[],
         const FunctionCall * * const functionCallPtr,
         bool warning) const
 {
     std::list<ErrorLogger::ErrorMessage::FileLocation> locationList;
 
+    // follow the memoized steps from the unsafe usage to the call with the invalid value
     const CTU::FileInfo::CallBase *path[10] = {0};
-
-    if (!findPath(unsafeUsage.myId, unsafeUsage.myArgNr, invalidValue, callsMap, path, 0, warning))
+    const CTU::FileInfo::CallBase *step = callsMap.findPath(unsafeUsage.myId, static_cast<int>(unsafeUsage.myArgNr), invalidValue, 0, warning);
+    if (!step)
         return locationList;
+    for (int index = 0; step && index < 10; ++index) {
+        path[index] = step;
+        const CTU::FileInfo::NestedCall *nestedCall = dynamic_cast<const CTU::FileInfo::NestedCall *>(step);
+        step = nestedCall ? callsMap.findPath(nestedCall->myId, static_cast<int>(nestedCall->myArgNr), invalidValue, index + 1, warning) : nullptr;
+    }
 
     const std::string value1 = (invalidValue == InvalidValueType::null) ? "null" : "uninitialized";
 
@@ -25,6 +25,13 @@
 #include "check.h"
 #include "valueflow.h"
 
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 /// @addtogroup Core
 /// @{
 
@@ -103,15 +110,68 @@ namespace CTU {
             unsigned int myArgNr;
         };
 
-        std::list<FunctionCall> functionCalls;
-        std::list<NestedCall> nestedCalls;
+        std::vector<FunctionCall> functionCalls;
+        std::vector<NestedCall> nestedCalls;
+
+        /**
+         * Calls of the whole program indexed by the called function and
+         * argument. The path searches are memoized, so the shared parts of the
+         * call chains are only explored once for all unsafe usages.
+         */
+        class CPPCHECKLIB CallsMap {
+        public:
+            explicit CallsMap(const FileInfo &fileInfo);
+
+            /**
+             * First step of the path from the function argument to a call
+             * with an invalid value, nullptr if there is no such path.
+             * @param callId called function
+             * @param callArgNr argument number
+             * @param invalidValue invalid value to search
+             * @param index depth of the step, limited by maxCtuDepth
+             * @param warning also use calls that are only warnings
+             */
+            const CallBase *findPath(const std::string &callId, int callArgNr, InvalidValueType invalidValue, int index, bool warning) const;
+
+        private:
+            enum { MAX_DEPTH = 10 };
+
+            struct Call {
+                const FunctionCall *functionCall;
+                const NestedCall *nestedCall;
+            };
+
+            struct Calls {
+                Calls() : memoKnown() {}
+                std::vector<Call> calls;
+                /** memoized findPath() results [invalidValue][warning][index] */
+                mutable const CallBase *memoPath[2][2][MAX_DEPTH];
+                mutable bool memoKnown[2][2][MAX_DEPTH];
+            };
+
+            struct Key {
+                std::string callId;
+                int callArgNr;
+                bool operator==(const Key &other) const {
+                    return callArgNr == other.callArgNr && callId == other.callId;
+                }
+            };
+
+            struct KeyHash {
+                std::size_t operator()(const Key &key) const {
+                    return std::hash<std::string>()(key.callId) ^ (static_cast<std::size_t>(key.callArgNr) * 0x9e3779b9U);
+                }
+            };
+
+            std::unordered_map<Key, Calls, KeyHash> mCalls;
+        };
 
         void loadFromXml(const tinyxml2::XMLElement *xmlElement);
-        std::map<std::string, std::list<const CallBase *>> getCallsMap() const;
+        CallsMap getCallsMap() const;
 
         std::list<ErrorLogger::ErrorMessage::FileLocation> getErrorPath(InvalidValueType invalidValue,
                 const UnsafeUsage &unsafeUsage,
-                const std::map<std::string, std::list<const CallBase *>> &callsMap,
+                const CallsMap &callsMap,
                 const char info[],
                 const FunctionCall * * const functionCallPtr,
                 bool warning) const;
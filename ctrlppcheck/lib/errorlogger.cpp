@@ -27,12 +27,15 @@
 #include "settings.h"
 
 #include <tinyxml2.h>
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cctype>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <iomanip>
+#include <iterator>
 
 InternalError::InternalError(const Token *tok, const std::string &errorMsg, Type type) :
     token(tok), errorMessage(errorMsg), type(type)
@@ -218,6 +221,87 @@ Suppressions::ErrorMessage ErrorLogger::ErrorMessage::toSuppressionsErrorMessage
     return ret;
 }
 
+static void serializeField(std::ostringstream &oss, const std::string &field)
+{
+    oss << field.length() << ' ' << field;
+}
+
+static bool deserializeField(const std::string &data, std::string::size_type &pos, std::string &field)
+{
+    const std::string::size_type sep = data.find(' ', pos);
+    if (sep == std::string::npos || sep == pos)
+        return false;
+    std::string::size_type len = 0;
+    for (std::string::size_type i = pos; i < sep; ++i) {
+        if (!std::isdigit(static_cast<unsigned char>(data[i])))
+            return false;
+        len = len * 10 + (data[i] - '0');
+    }
+    if (len > data.size() - sep - 1)
+        return false;
+    field = data.substr(sep + 1, len);
+    pos = sep + 1 + len;
+    return true;
+}
+
+std::string ErrorLogger::ErrorMessage::serialize() const
+{
+    std::ostringstream oss;
+    serializeField(oss, _id);
+    serializeField(oss, Severity::toString(_severity));
+    serializeField(oss, MathLib::toString(_cwe.id));
+    serializeField(oss, _inconclusive ? "1" : "0");
+    serializeField(oss, file0);
+    serializeField(oss, mShortMessage);
+    serializeField(oss, mVerboseMessage);
+    serializeField(oss, mSymbolNames);
+    serializeField(oss, MathLib::toString(_callStack.size()));
+    for (const FileLocation &loc : _callStack) {
+        serializeField(oss, MathLib::toString(loc.fileIndex));
+        serializeField(oss, MathLib::toString(loc.line));
+        serializeField(oss, MathLib::toString(loc.col));
+        serializeField(oss, loc.getOrigFile(false));
+        serializeField(oss, loc.getfile(false));
+        serializeField(oss, loc.getinfo());
+    }
+    return oss.str();
+}
+
+bool ErrorLogger::ErrorMessage::deserialize(const std::string &data)
+{
+    std::string::size_type pos = 0;
+    std::string fields[9];
+    for (std::string &field : fields) {
+        if (!deserializeField(data, pos, field))
+            return false;
+    }
+
+    _id = fields[0];
+    _severity = Severity::fromString(fields[1]);
+    _cwe.id = static_cast<unsigned short>(std::atoi(fields[2].c_str()));
+    _inconclusive = fields[3] == "1";
+    file0 = fields[4];
+    mShortMessage = fields[5];
+    mVerboseMessage = fields[6];
+    mSymbolNames = fields[7];
+
+    _callStack.clear();
+    for (unsigned long count = std::strtoul(fields[8].c_str(), nullptr, 10); count > 0; --count) {
+        std::string loc[6];
+        for (std::string &field : loc) {
+            if (!deserializeField(data, pos, field))
+                return false;
+        }
+        FileLocation fileLocation(loc[3], loc[5], std::atoi(loc[1].c_str()));
+        fileLocation.fileIndex = static_cast<unsigned int>(std::strtoul(loc[0].c_str(), nullptr, 10));
+        fileLocation.col = static_cast<unsigned int>(std::strtoul(loc[2].c_str(), nullptr, 10));
+        if (loc[4] != loc[3])
+            fileLocation.setfile(loc[4]);
+        _callStack.push_back(fileLocation);
+    }
+    return pos == data.size();
+}
+
 std::string ErrorLogger::ErrorMessage::getXMLHeader()
 {
     // xml_version 1 is the default xml format
@@ -307,6 +391,261 @@ std::string ErrorLogger::ErrorMessage::toXML() const
     return printer.CStr();
 }
 
+/** Length of the valid UTF-8 sequence that starts at str[pos], 0 if the bytes are no valid UTF-8 */
+static std::size_t utf8SequenceLength(const std::string &str, std::string::size_type pos)
+{
+    const unsigned char first = static_cast<unsigned char>(str[pos]);
+    std::size_t length;
+    unsigned int codePoint;
+    if (first >= 0xc2 && first <= 0xdf) {
+        length = 2;
+        codePoint = first & 0x1fU;
+    } else if (first >= 0xe0 && first <= 0xef) {
+        length = 3;
+        codePoint = first & 0x0fU;
+    } else if (first >= 0xf0 && first <= 0xf4) {
+        length = 4;
+        codePoint = first & 0x07U;
+    } else {
+        return 0;
+    }
+    if (pos + length > str.size())
+        return 0;
+    for (std::size_t i = 1; i < length; ++i) {
+        const unsigned char c = static_cast<unsigned char>(str[pos + i]);
+        if ((c & 0xc0U) != 0x80U)
+            return 0;
+        codePoint = (codePoint << 6) | (c & 0x3fU);
+    }
+    // overlong encodings, surrogates and code points above U+10FFFF
+    if (length == 3 && (codePoint < 0x800U || (codePoint >= 0xd800U && codePoint <= 0xdfffU)))
+        return 0;
+    if (length == 4 && (codePoint < 0x10000U || codePoint > 0x10ffffU))
+        return 0;
+    return length;
+}
+
+/**
+ * Append a JSON string literal. With fixInvalid the not printable characters are
+ * written like fixInvalidChars() does, otherwise the control characters are
+ * escaped. Valid UTF-8 is kept, other bytes (e.g. ISO-8859-1 file names) are
+ * written as the \u00XX code point of the byte.
+ */
+static void appendJSONString(std::string &out, const std::string &str, bool fixInvalid)
+{
+    static const char hex[] = "0123456789abcdef";
+    out += '\"';
+    for (std::string::size_type i = 0; i < str.size(); ++i) {
+        const char c = str[i];
+        const unsigned char uc = static_cast<unsigned char>(c);
+        if (c == '\"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (fixInvalid && !std::isprint(uc)) {
+            out += "\\\\";
+            out += static_cast<char>('0' + ((uc >> 6) & 7));
+            out += static_cast<char>('0' + ((uc >> 3) & 7));
+            out += static_cast<char>('0' + (uc & 7));
+        } else if (uc >= 0x80) {
+            const std::size_t length = utf8SequenceLength(str, i);
+            if (length > 0) {
+                out.append(str, i, length);
+                i += length - 1;
+            } else {
+                out += "\\u00";
+                out += hex[uc >> 4];
+                out += hex[uc & 0xf];
+            }
+        } else if (uc < 0x20) {
+            out += "\\u00";
+            out += hex[uc >> 4];
+            out += hex[uc & 0xf];
+        } else {
+            out += c;
+        }
+    }
+    out += '\"';
+}
+
+/**
+ * SARIF artifact URI of a file. An absolute path is a file: URI, a relative
+ * path a relative reference. The separators are '/', other characters than
+ * letters, digits, "-._~" and '/' are percent-encoded.
+ */
+static std::string toFileURI(const std::string &fileName)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    const std::string path = Path::fromNativeSeparators(fileName);
+    std::string uri;
+    std::string::size_type pos = 0;
+    if (path.compare(0, 2, "//") == 0) {
+        // UNC path, //server/share/...
+        uri = "file:";
+    } else if (path.size() >= 2 && std::isalpha(static_cast<unsigned char>(path[0])) && path[1] == ':') {
+        uri = "file:///";
+        uri += path.substr(0, 2);
+        pos = 2;
+    } else if (!path.empty() && path[0] == '/') {
+        uri = "file://";
+    }
+    for (; pos < path.size(); ++pos) {
+        const unsigned char c = static_cast<unsigned char>(path[pos]);
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+            c == '-' || c == '.' || c == '_' || c == '~' || c == '/') {
+            uri += static_cast<char>(c);
+        } else {
+            uri += '%';
+            uri += hex[c >> 4];
+            uri += hex[c & 0xf];
+        }
+    }
+    return uri;
+}
+
+static void appendJSONNumber(std::string &out, long long value)
+{
+    char buf[24];
+    const int n = std::snprintf(buf, sizeof(buf), "%lld", value);
+    out.append(buf, n > 0 ? static_cast<std::size_t>(n) : 0U);
+}
+
+void ErrorLogger::ErrorMessage::appendJSON(std::string &out) const
+{
+    out += "{\"id\":";
+    appendJSONString(out, _id, false);
+    out += ",\"severity\":";
+    appendJSONString(out, Severity::toString(_severity), false);
+    out += ",\"msg\":";
+    appendJSONString(out, mShortMessage, true);
+    out += ",\"verbose\":";
+    appendJSONString(out, mVerboseMessage, true);
+    if (_cwe.id) {
+        out += ",\"cwe\":";
+        appendJSONNumber(out, _cwe.id);
+    }
+    if (_inconclusive)
+        out += ",\"inconclusive\":true";
+
+    out += ",\"locations\":[";
+    for (std::list<FileLocation>::const_reverse_iterator it = _callStack.rbegin(); it != _callStack.rend(); ++it) {
+        if (it != _callStack.rbegin())
+            out += ',';
+        const std::string file = it->getfile();
+        out += '{';
+        if (!file0.empty() && file != file0) {
+            out += "\"file0\":";
+            appendJSONString(out, Path::toNativeSeparators(file0), false);
+            out += ',';
+        }
+        out += "\"file\":";
+        appendJSONString(out, file, false);
+        out += ",\"line\":";
+        appendJSONNumber(out, std::max(it->line, 0));
+        if (!it->getinfo().empty()) {
+            out += ",\"info\":";
+            appendJSONString(out, it->getinfo(), true);
+        }
+        out += '}';
+    }
+    out += ']';
+
+    if (!mSymbolNames.empty()) {
+        out += ",\"symbols\":[";
+        for (std::string::size_type pos = 0; pos < mSymbolNames.size();) {
+            std::string::size_type pos2 = mSymbolNames.find('\n', pos);
+            if (pos2 == std::string::npos)
+                pos2 = mSymbolNames.size();
+            if (pos > 0)
+                out += ',';
+            appendJSONString(out, mSymbolNames.substr(pos, pos2 - pos), false);
+            pos = pos2 + 1;
+        }
+        out += ']';
+    }
+    out += '}';
+}
+
+/** SARIF physicalLocation of a location in the call stack */
+static void appendSARIFLocation(std::string &out, const ErrorLogger::ErrorMessage::FileLocation &loc)
+{
+    out += "{\"physicalLocation\":{\"artifactLocation\":{\"uri\":";
+    appendJSONString(out, toFileURI(loc.getfile(false)), false);
+    out += '}';
+    if (loc.line > 0) {
+        out += ",\"region\":{\"startLine\":";
+        appendJSONNumber(out, loc.line);
+        out += '}';
+    }
+    out += '}';
+    if (!loc.getinfo().empty()) {
+        out += ",\"message\":{\"text\":";
+        appendJSONString(out, loc.getinfo(), true);
+        out += '}';
+    }
+    out += '}';
+}
+
+void ErrorLogger::ErrorMessage::appendSARIF(std::string &out) const
+{
+    out += "{\"ruleId\":";
+    appendJSONString(out, _id, false);
+    out += ",\"level\":";
+    switch (_severity) {
+    case Severity::error:
+        out += "\"error\"";
+        break;
+    case Severity::warning:
+        out += "\"warning\"";
+        break;
+    default:
+        out += "\"note\"";
+        break;
+    }
+    out += ",\"message\":{\"text\":";
+    appendJSONString(out, mVerboseMessage, true);
+    out += '}';
+
+    // the reported location is the last one in the call stack
+    if (!_callStack.empty()) {
+        out += ",\"locations\":[";
+        appendSARIFLocation(out, _callStack.back());
+        out += ']';
+    }
+    if (_callStack.size() > 1) {
+        out += ",\"relatedLocations\":[";
+        for (std::list<FileLocation>::const_iterator it = _callStack.begin(); it != std::prev(_callStack.end()); ++it) {
+            if (it != _callStack.begin())
+                out += ',';
+            appendSARIFLocation(out, *it);
+        }
+        out += ']';
+    }
+
+    out += ",\"properties\":{\"severity\":";
+    appendJSONString(out, Severity::toString(_severity), false);
+    if (_cwe.id) {
+        out += ",\"cwe\":";
+        appendJSONNumber(out, _cwe.id);
+    }
+    if (_inconclusive)
+        out += ",\"inconclusive\":true";
+    out += "}}";
+}
+
+std::string ErrorLogger::ErrorMessage::getSARIFHeader()
+{
+    std::string header = "{\"version\":\"2.1.0\",\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\","
+                         "\"runs\":[{\"tool\":{\"driver\":{\"name\":\"ctrlppcheck\",\"version\":";
+    appendJSONString(header, CppCheck::version(), false);
+    header += "}},\"results\":[";
+    return header;
+}
+
+std::string ErrorLogger::ErrorMessage::getSARIFFooter()
+{
+    return "]}]}";
+}
+
 void ErrorLogger::ErrorMessage::findAndReplace(std::string &source, const std::string &searchFor, const std::string &replaceWith)
 {
     std::string::size_type index = 0;
@@ -546,6 +885,41 @@ std::string ErrorLogger::toxml(const std::string &str)
     return xml.str();
 }
 
+std::string ErrorLogger::escapeXml(const std::string &str)
+{
+    std::string xml;
+    xml.reserve(str.size());
+    for (const char c : str) {
+        switch (c) {
+        case '<':
+            xml += "&lt;";
+            break;
+        case '>':
+            xml += "&gt;";
+            break;
+        case '&':
+            xml += "&amp;";
+            break;
+        case '\"':
+            xml += "&quot;";
+            break;
+        case '\t':
+            xml += "&#9;";
+            break;
+        case '\n':
+            xml += "&#10;";
+            break;
+        case '\r':
+            xml += "&#13;";
+            break;
+        default:
+            xml += c;
+            break;
+        }
+    }
+    return xml;
+}
+
 std::string replaceStr(std::string s, const std::string &from, const std::string &to)
 {
     std::string::size_type pos1 = 0;
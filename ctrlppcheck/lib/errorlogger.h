@@ -256,6 +256,21 @@ public:
         static std::string getXMLHeader();
         static std::string getXMLFooter();
 
+        /**
+         * Append the error message as one line of JSON (JSON-lines output),
+         * the fields are the same as in the XML format.
+         */
+        void appendJSON(std::string &out) const;
+
+        /**
+         * Append the error message as SARIF result object. The results are
+         * written between getSARIFHeader() and getSARIFFooter() separated
+         * by commas.
+         */
+        void appendSARIF(std::string &out) const;
+        static std::string getSARIFHeader();
+        static std::string getSARIFFooter();
+
         /**
          * Format the error message into a string.
          * @param verbose use verbose message
@@ -297,6 +312,18 @@ public:
 
         Suppressions::ErrorMessage toSuppressionsErrorMessage() const;
 
+        /**
+         * Serialize the message into a string of length prefixed fields,
+         * deserialize() restores all fields of the message.
+         */
+        std::string serialize() const;
+
+        /**
+         * Restore a message written by serialize()
+         * @return false if the data is invalid
+         */
+        bool deserialize(const std::string &data);
+
     private:
         /**
          * Replace all occurrences of searchFor with replaceWith in the
@@ -374,6 +401,12 @@ public:
      * @return The output string containing XML entities
      */
     static std::string toxml(const std::string &str);
+
+    /**
+     * Convert XML-sensitive characters into XML entities. Unlike toxml() all
+     * other characters are kept, the text can be read again unchanged.
+     */
+    static std::string escapeXml(const std::string &str);
 };
 
 /** Replace substring. Example replaceStr("1,NR,3", "NR", "2") => "1,2,3" */
@@ -18,34 +18,161 @@
 
 #include "importproject.h"
 
+#include "mathlib.h"
 #include "path.h"
 #include "settings.h"
 #include "token.h"
 #include "tokenize.h"
 #include "tokenlist.h"
 #include "utils.h"
+#include "tinyxml2.h"
 #include "../externals/picojson.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <fstream>
 #include <utility>
 
 
+static bool isIgnoredPath(const std::string &filename, const std::vector<std::string> &ipaths)
+{
+    for (std::size_t i = 0; i < ipaths.size(); ++i) {
+        if (filename.size() > ipaths[i].size() && filename.compare(0,ipaths[i].size(),ipaths[i])==0)
+            return true;
+    }
+    return false;
+}
+
 void ImportProject::ignorePaths(const std::vector<std::string> &ipaths)
 {
     for (std::list<FileSettings>::iterator it = fileSettings.begin(); it != fileSettings.end();) {
-        bool ignore = false;
-        for (std::size_t i = 0; i < ipaths.size(); ++i) {
-            if (it->filename.size() > ipaths[i].size() && it->filename.compare(0,ipaths[i].size(),ipaths[i])==0) {
-                ignore = true;
-                break;
-            }
-        }
-        if (ignore)
+        if (isIgnoredPath(it->filename, ipaths))
             fileSettings.erase(it++);
         else
             ++it;
     }
+    for (std::list<VirtualFile>::iterator it = virtualFiles.begin(); it != virtualFiles.end();) {
+        if (isIgnoredPath(it->filename, ipaths))
+            virtualFiles.erase(it++);
+        else
+            ++it;
+    }
+}
+
+// <events><script name="...">code</script>...</events>
+static void importPanelEvents(const tinyxml2::XMLElement *events, const std::string &prefix, std::list<ImportProject::VirtualFile> &virtualFiles)
+{
+    for (const tinyxml2::XMLElement *script = events->FirstChildElement("script"); script; script = script->NextSiblingElement("script")) {
+        const tinyxml2::XMLNode *text = script->FirstChild();
+        if (!text || !text->ToText())
+            continue;
+        const char *name = script->Attribute("name");
+
+        ImportProject::VirtualFile virtualFile;
+        // the .ctl suffix makes it a ctrl script, e.g. the #uses libraries are searched like for files
+        virtualFile.filename = prefix + '/' + (name ? name : "script") + ".ctl";
+        // empty lines in front of the script keep the line numbers of the panel
+        virtualFile.content.assign(static_cast<std::size_t>(std::max(text->GetLineNum(), 1)) - 1U, '\n');
+        std::string code = text->Value();
+        // the same replacements as the quality checks do for the panel scripts
+        std::string::size_type pos = 0;
+        while ((pos = code.find("&quot;", pos)) != std::string::npos)
+            code.replace(pos++, 6U, 1U, '\"');
+        pos = 0;
+        while ((pos = code.find("&amp;", pos)) != std::string::npos)
+            code.replace(pos++, 5U, 1U, '&');
+        virtualFile.content += code;
+        virtualFiles.push_back(std::move(virtualFile));
+    }
+}
+
+ImportProject::PanelImport ImportProject::importPanel(const std::string &filename, std::string *errorMessage)
+{
+    tinyxml2::XMLDocument doc;
+    if (doc.LoadFile(filename.c_str()) != tinyxml2::XML_SUCCESS) {
+        // only a file that starts like a panel is a broken panel
+        std::ifstream fin(filename);
+        char head[1024] = {0};
+        fin.read(head, sizeof(head) - 1);
+        if (!std::strstr(head, "<panel"))
+            return PanelImport::NOT_A_PANEL;
+        if (errorMessage)
+            *errorMessage = doc.ErrorName() + std::string(" at line ") + MathLib::toString(doc.ErrorLineNum()) + '.';
+        return PanelImport::FAILED;
+    }
+    const tinyxml2::XMLElement *panel = doc.FirstChildElement("panel");
+    if (!panel) {
+        if (errorMessage)
+            *errorMessage = "The root element is not <panel>.";
+        return PanelImport::NOT_A_PANEL;
+    }
+
+    const std::string panelName = Path::fromNativeSeparators(filename);
+    for (const tinyxml2::XMLElement *node = panel->FirstChildElement(); node; node = node->NextSiblingElement()) {
+        if (std::strcmp(node->Name(), "events") == 0) {
+            importPanelEvents(node, panelName, virtualFiles);
+        } else if (std::strcmp(node->Name(), "shapes") == 0) {
+            for (const tinyxml2::XMLElement *shape = node->FirstChildElement(); shape; shape = shape->NextSiblingElement()) {
+                const char *shapeName = shape->Attribute("Name");
+                const std::string prefix = panelName + '/' + (shapeName ? shapeName : shape->Name());
+                for (const tinyxml2::XMLElement *events = shape->FirstChildElement("events"); events; events = events->NextSiblingElement("events"))
+                    importPanelEvents(events, prefix, virtualFiles);
+            }
+        }
+    }
+    return PanelImport::IMPORTED;
+}
+
+// the empty lines in front of a script are allocated, a script has never more lines
+static const double MAX_BATCH_FIRST_LINE = 10000000.0;
+
+static bool isBatchFirstLine(const picojson::value &value)
+{
+    if (!value.is<double>())
+        return false;
+    const double firstLine = value.get<double>();
+    return firstLine >= 1 && firstLine <= MAX_BATCH_FIRST_LINE && std::floor(firstLine) == firstLine;
+}
+
+bool ImportProject::importBatchManifest(std::istream &istr, std::string *errorMessage)
+{
+    std::string line;
+    for (unsigned int linenr = 1; std::getline(istr, line); ++linenr) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        picojson::value entry;
+        std::string err = picojson::parse(entry, line);
+        if (err.empty() && !entry.is<picojson::object>())
+            err = "object expected";
+        if (err.empty()) {
+            const picojson::object &obj = entry.get<picojson::object>();
+            const picojson::object::const_iterator file = obj.find("file");
+            const picojson::object::const_iterator content = obj.find("content");
+            const picojson::object::const_iterator firstLine = obj.find("line");
+            if (file == obj.end() || !file->second.is<std::string>() || file->second.get<std::string>().empty())
+                err = "\"file\" is missing";
+            else if (content == obj.end() || !content->second.is<std::string>())
+                err = "\"content\" is missing";
+            else if (firstLine != obj.end() && !isBatchFirstLine(firstLine->second))
+                err = "\"line\" must be a positive integer up to " + MathLib::toString(static_cast<long long>(MAX_BATCH_FIRST_LINE));
+            else {
+                VirtualFile virtualFile;
+                virtualFile.filename = Path::fromNativeSeparators(file->second.get<std::string>());
+                // empty lines in front of the script keep the line numbers of the original file
+                if (firstLine != obj.end())
+                    virtualFile.content.assign(static_cast<std::size_t>(firstLine->second.get<double>()) - 1U, '\n');
+                virtualFile.content += content->second.get<std::string>();
+                virtualFiles.push_back(std::move(virtualFile));
+                continue;
+            }
+        }
+        if (errorMessage)
+            *errorMessage = "line " + MathLib::toString(linenr) + ": " + err;
+        return false;
+    }
+    return true;
 }
 
 void ImportProject::ignoreOtherConfigs(const std::string &cfg)
@@ -25,6 +25,7 @@
 #include "platform.h"
 #include "utils.h"
 
+#include <istream>
 #include <list>
 #include <map>
 #include <set>
@@ -54,6 +55,13 @@ public:
         MISSING
     };
 
+    /** Result of importPanel() */
+    enum class PanelImport {
+        IMPORTED,
+        NOT_A_PANEL,   ///< no XML file or the root element is not <panel>
+        FAILED         ///< panel with an XML syntax error
+    };
+
     /** File settings. Multiple configurations for a file is allowed. */
     struct CPPCHECKLIB FileSettings {
         FileSettings() : platformType(cppcheck::Platform::Unspecified){}
@@ -68,6 +76,35 @@ public:
     };
     std::list<FileSettings> fileSettings;
 
+    /** Script that is checked from memory, e.g. an event script of a panel. */
+    struct CPPCHECKLIB VirtualFile {
+        std::string filename;  ///< name used in the results
+        std::string content;
+    };
+    std::list<VirtualFile> virtualFiles;
+
+    /**
+     * @brief Import a batch manifest, one JSON object per line:
+     * {"file": "<name used in the results>", "content": "<script>", "line": <n>}
+     * "line" is optional, it is the line of the first script line in the
+     * original file (e.g. the panel), so that the results point to it.
+     * @param istr manifest
+     * @param errorMessage reason and line of a syntax error
+     * @return false on syntax errors
+     */
+    bool importBatchManifest(std::istream &istr, std::string *errorMessage);
+
+    /**
+     * @brief Import the scripts of a panel in XML format (-xmlConvert=XML).
+     * Each script is added as virtual file "<panel>/<event>" for the panel
+     * events and "<panel>/<shape>/<event>" for the shape events. The script
+     * keeps its line numbers of the XML file.
+     * @param filename panel file
+     * @param errorMessage reason if the panel can't be read
+     * @return NOT_A_PANEL if the file is no panel, FAILED if the panel
+     *         can't be read
+     */
+    PanelImport importPanel(const std::string &filename, std::string *errorMessage);
 
     void ignorePaths(const std::vector<std::string> &ipaths);
     void ignoreOtherConfigs(const std::string &cfg);
@@ -30,7 +30,9 @@
 #include <cctype>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <list>
+#include <sstream>
 
 static std::vector<std::string> getnames(const char *names)
 {
@@ -141,6 +143,384 @@ bool Library::loadxmldata(const char xmldata[], std::size_t len)
     return (tinyxml2::XML_SUCCESS == doc.Parse(xmldata, len)) && (load(doc).errorcode == OK);
 }
 
+//---------------------------------------------------------------------------
+// Binary snapshots
+//
+// Layout: magic, format version, key, the loaded configuration files with
+// their size and hash, the members (see Library::snapshot()) and the hash of
+// everything in front of it. Integers are stored little endian, strings and
+// containers with their size in front.
+//---------------------------------------------------------------------------
+
+namespace {
+    const char snapshotMagic[] = "CTRLPPCHECK-LIBRARY";
+
+    // increment when the members of Library or the layout change
+    const unsigned int snapshotFormat = 2;
+
+    std::string snapshotFileName(const std::string &cacheDir, const std::string &key)
+    {
+        std::ostringstream fileName;
+        fileName << cacheDir;
+        if (!cacheDir.empty() && !endsWith(cacheDir, '/') && !endsWith(cacheDir, '\\'))
+            fileName << '/';
+        fileName << "library-" << std::hex << fnv1a(key.data(), key.size()) << ".snapshot";
+        return fileName.str();
+    }
+
+    bool readFile(const std::string &fileName, std::string &data)
+    {
+        std::ifstream fin(fileName.c_str(), std::ios::binary | std::ios::ate);
+        if (!fin.is_open())
+            return false;
+        const std::streamoff size = fin.tellg();
+        if (size < 0)
+            return false;
+        data.resize(static_cast<std::size_t>(size));
+        fin.seekg(0);
+        return static_cast<bool>(fin.read(&data[0], size));
+    }
+
+    class SnapshotWriter {
+    public:
+        const std::string &data() const {
+            return mData;
+        }
+
+        void io(bool b) {
+            mData += b ? '\1' : '\0';
+        }
+        void io(char c) {
+            mData += c;
+        }
+        void io(int i) {
+            io(static_cast<unsigned int>(i));
+        }
+        void io(unsigned int u) {
+            for (int shift = 0; shift < 32; shift += 8)
+                mData += static_cast<char>((u >> shift) & 0xff);
+        }
+        void io(unsigned long long u) {
+            for (int shift = 0; shift < 64; shift += 8)
+                mData += static_cast<char>((u >> shift) & 0xff);
+        }
+        void io(const std::string &s) {
+            io(static_cast<unsigned int>(s.size()));
+            mData += s;
+        }
+        template<class E> void ioEnum(E e) {
+            io(static_cast<int>(e));
+        }
+        void io(const std::set<std::string> &s) {
+            io(static_cast<unsigned int>(s.size()));
+            for (const std::string &e : s)
+                io(e);
+        }
+        template<class K, class V, class F> void io(std::map<K, V> &m, F f) {
+            io(static_cast<unsigned int>(m.size()));
+            for (typename std::map<K, V>::value_type &e : m) {
+                io(e.first);
+                f(e.second);
+            }
+        }
+        template<class K, class V> void io(std::map<K, V> &m) {
+            io(m, [this](V &v) {
+                io(v);
+            });
+        }
+        template<class T, class F> void io(std::vector<T> &v, F f, const T &) {
+            io(static_cast<unsigned int>(v.size()));
+            for (T &e : v)
+                f(e);
+        }
+
+    private:
+        std::string mData;
+    };
+
+    class SnapshotReader {
+    public:
+        SnapshotReader(const std::string &data, std::size_t begin, std::size_t end) : mData(data), mPos(begin), mEnd(end), mOk(true) {}
+
+        bool ok() const {
+            return mOk;
+        }
+        bool atEnd() const {
+            return mPos == mEnd;
+        }
+
+        void io(bool &b) {
+            char c = 0;
+            io(c);
+            b = (c != 0);
+        }
+        void io(char &c) {
+            if (need(1))
+                c = mData[mPos++];
+        }
+        void io(int &i) {
+            unsigned int u = 0;
+            io(u);
+            i = static_cast<int>(u);
+        }
+        void io(unsigned int &u) {
+            u = 0;
+            if (!need(4))
+                return;
+            for (int shift = 0; shift < 32; shift += 8)
+                u |= static_cast<unsigned int>(static_cast<unsigned char>(mData[mPos++])) << shift;
+        }
+        void io(unsigned long long &u) {
+            u = 0;
+            if (!need(8))
+                return;
+            for (int shift = 0; shift < 64; shift += 8)
+                u |= static_cast<unsigned long long>(static_cast<unsigned char>(mData[mPos++])) << shift;
+        }
+        void io(std::string &s) {
+            unsigned int size = 0;
+            if (!count(size))
+                return;
+            s.assign(mData, mPos, size);
+            mPos += size;
+        }
+        template<class E> void ioEnum(E &e) {
+            int i = 0;
+            io(i);
+            e = static_cast<E>(i);
+        }
+        void io(std::set<std::string> &s) {
+            unsigned int size = 0;
+            count(size);
+            s.clear();
+            for (unsigned int i = 0; i < size && mOk; ++i) {
+                std::string e;
+                io(e);
+                s.insert(s.end(), e);
+            }
+        }
+        template<class K, class V, class F> void io(std::map<K, V> &m, F f) {
+            unsigned int size = 0;
+            count(size);
+            m.clear();
+            for (unsigned int i = 0; i < size && mOk; ++i) {
+                K key = K();
+                io(key);
+                f(m.emplace_hint(m.end(), key, V())->second);
+            }
+        }
+        template<class K, class V> void io(std::map<K, V> &m) {
+            io(m, [this](V &v) {
+                io(v);
+            });
+        }
+        template<class T, class F> void io(std::vector<T> &v, F f, const T &init) {
+            unsigned int size = 0;
+            count(size);
+            v.assign(size, init);
+            for (unsigned int i = 0; i < size && mOk; ++i)
+                f(v[i]);
+        }
+
+    private:
+        bool need(std::size_t size) {
+            if (mOk && mEnd - mPos < size)
+                mOk = false;
+            return mOk;
+        }
+
+        // number of elements, each element has at least one byte
+        bool count(unsigned int &size) {
+            io(size);
+            return need(size);
+        }
+
+        const std::string &mData;
+        std::size_t mPos;
+        const std::size_t mEnd;
+        bool mOk;
+    };
+}
+
+template<class Archive> void Library::snapshot(Archive &archive)
+{
+    archive.io(functionwarn, [&archive](WarnInfo &warnInfo) {
+        archive.io(warnInfo.message);
+        archive.ioEnum(warnInfo.severity);
+    });
+    archive.io(functions, [&archive](Function &function) {
+        archive.io(function.argumentChecks, [&archive](ArgumentChecks &arg) {
+            archive.io(arg.notbool);
+            archive.io(arg.notnull);
+            archive.io(arg.notuninit);
+            archive.io(arg.formatstr);
+            archive.io(arg.strz);
+            archive.io(arg.optional);
+            archive.io(arg.variadic);
+            archive.io(arg.valid);
+            archive.io(arg.valueType);
+            archive.io(arg.name);
+            archive.io(arg.iteratorInfo.container);
+            archive.io(arg.iteratorInfo.it);
+            archive.io(arg.iteratorInfo.first);
+            archive.io(arg.iteratorInfo.last);
+            archive.io(arg.minsizes, [&archive](ArgumentChecks::MinSize &minsize) {
+                archive.ioEnum(minsize.type);
+                archive.io(minsize.arg);
+                archive.io(minsize.arg2);
+            }, ArgumentChecks::MinSize(ArgumentChecks::MinSize::NONE, 0));
+            archive.ioEnum(arg.direction);
+        });
+        archive.io(function.use);
+        archive.io(function.leakignore);
+        archive.io(function.isconst);
+        archive.io(function.ispure);
+        archive.io(function.useretval);
+        archive.io(function.ignore);
+        archive.io(function.formatstr);
+        archive.io(function.formatstr_scan);
+        archive.io(function.notInLoop);
+        archive.io(function.notInLoop_inconclusive);
+    });
+    archive.io(returnuninitdata);
+    archive.io(defines, [&archive](UserDefinedValue &define) {
+        archive.io(define.name);
+        archive.io(define.value);
+        archive.io(define.type);
+        archive.io(define.isConst);
+    });
+
+    // mFiles is stored in front of the members, with the hashes of the files
+    const auto allocFunc = [&archive](AllocFunc &func) {
+        archive.io(func.groupId);
+        archive.io(func.arg);
+    };
+    archive.io(mAllocId);
+    archive.io(mAlloc, allocFunc);
+    archive.io(mDealloc, allocFunc);
+    archive.io(mNoReturn);
+    archive.io(mReturnValue);
+    archive.io(mReturnValueType);
+    archive.io(mReportErrors);
+    archive.io(mProcessAfterCode);
+    archive.io(mMarkupExtensions);
+    archive.io(mKeywords);
+    archive.io(mExecutableBlocks, [&archive](CodeBlock &block) {
+        archive.io(block.mStart);
+        archive.io(block.mEnd);
+        archive.io(block.mOffset);
+        archive.io(block.mBlocks);
+    });
+    archive.io(mExporters, [&archive](ExportedFunctions &exporter) {
+        archive.io(exporter.mPrefixes);
+        archive.io(exporter.mSuffixes);
+    });
+    archive.io(mImporters);
+    archive.io(mReflection);
+    archive.io(mEntrypoints);
+    archive.io(mPodTypes, [&archive](PodType &podType) {
+        archive.io(podType.size);
+        archive.io(podType.sign);
+    });
+    const auto platformType = [&archive](PlatformType &type) {
+        archive.io(type.mType);
+        archive.io(type._signed);
+        archive.io(type._unsigned);
+        archive.io(type._long);
+        archive.io(type._pointer);
+        archive.io(type._ptr_ptr);
+        archive.io(type._const_ptr);
+    };
+    archive.io(mPlatformTypes, platformType);
+    archive.io(mPlatforms, [&archive, &platformType](Platform &platform) {
+        archive.io(platform.mPlatformTypes, platformType);
+    });
+}
+
+bool Library::loadSnapshot(const std::string &cacheDir, const std::string &key)
+{
+    std::string data;
+    if (!readFile(snapshotFileName(cacheDir, key), data) || data.size() < 8U)
+        return false;
+
+    // the trailing hash protects against truncated or concurrently written files
+    const std::size_t end = data.size() - 8U;
+    unsigned long long hash = 0;
+    SnapshotReader trailer(data, end, data.size());
+    trailer.io(hash);
+    if (hash != fnv1a(data.data(), end))
+        return false;
+
+    SnapshotReader reader(data, 0, end);
+    std::string magic, snapshotKey;
+    unsigned int format = 0;
+    reader.io(magic);
+    reader.io(format);
+    reader.io(snapshotKey);
+    if (!reader.ok() || magic != snapshotMagic || format != snapshotFormat || snapshotKey != key)
+        return false;
+
+    // the snapshot is outdated if one of the configuration files was changed
+    std::set<std::string> files;
+    unsigned int fileCount = 0;
+    reader.io(fileCount);
+    for (unsigned int i = 0; i < fileCount && reader.ok(); ++i) {
+        std::string fileName, content;
+        unsigned int size = 0;
+        unsigned long long fileHash = 0;
+        reader.io(fileName);
+        reader.io(size);
+        reader.io(fileHash);
+        if (!reader.ok() || !readFile(fileName, content) || content.size() != size || fnv1a(content.data(), content.size()) != fileHash)
+            return false;
+        files.insert(fileName);
+    }
+
+    Library library;
+    library.snapshot(reader);
+    if (!reader.ok() || !reader.atEnd())
+        return false;
+    library.mFiles.swap(files);
+    *this = std::move(library);
+    return true;
+}
+
+bool Library::saveSnapshot(const std::string &cacheDir, const std::string &key) const
+{
+    SnapshotWriter writer;
+    writer.io(std::string(snapshotMagic));
+    writer.io(snapshotFormat);
+    writer.io(key);
+    writer.io(static_cast<unsigned int>(mFiles.size()));
+    for (const std::string &fileName : mFiles) {
+        std::string content;
+        if (!readFile(fileName, content))
+            return false;
+        writer.io(fileName);
+        writer.io(static_cast<unsigned int>(content.size()));
+        writer.io(fnv1a(content.data(), content.size()));
+    }
+    // the same function reads and writes the members, writing doesn't modify them
+    const_cast<Library *>(this)->snapshot(writer);
+    writer.io(fnv1a(writer.data().data(), writer.data().size()));
+
+    std::ofstream fout(snapshotFileName(cacheDir, key).c_str(), std::ios::binary);
+    fout.write(writer.data().data(), writer.data().size());
+    return fout.good();
+}
+
+unsigned long long Library::checksum() const
+{
+    unsigned long long h = fnv1a(nullptr, 0U);
+    for (const std::string &fileName : mFiles) {
+        std::string content;
+        readFile(fileName, content);
+        h = fnv1a(fileName.data(), fileName.size(), h);
+        h = fnv1a(content.data(), content.size(), h);
+    }
+    return h;
+}
+
 Library::Error Library::load(const tinyxml2::XMLDocument &doc)
 {
     const tinyxml2::XMLElement * const rootnode = doc.FirstChildElement();
@@ -285,6 +665,13 @@ Library::Error Library::load(const tinyxml2::XMLDocument &doc)
             }
         }
 
+        else if (nodename == "entrypoint") {
+            const char * const name = node->Attribute("name");
+            if (name == nullptr)
+                return Error(MISSING_ATTRIBUTE, "name");
+            mEntrypoints.insert(name);
+        }
+
         else if (nodename == "markup") {
             const char * const extension = node->Attribute("ext");
             if (!extension)
@@ -680,13 +1067,13 @@ bool Library::isIntArgValid(const Token *ftok, int argnr, const MathLib::bigint
     TokenList tokenList(nullptr);
     gettokenlistfromvalid(ac->valid, tokenList);
     for (const Token *tok = tokenList.front(); tok; tok = tok->next()) {
-        if (tok->isNumber() && argvalue == MathLib::toLongNumber(tok->str()))
+        if (tok->isNumber() && argvalue == tok->getIntNumber())
             return true;
-        if (Token::Match(tok, "%num% : %num%") && argvalue >= MathLib::toLongNumber(tok->str()) && argvalue <= MathLib::toLongNumber(tok->strAt(2)))
+        if (Token::Match(tok, "%num% : %num%") && argvalue >= tok->getIntNumber() && argvalue <= tok->tokAt(2)->getIntNumber())
             return true;
-        if (Token::Match(tok, "%num% : ,") && argvalue >= MathLib::toLongNumber(tok->str()))
+        if (Token::Match(tok, "%num% : ,") && argvalue >= tok->getIntNumber())
             return true;
-        if ((!tok->previous() || tok->previous()->str() == ",") && Token::Match(tok,": %num%") && argvalue <= MathLib::toLongNumber(tok->strAt(1)))
+        if ((!tok->previous() || tok->previous()->str() == ",") && Token::Match(tok,": %num%") && argvalue <= tok->tokAt(1)->getIntNumber())
             return true;
     }
     return false;
@@ -700,11 +1087,11 @@ bool Library::isFloatArgValid(const Token *ftok, int argnr, double argvalue) con
     TokenList tokenList(nullptr);
     gettokenlistfromvalid(ac->valid, tokenList);
     for (const Token *tok = tokenList.front(); tok; tok = tok->next()) {
-        if (Token::Match(tok, "%num% : %num%") && argvalue >= MathLib::toDoubleNumber(tok->str()) && argvalue <= MathLib::toDoubleNumber(tok->strAt(2)))
+        if (Token::Match(tok, "%num% : %num%") && argvalue >= tok->getFloatNumber() && argvalue <= tok->tokAt(2)->getFloatNumber())
             return true;
-        if (Token::Match(tok, "%num% : ,") && argvalue >= MathLib::toDoubleNumber(tok->str()))
+        if (Token::Match(tok, "%num% : ,") && argvalue >= tok->getFloatNumber())
             return true;
-        if ((!tok->previous() || tok->previous()->str() == ",") && Token::Match(tok,": %num%") && argvalue <= MathLib::toDoubleNumber(tok->strAt(1)))
+        if ((!tok->previous() || tok->previous()->str() == ",") && Token::Match(tok,": %num%") && argvalue <= tok->tokAt(1)->getFloatNumber())
             return true;
     }
     return false;
@@ -69,6 +69,30 @@ public:
     /** this is primarily meant for unit tests. it only returns true/false */
     bool loadxmldata(const char xmldata[], std::size_t len);
 
+    /**
+     * @brief Load a binary snapshot of the configuration, written by saveSnapshot().
+     * The snapshot is only used if it was written for the same key and none of
+     * the loaded configuration files changed since then.
+     * @param cacheDir directory of the snapshots
+     * @param key identification of the configuration, e.g. the library options
+     * @return true if the snapshot was loaded, the configuration is unchanged otherwise
+     */
+    bool loadSnapshot(const std::string &cacheDir, const std::string &key);
+
+    /**
+     * @brief Write a binary snapshot of the loaded configuration
+     * @param cacheDir directory of the snapshots
+     * @param key identification of the configuration, e.g. the library options
+     * @return false if the snapshot could not be written
+     */
+    bool saveSnapshot(const std::string &cacheDir, const std::string &key) const;
+
+    /**
+     * @brief Hash of the names and contents of the loaded configuration files.
+     * It changes when one of the files is edited.
+     */
+    unsigned long long checksum() const;
+
     struct AllocFunc {
         int groupId;
         int arg;
@@ -299,6 +323,11 @@ public:
         return -1;
     }
 
+    /** Is the function called by the runtime (main, event handlers)? */
+    bool isentrypoint(const std::string &func) const {
+        return mEntrypoints.find(func) != mEntrypoints.end();
+    }
+
     std::set<std::string> returnuninitdata;
 
     struct UserDefinedValue {
@@ -378,7 +407,11 @@ private:
     // load a <function> xml node
     Error loadFunction(const tinyxml2::XMLElement * const node, const std::string &name, std::set<std::string> &unknown_elements);
 
+    // read or write all members with a snapshot archive
+    template<class Archive> void snapshot(Archive &archive);
+
     class ExportedFunctions {
+        friend class Library; // snapshot
     public:
         void addPrefix(const std::string& prefix) {
             mPrefixes.insert(prefix);
@@ -398,6 +431,7 @@ private:
         std::set<std::string> mSuffixes;
     };
     class CodeBlock {
+        friend class Library; // snapshot
     public:
         CodeBlock() : mOffset(0) {}
 
@@ -447,6 +481,7 @@ private:
     std::map<std::string, ExportedFunctions> mExporters; // keywords that export variables/functions to libraries (meta-code/macros)
     std::map<std::string, std::set<std::string> > mImporters; // keywords that import variables/functions
     std::map<std::string, int> mReflection; // invocation of reflection
+    std::set<std::string> mEntrypoints; // functions called by the runtime
     std::map<std::string, struct PodType> mPodTypes; // pod types
     std::map<std::string, PlatformType> mPlatformTypes; // platform independent typedefs
     std::map<std::string, Platform> mPlatforms; // platform dependent typedefs
@@ -0,0 +1,155 @@
+//-----------------------------------------------------------------------------
+#include "memoryusage.h"
+
+#include "symbols/symbols.h"
+#include "token.h"
+#include "tokenlist.h"
+#include "valueflow.h"
+
+#include <simplecpp.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <list>
+#include <sstream>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "psapi.lib")
+#endif
+#else
+#include <sys/resource.h>
+#endif
+
+//-----------------------------------------------------------------------------
+
+namespace {
+    /** a node of a std::list: the element and two pointers */
+    const std::size_t LIST_NODE = 2U * sizeof(void *);
+
+    /** heap memory of a string, short strings are stored in the object */
+    std::size_t stringSize(const std::string &str)
+    {
+        return str.capacity() > 15U ? str.capacity() + 1U : 0U;
+    }
+
+    std::size_t variablesSize(const std::list<Variable> &variables)
+    {
+        return variables.size() * (sizeof(Variable) + LIST_NODE);
+    }
+}
+
+MemoryUsage::MemoryUsage()
+{
+    std::fill(mSize, mSize + SUBSYSTEMS, 0U);
+}
+
+std::size_t MemoryUsage::total() const
+{
+    std::size_t sum = 0;
+    for (int subsystem = 0; subsystem < SUBSYSTEMS; ++subsystem)
+        sum += mSize[subsystem];
+    return sum;
+}
+
+void MemoryUsage::addSimplecpp(const simplecpp::TokenList &tokens)
+{
+    for (const simplecpp::Token *tok = tokens.cfront(); tok; tok = tok->next)
+        mSize[SIMPLECPP] += sizeof(simplecpp::Token) + stringSize(tok->str());
+}
+
+void MemoryUsage::addTokens(const TokenList &list)
+{
+    for (const Token *tok = list.front(); tok; tok = tok->next()) {
+        mSize[TOKENS] += sizeof(Token) + sizeof(TokenImpl) + stringSize(tok->str());
+        if (!tok->originalName().empty())
+            mSize[TOKENS] += sizeof(std::string) + stringSize(tok->originalName());
+
+        const std::list<ValueFlow::Value> &values = tok->values();
+        if (values.empty())
+            continue;
+        mSize[VALUES] += sizeof(values);
+        for (const ValueFlow::Value &value : values)
+            mSize[VALUES] += sizeof(ValueFlow::Value) + LIST_NODE + value.errorPath.size() * (sizeof(ErrorPathItem) + LIST_NODE);
+    }
+}
+
+void MemoryUsage::addSymbolDatabase(const SymbolDatabase &symbolDatabase)
+{
+    std::size_t &size = mSize[SYMBOLDATABASE];
+    size += sizeof(SymbolDatabase);
+    for (const Scope &scope : symbolDatabase.scopeList) {
+        size += sizeof(Scope) + LIST_NODE + variablesSize(scope.varlist) + scope.nestedList.size() * LIST_NODE;
+        for (const Function &function : scope.functionList)
+            size += sizeof(Function) + LIST_NODE + variablesSize(function.argumentList);
+    }
+    size += symbolDatabase.typeList.size() * (sizeof(Type) + LIST_NODE);
+    size += (symbolDatabase.functionScopes.size() + symbolDatabase.classAndStructScopes.size() + symbolDatabase.variableList().size()) * sizeof(void *);
+}
+
+void MemoryUsage::peak(const MemoryUsage &other)
+{
+    for (int subsystem = 0; subsystem < SUBSYSTEMS; ++subsystem)
+        mSize[subsystem] = std::max(mSize[subsystem], other.mSize[subsystem]);
+}
+
+std::string MemoryUsage::toString() const
+{
+    std::ostringstream out;
+    for (int subsystem = 0; subsystem < SUBSYSTEMS; ++subsystem) {
+        if (mSize[subsystem] > 0)
+            out << name(static_cast<Subsystem>(subsystem)) << ' ' << toMiB(mSize[subsystem]) << ", ";
+    }
+    out << "total " << toMiB(total());
+    return out.str();
+}
+
+const char *MemoryUsage::name(Subsystem subsystem)
+{
+    switch (subsystem) {
+    case SIMPLECPP:
+        return "simplecpp";
+    case TOKENS:
+        return "tokens";
+    case VALUES:
+        return "values";
+    case SYMBOLDATABASE:
+        return "symboldatabase";
+    case FILEINFO:
+        return "fileinfo";
+    case SUBSYSTEMS:
+        break;
+    }
+    return "";
+}
+
+std::string MemoryUsage::toMiB(std::size_t bytes)
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << static_cast<double>(bytes) / (1024.0 * 1024.0) << " MiB";
+    return out.str();
+}
+
+std::size_t MemoryUsage::peakProcessMemory()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#if defined(__APPLE__)
+    return static_cast<std::size_t>(usage.ru_maxrss);         // bytes
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024U; // KiB
+#endif
+#endif
+}
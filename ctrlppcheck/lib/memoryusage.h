@@ -0,0 +1,80 @@
+//-----------------------------------------------------------------------------
+#ifndef memoryusageH
+#define memoryusageH
+//-----------------------------------------------------------------------------
+
+#include "config.h"
+
+#include <cstddef>
+#include <string>
+
+class SymbolDatabase;
+class TokenList;
+
+namespace simplecpp {
+    class TokenList;
+}
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Estimated memory of the analysis data, per subsystem. Used for
+ * --showtime=memory and the memory budget of a file (--max-memory).
+ *
+ * The sizes are calculated from the number of objects and the sizes of their
+ * strings and list nodes. The overhead of the allocator is not included, the
+ * process memory is measured separately with peakProcessMemory().
+ */
+class CPPCHECKLIB MemoryUsage {
+public:
+    enum Subsystem {
+        SIMPLECPP,       ///< raw, #uses and preprocessed simplecpp token lists
+        TOKENS,          ///< Token and TokenImpl with their strings
+        VALUES,          ///< ValueFlow values of the tokens
+        SYMBOLDATABASE,  ///< scopes, functions, variables and types
+        FILEINFO,        ///< whole program analysis data
+        SUBSYSTEMS
+    };
+
+    MemoryUsage();
+
+    std::size_t size(Subsystem subsystem) const {
+        return mSize[subsystem];
+    }
+
+    /** @brief Sum of all subsystems */
+    std::size_t total() const;
+
+    void addSimplecpp(const simplecpp::TokenList &tokens);
+
+    /** @brief Add the tokens (TOKENS) and their values (VALUES) */
+    void addTokens(const TokenList &list);
+
+    void addSymbolDatabase(const SymbolDatabase &symbolDatabase);
+
+    void addFileInfo(std::size_t bytes) {
+        mSize[FILEINFO] += bytes;
+    }
+
+    /** @brief Keep the larger size of each subsystem, for the peak of several files */
+    void peak(const MemoryUsage &other);
+
+    /** @brief The sizes of the used subsystems and the total in one line */
+    std::string toString() const;
+
+    static const char *name(Subsystem subsystem);
+
+    /** @brief Format a size in MiB */
+    static std::string toMiB(std::size_t bytes);
+
+    /** @brief Peak resident memory of the process in bytes, 0 if it is unknown */
+    static std::size_t peakProcessMemory();
+
+private:
+    std::size_t mSize[SUBSYSTEMS];
+};
+
+/// @}
+//-----------------------------------------------------------------------------
+#endif // memoryusageH
@@ -99,6 +99,11 @@ public:
 
     void removeComments();
 
+    /** token lists of the files loaded with #uses, by file name */
+    const std::map<std::string, simplecpp::TokenList *> &getTokenLists() const {
+        return mTokenLists;
+    }
+
     void setPlatformInfo(simplecpp::TokenList *tokens) const;
 
     simplecpp::TokenList preprocess(const simplecpp::TokenList &tokens1, const std::string &cfg, std::vector<std::string> &files, bool throwError = false);
@@ -114,13 +119,14 @@ public:
     std::string getcode(const std::string &filedata, const std::string &cfg, const std::string &filename);
 
     /**
-     * Calculate CRC32 checksum. Using toolinfo, tokens1, filedata.
+     * Calculate a checksum of the code. Using toolinfo, tokens1 and the loaded
+     * files, with the positions of the tokens. Comments are skipped.
      *
      * @param tokens1    Sourcefile tokens
      * @param toolinfo   Arbitrary extra toolinfo
-     * @return CRC32 checksum
+     * @return 64 bit checksum
      */
-    unsigned int calculateChecksum(const simplecpp::TokenList &tokens1, const std::string &toolinfo) const;
+    unsigned long long calculateChecksum(const simplecpp::TokenList &tokens1, const std::string &toolinfo) const;
 
     void simplifyPragmaAsm(simplecpp::TokenList *tokenList);
 
@@ -0,0 +1,818 @@
+//-----------------------------------------------------------------------------
+#include "regex.h"
+
+#include <bitset>
+#include <regex>
+#include <utility>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+typedef std::bitset<256> CharClass;
+
+/** max number of automaton instructions, larger patterns are handled by std::regex */
+const std::size_t MAX_INSTRUCTIONS = 10000U;
+
+/** max nesting of groups in a pattern handled by the automaton */
+const unsigned int MAX_DEPTH = 200U;
+
+/** max count in a {n,m} quantifier */
+const unsigned int MAX_REPEAT = 1000U;
+
+/** "infinite" max count of a quantifier */
+const unsigned int REPEAT_INF = ~0U;
+
+/** Thrown if a pattern is not supported by the automaton (or invalid) */
+struct Unsupported {};
+
+//-----------------------------------------------------------------------------
+
+bool isWordChar(unsigned char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+CharClass makeClass(char escape)
+{
+    CharClass cls;
+    for (unsigned int c = 0; c < 256U; ++c) {
+        switch (escape) {
+        case 'd':
+        case 'D':
+            cls[c] = (c >= '0' && c <= '9');
+            break;
+        case 'w':
+        case 'W':
+            cls[c] = isWordChar(static_cast<unsigned char>(c));
+            break;
+        case 's':
+        case 'S':
+            cls[c] = (c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r');
+            break;
+        }
+    }
+    if (escape == 'D' || escape == 'W' || escape == 'S')
+        cls.flip();
+    return cls;
+}
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+//-----------------------------------------------------------------------------
+
+/** Instruction of the automaton */
+struct Instruction {
+    enum Op { CHAR, ANY, CLASS, SPLIT, JMP, BOL, EOL, WORD_BOUNDARY, NOT_WORD_BOUNDARY, MATCH };
+
+    Instruction(Op op_, std::size_t x_ = 0, std::size_t y_ = 0) : op(op_), x(x_), y(y_) {}
+
+    Op op;
+    /** CHAR: character, CLASS: index of the class, SPLIT/JMP: preferred target */
+    std::size_t x;
+    /** SPLIT: other target */
+    std::size_t y;
+};
+
+/** Node of the parsed pattern */
+struct Node {
+    enum Type { EMPTY, CHAR, ANY, CLASS, BOL, EOL, WORD_BOUNDARY, NOT_WORD_BOUNDARY, CONCAT, ALTERNATIVE, REPEAT };
+
+    explicit Node(Type type_) : type(type_), c(0), min(0), max(0), greedy(true) {}
+
+    Type type;
+    unsigned char c;
+    CharClass cls;
+    /** indexes of the child nodes */
+    std::vector<std::size_t> children;
+    unsigned int min;
+    unsigned int max;
+    bool greedy;
+};
+
+/**
+ * Recursive descent parser for the supported ECMAScript subset. Everything
+ * that is not known to be handled exactly like std::regex does throws
+ * Unsupported, std::regex is used for these patterns.
+ */
+class Parser {
+public:
+    explicit Parser(const std::string &pattern) : mPattern(pattern), mPos(0), mDepth(0) {}
+
+    std::vector<Node> nodes;
+
+    /** @return index of the root node */
+    std::size_t parse() {
+        const std::size_t root = parseAlternative();
+        if (mPos != mPattern.size())
+            throw Unsupported();
+        return root;
+    }
+
+private:
+    const std::string &mPattern;
+    std::size_t mPos;
+    unsigned int mDepth;
+
+    bool atEnd() const {
+        return mPos >= mPattern.size();
+    }
+
+    char peek() const {
+        return mPattern[mPos];
+    }
+
+    std::size_t add(const Node &node) {
+        nodes.push_back(node);
+        return nodes.size() - 1;
+    }
+
+    std::size_t parseAlternative() {
+        if (++mDepth > MAX_DEPTH)
+            throw Unsupported();
+        Node alternative(Node::ALTERNATIVE);
+        alternative.children.push_back(parseConcat());
+        while (!atEnd() && peek() == '|') {
+            ++mPos;
+            alternative.children.push_back(parseConcat());
+        }
+        --mDepth;
+        if (alternative.children.size() == 1)
+            return alternative.children[0];
+        return add(alternative);
+    }
+
+    std::size_t parseConcat() {
+        Node concat(Node::CONCAT);
+        while (!atEnd() && peek() != '|' && peek() != ')')
+            concat.children.push_back(parseQuantified());
+        if (concat.children.empty())
+            return add(Node(Node::EMPTY));
+        if (concat.children.size() == 1)
+            return concat.children[0];
+        return add(concat);
+    }
+
+    bool parseNumber(unsigned int *value) {
+        if (atEnd() || peek() < '0' || peek() > '9')
+            return false;
+        unsigned int v = 0;
+        while (!atEnd() && peek() >= '0' && peek() <= '9') {
+            v = v * 10U + static_cast<unsigned int>(peek() - '0');
+            if (v > MAX_REPEAT)
+                throw Unsupported();
+            ++mPos;
+        }
+        *value = v;
+        return true;
+    }
+
+    std::size_t parseQuantified() {
+        const std::size_t atom = parseAtom();
+        if (atEnd())
+            return atom;
+
+        unsigned int min, max;
+        switch (peek()) {
+        case '*':
+            min = 0;
+            max = REPEAT_INF;
+            ++mPos;
+            break;
+        case '+':
+            min = 1;
+            max = REPEAT_INF;
+            ++mPos;
+            break;
+        case '?':
+            min = 0;
+            max = 1;
+            ++mPos;
+            break;
+        case '{':
+            ++mPos;
+            if (!parseNumber(&min))
+                throw Unsupported();
+            max = min;
+            if (!atEnd() && peek() == ',') {
+                ++mPos;
+                if (!parseNumber(&max))
+                    max = REPEAT_INF;
+            }
+            if (atEnd() || peek() != '}' || max < min)
+                throw Unsupported();
+            ++mPos;
+            break;
+        default:
+            return atom;
+        }
+
+        // std::regex has its own rules for repeating expressions that match
+        // the empty string, don't try to replicate them
+        if (canMatchEmpty(atom))
+            throw Unsupported();
+
+        Node repeat(Node::REPEAT);
+        repeat.children.push_back(atom);
+        repeat.min = min;
+        repeat.max = max;
+        if (!atEnd() && peek() == '?') {
+            repeat.greedy = false;
+            ++mPos;
+        }
+        if (!atEnd() && (peek() == '*' || peek() == '+' || peek() == '?' || peek() == '{'))
+            throw Unsupported();
+        return add(repeat);
+    }
+
+    bool canMatchEmpty(std::size_t index) const {
+        const Node &node = nodes[index];
+        switch (node.type) {
+        case Node::CHAR:
+        case Node::ANY:
+        case Node::CLASS:
+            return false;
+        case Node::CONCAT:
+            for (std::size_t child : node.children) {
+                if (!canMatchEmpty(child))
+                    return false;
+            }
+            return true;
+        case Node::ALTERNATIVE:
+            for (std::size_t child : node.children) {
+                if (canMatchEmpty(child))
+                    return true;
+            }
+            return false;
+        case Node::REPEAT:
+            return node.min == 0 || canMatchEmpty(node.children[0]);
+        default:
+            return true;
+        }
+    }
+
+    std::size_t parseAtom() {
+        const char c = peek();
+        ++mPos;
+        switch (c) {
+        case '^':
+            return add(Node(Node::BOL));
+        case '$':
+            return add(Node(Node::EOL));
+        case '.':
+            return add(Node(Node::ANY));
+        case '(': {
+            if (!atEnd() && peek() == '?') {
+                // only non capturing groups, no lookahead
+                if (mPos + 1 >= mPattern.size() || mPattern[mPos + 1] != ':')
+                    throw Unsupported();
+                mPos += 2;
+            }
+            const std::size_t group = parseAlternative();
+            if (atEnd() || peek() != ')')
+                throw Unsupported();
+            ++mPos;
+            return group;
+        }
+        case '[':
+            return parseClass();
+        case '\\':
+            return parseEscape();
+        case ')':
+        case ']':
+        case '{':
+        case '}':
+        case '*':
+        case '+':
+        case '?':
+            throw Unsupported();
+        default:
+            return addChar(c);
+        }
+    }
+
+    std::size_t addChar(char c) {
+        Node node(Node::CHAR);
+        node.c = static_cast<unsigned char>(c);
+        return add(node);
+    }
+
+    std::size_t addClass(const CharClass &cls) {
+        Node node(Node::CLASS);
+        node.cls = cls;
+        return add(node);
+    }
+
+    /** Parse a character escape (\f\n\r\t\v\xHH and identity escapes) */
+    char parseCharEscape(char c) {
+        switch (c) {
+        case 'f':
+            return '\f';
+        case 'n':
+            return '\n';
+        case 'r':
+            return '\r';
+        case 't':
+            return '\t';
+        case 'v':
+            return '\v';
+        case 'x': {
+            if (mPos + 2 > mPattern.size())
+                throw Unsupported();
+            const int high = hexValue(mPattern[mPos]);
+            const int low = hexValue(mPattern[mPos + 1]);
+            if (high < 0 || low < 0)
+                throw Unsupported();
+            mPos += 2;
+            return static_cast<char>(high * 16 + low);
+        }
+        case 'u':
+        case 'c':
+        case 'b':
+        case 'B':
+            throw Unsupported();
+        default:
+            // backreferences and octal escapes
+            if (c >= '0' && c <= '9')
+                throw Unsupported();
+            return c;
+        }
+    }
+
+    std::size_t parseEscape() {
+        if (atEnd())
+            throw Unsupported();
+        const char c = peek();
+        ++mPos;
+        switch (c) {
+        case 'd':
+        case 'D':
+        case 'w':
+        case 'W':
+        case 's':
+        case 'S':
+            return addClass(makeClass(c));
+        case 'b':
+            return add(Node(Node::WORD_BOUNDARY));
+        case 'B':
+            return add(Node(Node::NOT_WORD_BOUNDARY));
+        default:
+            return addChar(parseCharEscape(c));
+        }
+    }
+
+    std::size_t parseClass() {
+        CharClass cls;
+        bool negated = false;
+        if (!atEnd() && peek() == '^') {
+            negated = true;
+            ++mPos;
+        }
+        if (!atEnd() && peek() == ']')
+            throw Unsupported();
+
+        bool first = true;
+        while (!atEnd() && peek() != ']') {
+            char c = peek();
+            ++mPos;
+            if (c == '[')
+                throw Unsupported();
+
+            if (c == '\\') {
+                if (atEnd())
+                    throw Unsupported();
+                c = peek();
+                ++mPos;
+                if (c == 'd' || c == 'D' || c == 'w' || c == 'W' || c == 's' || c == 'S') {
+                    if (!atEnd() && peek() == '-' && mPos + 1 < mPattern.size() && mPattern[mPos + 1] != ']')
+                        throw Unsupported();
+                    cls |= makeClass(c);
+                    first = false;
+                    continue;
+                }
+                c = parseCharEscape(c);
+            } else if (c == '-' && !first && (atEnd() || peek() != ']')) {
+                // "a-b-c"
+                throw Unsupported();
+            }
+
+            unsigned char low = static_cast<unsigned char>(c);
+            unsigned char high = low;
+            if (!atEnd() && peek() == '-' && mPos + 1 < mPattern.size() && mPattern[mPos + 1] != ']') {
+                ++mPos;
+                char h = peek();
+                ++mPos;
+                if (h == '[')
+                    throw Unsupported();
+                if (h == '\\') {
+                    if (atEnd())
+                        throw Unsupported();
+                    h = peek();
+                    ++mPos;
+                    if (h == 'd' || h == 'D' || h == 'w' || h == 'W' || h == 's' || h == 'S')
+                        throw Unsupported();
+                    h = parseCharEscape(h);
+                }
+                high = static_cast<unsigned char>(h);
+                if (high < low)
+                    throw Unsupported();
+            }
+            for (unsigned int i = low; i <= high; ++i)
+                cls[i] = true;
+            first = false;
+        }
+        if (atEnd())
+            throw Unsupported();
+        ++mPos;
+
+        if (negated)
+            cls.flip();
+        return addClass(cls);
+    }
+};
+
+//-----------------------------------------------------------------------------
+
+/** Compiles the parsed pattern to automaton instructions */
+class Compiler {
+public:
+    Compiler(const std::vector<Node> &nodes, std::vector<Instruction> &program, std::vector<CharClass> &classes)
+        : mNodes(nodes), mProgram(program), mClasses(classes) {}
+
+    void compile(std::size_t index) {
+        const Node &node = mNodes[index];
+        switch (node.type) {
+        case Node::EMPTY:
+            break;
+        case Node::CHAR:
+            emit(Instruction(Instruction::CHAR, node.c));
+            break;
+        case Node::ANY:
+            emit(Instruction(Instruction::ANY));
+            break;
+        case Node::CLASS:
+            mClasses.push_back(node.cls);
+            emit(Instruction(Instruction::CLASS, mClasses.size() - 1));
+            break;
+        case Node::BOL:
+            emit(Instruction(Instruction::BOL));
+            break;
+        case Node::EOL:
+            emit(Instruction(Instruction::EOL));
+            break;
+        case Node::WORD_BOUNDARY:
+            emit(Instruction(Instruction::WORD_BOUNDARY));
+            break;
+        case Node::NOT_WORD_BOUNDARY:
+            emit(Instruction(Instruction::NOT_WORD_BOUNDARY));
+            break;
+        case Node::CONCAT:
+            for (std::size_t child : node.children)
+                compile(child);
+            break;
+        case Node::ALTERNATIVE: {
+            std::vector<std::size_t> jumps;
+            for (std::size_t i = 0; i + 1 < node.children.size(); ++i) {
+                const std::size_t split = emit(Instruction(Instruction::SPLIT));
+                mProgram[split].x = mProgram.size();
+                compile(node.children[i]);
+                jumps.push_back(emit(Instruction(Instruction::JMP)));
+                mProgram[split].y = mProgram.size();
+            }
+            compile(node.children.back());
+            for (std::size_t jump : jumps)
+                mProgram[jump].x = mProgram.size();
+            break;
+        }
+        case Node::REPEAT: {
+            const std::size_t child = node.children[0];
+            for (unsigned int i = 0; i < node.min; ++i)
+                compile(child);
+            if (node.max == REPEAT_INF) {
+                const std::size_t split = emit(Instruction(Instruction::SPLIT));
+                compile(child);
+                emit(Instruction(Instruction::JMP, split));
+                setSplit(split, split + 1, mProgram.size(), node.greedy);
+            } else {
+                std::vector<std::size_t> splits;
+                for (unsigned int i = node.min; i < node.max; ++i) {
+                    splits.push_back(emit(Instruction(Instruction::SPLIT)));
+                    compile(child);
+                }
+                for (std::size_t split : splits)
+                    setSplit(split, split + 1, mProgram.size(), node.greedy);
+            }
+            break;
+        }
+        }
+    }
+
+private:
+    const std::vector<Node> &mNodes;
+    std::vector<Instruction> &mProgram;
+    std::vector<CharClass> &mClasses;
+
+    std::size_t emit(const Instruction &instruction) {
+        if (mProgram.size() >= MAX_INSTRUCTIONS)
+            throw Unsupported();
+        mProgram.push_back(instruction);
+        return mProgram.size() - 1;
+    }
+
+    void setSplit(std::size_t split, std::size_t body, std::size_t out, bool greedy) {
+        mProgram[split].x = greedy ? body : out;
+        mProgram[split].y = greedy ? out : body;
+    }
+};
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Pike VM: simulates all paths through the automaton in parallel. The threads
+ * are kept in priority order so the result is the same as the one of a
+ * backtracking matcher.
+ */
+class AutomatonRegex : public Regex {
+public:
+    explicit AutomatonRegex(const std::string &pattern) : mCanMatchEmpty(false) {
+        Parser parser(pattern);
+        const std::size_t root = parser.parse();
+        Compiler compiler(parser.nodes, mProgram, mClasses);
+        compiler.compile(root);
+        mProgram.push_back(Instruction(Instruction::MATCH));
+        calculateFirstChars();
+    }
+
+    Result search(const std::string &str, std::size_t start, std::size_t *matchPos, std::size_t *matchLength, unsigned long long *budget) const OVERRIDE {
+        return run(str, start, false, matchPos, matchLength, budget);
+    }
+
+    Result match(const std::string &str, unsigned long long *budget) const OVERRIDE {
+        std::size_t pos, length;
+        return run(str, 0, true, &pos, &length, budget);
+    }
+
+    const char *engineName() const OVERRIDE {
+        return "automaton";
+    }
+
+    bool countsBudget() const OVERRIDE {
+        return true;
+    }
+
+private:
+    struct Thread {
+        std::size_t pc;
+        std::size_t start;
+    };
+
+    /**
+     * Buffers of the searches. Names are matched one by one and allocating
+     * the buffers dominates, so each thread reuses its buffers for all
+     * searches. The compiled patterns are shared and stay unchanged.
+     */
+    struct Buffers {
+        /** position where an instruction was added to a thread list, for deduplication */
+        std::vector<std::size_t> mark;
+        std::vector<std::size_t> stack;
+        std::vector<Thread> current;
+        std::vector<Thread> next;
+    };
+
+    /** State of one search */
+    struct State {
+        State(const std::string &s, std::size_t b, Buffers &buf)
+            : str(s), begin(b), mark(buf.mark), stack(buf.stack) {}
+        const std::string &str;
+        std::size_t begin;
+        std::vector<std::size_t> &mark;
+        std::vector<std::size_t> &stack;
+    };
+
+    std::vector<Instruction> mProgram;
+    std::vector<CharClass> mClasses;
+
+    /** characters a match can start with */
+    CharClass mFirstChars;
+    bool mCanMatchEmpty;
+
+    void calculateFirstChars() {
+        std::vector<bool> visited(mProgram.size(), false);
+        std::vector<std::size_t> stack(1, 0);
+        while (!stack.empty()) {
+            const std::size_t pc = stack.back();
+            stack.pop_back();
+            if (visited[pc])
+                continue;
+            visited[pc] = true;
+            const Instruction &instruction = mProgram[pc];
+            switch (instruction.op) {
+            case Instruction::CHAR:
+                mFirstChars[instruction.x] = true;
+                break;
+            case Instruction::ANY:
+                mFirstChars |= ~CharClass().set('\n').set('\r');
+                break;
+            case Instruction::CLASS:
+                mFirstChars |= mClasses[instruction.x];
+                break;
+            case Instruction::SPLIT:
+                stack.push_back(instruction.y);
+                stack.push_back(instruction.x);
+                break;
+            case Instruction::JMP:
+                stack.push_back(instruction.x);
+                break;
+            case Instruction::MATCH:
+                mCanMatchEmpty = true;
+                break;
+            default:
+                // assertions don't consume characters
+                stack.push_back(pc + 1);
+                break;
+            }
+        }
+    }
+
+    bool isWordBoundary(const State &state, std::size_t pos) const {
+        const bool before = pos > state.begin && isWordChar(static_cast<unsigned char>(state.str[pos - 1]));
+        const bool after = pos < state.str.size() && isWordChar(static_cast<unsigned char>(state.str[pos]));
+        return before != after;
+    }
+
+    /** Add thread and follow all instructions that don't consume characters */
+    void addThread(State &state, std::vector<Thread> &list, std::size_t pc, std::size_t start, std::size_t pos) const {
+        state.stack.push_back(pc);
+        while (!state.stack.empty()) {
+            pc = state.stack.back();
+            state.stack.pop_back();
+            if (state.mark[pc] == pos)
+                continue;
+            state.mark[pc] = pos;
+
+            const Instruction &instruction = mProgram[pc];
+            switch (instruction.op) {
+            case Instruction::JMP:
+                state.stack.push_back(instruction.x);
+                break;
+            case Instruction::SPLIT:
+                state.stack.push_back(instruction.y);
+                state.stack.push_back(instruction.x);
+                break;
+            case Instruction::BOL:
+                if (pos == state.begin)
+                    state.stack.push_back(pc + 1);
+                break;
+            case Instruction::EOL:
+                if (pos == state.str.size())
+                    state.stack.push_back(pc + 1);
+                break;
+            case Instruction::WORD_BOUNDARY:
+                if (isWordBoundary(state, pos))
+                    state.stack.push_back(pc + 1);
+                break;
+            case Instruction::NOT_WORD_BOUNDARY:
+                if (!isWordBoundary(state, pos))
+                    state.stack.push_back(pc + 1);
+                break;
+            default: {
+                const Thread thread = { pc, start };
+                list.push_back(thread);
+                break;
+            }
+            }
+        }
+    }
+
+    Result run(const std::string &str, std::size_t begin, bool anchored, std::size_t *matchPos, std::size_t *matchLength, unsigned long long *budget) const {
+        static thread_local Buffers buffers;
+        buffers.mark.assign(mProgram.size(), std::string::npos);
+        buffers.stack.clear();
+        buffers.current.clear();
+        buffers.next.clear();
+        State state(str, begin, buffers);
+        std::vector<Thread> &current = buffers.current;
+        std::vector<Thread> &next = buffers.next;
+        bool matched = false;
+
+        for (std::size_t pos = begin; pos <= str.size(); ++pos) {
+            if (!matched && (!anchored || pos == begin)) {
+                if (!anchored && current.empty() && !mCanMatchEmpty) {
+                    // skip characters that can't start a match
+                    while (pos < str.size() && !mFirstChars[static_cast<unsigned char>(str[pos])])
+                        ++pos;
+                    if (pos == str.size())
+                        break;
+                }
+                addThread(state, current, 0, pos, pos);
+            }
+            if (current.empty()) {
+                if (matched || anchored)
+                    break;
+                continue;
+            }
+
+            const unsigned char c = pos < str.size() ? static_cast<unsigned char>(str[pos]) : 0;
+            for (std::size_t i = 0; i < current.size(); ++i) {
+                if (budget) {
+                    if (*budget == 0)
+                        return BUDGET_EXCEEDED;
+                    --*budget;
+                }
+
+                const Thread &thread = current[i];
+                const Instruction &instruction = mProgram[thread.pc];
+                bool consumed = false;
+                switch (instruction.op) {
+                case Instruction::CHAR:
+                    consumed = (pos < str.size() && c == instruction.x);
+                    break;
+                case Instruction::ANY:
+                    consumed = (pos < str.size() && c != '\n' && c != '\r');
+                    break;
+                case Instruction::CLASS:
+                    consumed = (pos < str.size() && mClasses[instruction.x][c]);
+                    break;
+                case Instruction::MATCH:
+                    if (anchored) {
+                        if (pos == str.size())
+                            return MATCH;
+                        break;
+                    }
+                    matched = true;
+                    *matchPos = thread.start;
+                    *matchLength = pos - thread.start;
+                    // threads with lower priority are not needed anymore
+                    i = current.size();
+                    break;
+                default:
+                    break;
+                }
+                if (consumed)
+                    addThread(state, next, thread.pc + 1, thread.start, pos + 1);
+            }
+            current.swap(next);
+            next.clear();
+        }
+
+        return matched ? MATCH : NOMATCH;
+    }
+};
+
+//-----------------------------------------------------------------------------
+
+/** std::regex backend */
+class StdRegex : public Regex {
+public:
+    explicit StdRegex(const std::string &pattern) : mRegex(pattern) {}
+
+    Result search(const std::string &str, std::size_t start, std::size_t *matchPos, std::size_t *matchLength, unsigned long long * /*budget*/) const OVERRIDE {
+        std::match_results<std::string::const_iterator> m;
+        if (!std::regex_search(str.begin() + start, str.end(), m, mRegex))
+            return NOMATCH;
+        *matchPos = start + m.position(0);
+        *matchLength = m.length(0);
+        return MATCH;
+    }
+
+    Result match(const std::string &str, unsigned long long * /*budget*/) const OVERRIDE {
+        return std::regex_match(str, mRegex) ? MATCH : NOMATCH;
+    }
+
+    const char *engineName() const OVERRIDE {
+        return "std";
+    }
+
+    bool countsBudget() const OVERRIDE {
+        return false;
+    }
+
+private:
+    std::regex mRegex;
+};
+
+}
+
+//-----------------------------------------------------------------------------
+
+std::shared_ptr<const Regex> Regex::create(const std::string &pattern, Engine engine)
+{
+    if (engine == AUTOMATIC) {
+        try {
+            return std::make_shared<AutomatonRegex>(pattern);
+        } catch (const Unsupported &) {
+            // std::regex handles the pattern, or throws if it is invalid
+        }
+    }
+    return std::make_shared<StdRegex>(pattern);
+}
@@ -0,0 +1,77 @@
+//-----------------------------------------------------------------------------
+#ifndef regexH
+#define regexH
+//-----------------------------------------------------------------------------
+
+#include "config.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Compiled regular expression (ECMAScript syntax) used by the rule and
+ * naming checks.
+ *
+ * Two backends are available:
+ * - automaton: Thompson NFA simulation (pike VM), the matching time is linear
+ *   in the length of the input. It handles the subset of ECMAScript without
+ *   backreferences and lookahead.
+ * - std: std::regex, used for patterns the automaton can't handle.
+ *
+ * Only the position and length of the complete match are calculated, there
+ * are no submatches.
+ */
+class CPPCHECKLIB Regex {
+public:
+    enum Engine {
+        AUTOMATIC,  ///< automaton if the pattern is supported, std::regex otherwise
+        STD         ///< always std::regex
+    };
+
+    enum Result {
+        NOMATCH,
+        MATCH,
+        BUDGET_EXCEEDED  ///< the match budget was used up before the search finished
+    };
+
+    virtual ~Regex() {}
+
+    /**
+     * @brief Compile a pattern
+     * @param pattern ECMAScript pattern
+     * @param engine wanted backend
+     * @return compiled pattern
+     * @throw std::regex_error if the pattern is invalid
+     */
+    static std::shared_ptr<const Regex> create(const std::string &pattern, Engine engine = AUTOMATIC);
+
+    /**
+     * @brief Search the first match in str, starting at position start. The
+     * text before start is not seen by the search, i.e. '^' matches at start.
+     * @param str text
+     * @param start start position of the search
+     * @param matchPos position of the match in str
+     * @param matchLength length of the match
+     * @param budget remaining match budget, NULL => unlimited. Each step of
+     * the automaton costs one unit. The std backend does not use the budget,
+     * see countsBudget().
+     */
+    virtual Result search(const std::string &str, std::size_t start, std::size_t *matchPos, std::size_t *matchLength, unsigned long long *budget) const = 0;
+
+    /** @brief Does the pattern match the complete text? */
+    virtual Result match(const std::string &str, unsigned long long *budget) const = 0;
+
+    /** @brief name of the backend */
+    virtual const char *engineName() const = 0;
+
+    /** @brief Is the match budget counted? std::regex can't be stopped, it ignores the budget */
+    virtual bool countsBudget() const = 0;
+};
+
+/// @}
+//-----------------------------------------------------------------------------
+#endif // regexH
@@ -0,0 +1,150 @@
+//-----------------------------------------------------------------------------
+#include "resultcache.h"
+
+#include "ctu.h"
+#include "preprocessor.h"
+#include "utils.h"
+
+#include <tinyxml2.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+//-----------------------------------------------------------------------------
+
+namespace {
+    // increment when the layout of the entries changes
+    const int resultCacheFormat = 1;
+
+    void deleteFileInfo(std::list<Check::FileInfo *> &fileInfo)
+    {
+        for (Check::FileInfo *fi : fileInfo)
+            delete fi;
+        fileInfo.clear();
+    }
+}
+
+ResultCache::ResultCache(const std::string &cacheDir, const std::string &sourceFile, unsigned long long checksum)
+    : mChecksum(checksum), mRecording(false), mMissingInclude(false), mMissingSystemInclude(false)
+{
+    // the name of the file, with the hash of the path for files with the same name
+    std::ostringstream fileName;
+    fileName << cacheDir;
+    if (!cacheDir.empty() && !endsWith(cacheDir, '/') && !endsWith(cacheDir, '\\'))
+        fileName << '/';
+    fileName << sourceFile.substr(sourceFile.find_last_of("/\\") + 1U)
+             << '-' << std::hex << fnv1a(sourceFile.data(), sourceFile.size()) << ".results";
+    mFileName = fileName.str();
+}
+
+ResultCache::~ResultCache()
+{
+    if (mRecording) {
+        Preprocessor::missingIncludeFlag |= mMissingInclude;
+        Preprocessor::missingSystemIncludeFlag |= mMissingSystemInclude;
+    }
+}
+
+bool ResultCache::load(std::list<ErrorLogger::ErrorMessage> &errors, std::list<Check::FileInfo *> &fileInfo) const
+{
+    tinyxml2::XMLDocument doc;
+    if (doc.LoadFile(mFileName.c_str()) != tinyxml2::XML_SUCCESS)
+        return false;
+
+    const tinyxml2::XMLElement * const root = doc.FirstChildElement("results");
+    if (!root || root->IntAttribute("format") != resultCacheFormat)
+        return false;
+    const char *checksum = root->Attribute("checksum");
+    if (!checksum || std::strtoull(checksum, nullptr, 16) != mChecksum)
+        return false;
+
+    std::list<ErrorLogger::ErrorMessage> loadedErrors;
+    std::list<Check::FileInfo *> loadedFileInfo;
+    for (const tinyxml2::XMLElement *e = root->FirstChildElement(); e; e = e->NextSiblingElement()) {
+        if (std::strcmp(e->Name(), "error") == 0) {
+            ErrorLogger::ErrorMessage msg;
+            if (!msg.deserialize(e->GetText() ? e->GetText() : "")) {
+                deleteFileInfo(loadedFileInfo);
+                return false;
+            }
+            loadedErrors.push_back(msg);
+        } else if (std::strcmp(e->Name(), "missingInclude") == 0) {
+            Preprocessor::missingIncludeFlag |= e->BoolAttribute("user");
+            Preprocessor::missingSystemIncludeFlag |= e->BoolAttribute("system");
+        } else if (std::strcmp(e->Name(), "FileInfo") == 0) {
+            const char *name = e->Attribute("check");
+            if (!name)
+                continue;
+            if (std::strcmp(name, "ctu") == 0) {
+                CTU::FileInfo *fi = new CTU::FileInfo;
+                fi->loadFromXml(e);
+                loadedFileInfo.push_back(fi);
+                continue;
+            }
+            for (const Check *check : Check::instances()) {
+                if (check->name() != name)
+                    continue;
+                Check::FileInfo *fi = check->loadFileInfoFromXml(e);
+                if (fi)
+                    loadedFileInfo.push_back(fi);
+                break;
+            }
+        }
+    }
+
+    errors.splice(errors.end(), loadedErrors);
+    fileInfo.splice(fileInfo.end(), loadedFileInfo);
+    return true;
+}
+
+void ResultCache::startRecording()
+{
+    mRecording = true;
+    mMissingInclude = Preprocessor::missingIncludeFlag;
+    mMissingSystemInclude = Preprocessor::missingSystemIncludeFlag;
+    Preprocessor::missingIncludeFlag = false;
+    Preprocessor::missingSystemIncludeFlag = false;
+}
+
+void ResultCache::addError(const ErrorLogger::ErrorMessage &msg)
+{
+    mErrors.push_back(msg.serialize());
+}
+
+void ResultCache::addFileInfo(const std::string &check, const Check::FileInfo *fileInfo)
+{
+    mFileInfo.emplace_back(check, fileInfo->toString());
+}
+
+bool ResultCache::save() const
+{
+    // written to a temporary file first, an interrupted run leaves no truncated cache
+    const std::string tempFileName = mFileName + ".tmp";
+    if (!write(tempFileName) || (std::rename(tempFileName.c_str(), mFileName.c_str()) != 0 &&
+                                 (std::remove(mFileName.c_str()) != 0 || std::rename(tempFileName.c_str(), mFileName.c_str()) != 0))) {
+        std::remove(tempFileName.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ResultCache::write(const std::string &fileName) const
+{
+    std::ofstream fout(fileName.c_str(), std::ios::binary);
+    if (!fout.is_open())
+        return false;
+    fout << "<?xml version=\"1.0\"?>\n"
+         << "<results format=\"" << resultCacheFormat << "\" checksum=\"" << std::hex << mChecksum << std::dec << "\">\n";
+    if (Preprocessor::missingIncludeFlag || Preprocessor::missingSystemIncludeFlag)
+        fout << "  <missingInclude user=\"" << (Preprocessor::missingIncludeFlag ? "true" : "false")
+             << "\" system=\"" << (Preprocessor::missingSystemIncludeFlag ? "true" : "false") << "\"/>\n";
+    for (const std::string &error : mErrors)
+        fout << "  <error>" << ErrorLogger::escapeXml(error) << "</error>\n";
+    for (const std::pair<std::string, std::string> &fileInfo : mFileInfo)
+        fout << "  <FileInfo check=\"" << ErrorLogger::escapeXml(fileInfo.first) << "\">\n" << fileInfo.second << "  </FileInfo>\n";
+    fout << "</results>\n";
+    return fout.good();
+}
@@ -0,0 +1,82 @@
+//-----------------------------------------------------------------------------
+#ifndef resultcacheH
+#define resultcacheH
+//-----------------------------------------------------------------------------
+
+#include "check.h"
+#include "config.h"
+#include "errorlogger.h"
+
+#include <list>
+#include <string>
+#include <utility>
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Results of a checked file, kept in the cache directory (--cache-dir).
+ *
+ * The entry of a file contains the reported errors and the data of the whole
+ * program analysis. It is valid as long as the checksum is the same, see
+ * Preprocessor::calculateChecksum(). The checksum covers the code of the file
+ * and of the files it #uses, so a change in a library script invalidates the
+ * entries of all scripts that use it.
+ *
+ * The errors are recorded before the suppressions are applied, they are
+ * reported again through the error logger when the entry is loaded. The
+ * missing include flags of the Preprocessor are recorded for the file, too.
+ */
+class CPPCHECKLIB ResultCache {
+public:
+    /**
+     * @param cacheDir directory of the entries
+     * @param sourceFile checked file
+     * @param checksum checksum of the code and the settings
+     */
+    ResultCache(const std::string &cacheDir, const std::string &sourceFile, unsigned long long checksum);
+    ~ResultCache();
+
+    /**
+     * @brief Load the entry of the file
+     * @param errors the recorded errors
+     * @param fileInfo the recorded whole program analysis data, the caller
+     * owns the objects
+     * @return false if there is no entry with the checksum or it is invalid
+     */
+    bool load(std::list<ErrorLogger::ErrorMessage> &errors, std::list<Check::FileInfo *> &fileInfo) const;
+
+    /**
+     * @brief Start recording the results of the file. The missing include
+     * flags of the files checked before are restored by the destructor.
+     */
+    void startRecording();
+
+    /** @brief Record a reported error */
+    void addError(const ErrorLogger::ErrorMessage &msg);
+
+    /**
+     * @brief Record whole program analysis data
+     * @param check name of the check, "ctu" for the CTU::FileInfo
+     * @param fileInfo data of the check
+     */
+    void addFileInfo(const std::string &check, const Check::FileInfo *fileInfo);
+
+    /** @brief Write the recorded results, replacing the entry of the file */
+    bool save() const;
+
+private:
+    bool write(const std::string &fileName) const;
+
+    std::string mFileName;
+    unsigned long long mChecksum;
+    bool mRecording;
+    bool mMissingInclude;
+    bool mMissingSystemInclude;
+    std::list<std::string> mErrors;
+    std::list<std::pair<std::string, std::string>> mFileInfo;
+};
+
+/// @}
+//-----------------------------------------------------------------------------
+#endif // resultcacheH
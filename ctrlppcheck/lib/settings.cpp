@@ -44,23 +44,28 @@ Settings::Settings()
       debugwarnings(false),
       debugtemplate(false),
       maxCtuDepth(2),
+      maxMemory(0),
       dump(false),
       exceptionHandling(false),
       inconclusive(false),
       jointSuppressionReport(false),
       experimental(false),
       experimentalFast(false),
+      legacyKnownVariables(false),
       quiet(false),
       inlineSuppressions(false),
       verbose(false),
       relativePaths(false),
       xml(false), xml_version(2),
+      outputFormat(OUTPUT_TEXT),
       exitCode(0),
       showtime(SHOWTIME_NONE),
       preprocessOnly(false),
       maxConfigs(12),
       enforcedLang(None),
       reportProgress(false),
+      regexEngine(Regex::AUTOMATIC),
+      ruleMatchBudget(0),
       checkConfiguration(false),
       checkLibrary(false)
 {
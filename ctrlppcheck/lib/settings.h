@@ -26,10 +26,13 @@
 #include "importproject.h"
 #include "library.h"
 #include "platform.h"
+#include "regex.h"
 #include "suppressions.h"
 #include "timer.h"
 
+#include <cstddef>
 #include <list>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -40,6 +43,7 @@
 namespace ValueFlow {
     class Value;
 }
+struct NamingRuleFile;
 
 /// @addtogroup Core
 /// @{
@@ -93,6 +97,9 @@ public:
     /** @brief --max-ctu-depth */
     int maxCtuDepth;
 
+    /** @brief Memory budget of the analysis data of a file in bytes, 0 => unlimited (--max-memory=&lt;MiB&gt;) */
+    std::size_t maxMemory;
+
     /** @brief Is --dump given? */
     bool dump;
     std::string dumpFile;
@@ -121,6 +128,11 @@ public:
      * and that we can remove the slow simplifications. */
     bool experimentalFast;
 
+    /** @brief Is --legacy-known-variables given? Use the old token pattern
+     * based simplifyKnownVariables instead of the ValueFlow values when the
+     * token list is simplified. */
+    bool legacyKnownVariables;
+
     /** @brief Is --quiet given? */
     bool quiet;
 
@@ -152,12 +164,28 @@ public:
     /** @brief naming rules file path (--naming-rule-file) */
     std::string namingRuleFile;
 
+    /** @brief parsed naming rules, loaded by CppCheck before the first file is checked */
+    std::shared_ptr<const NamingRuleFile> namingRules;
+
+    /** @brief directory of the cached results of the checked files (--cache-dir=&lt;dir&gt;) */
+    std::string cacheDir;
+
+    /** @brief directory of the library snapshots and the token images of the #uses libraries (--library-cache=&lt;dir&gt;) */
+    std::string libraryCacheDir;
+
     /** @brief write XML results (--xml) */
     bool xml;
 
     /** @brief XML version (--xml-version=..) */
     int xml_version;
 
+    enum OutputFormat {
+        OUTPUT_TEXT, OUTPUT_XML, OUTPUT_JSONL, OUTPUT_SARIF
+    };
+
+    /** @brief format of the results (--output-format=.., --xml) */
+    OutputFormat outputFormat;
+
     /** @brief If errors are found, this value is returned from main().
         Default value is 0. */
     int exitCode;
@@ -253,7 +281,8 @@ public:
         Rule()
             : tokenlist("simple")         // use simple tokenlist
             , id("rule")                  // default id
-            , severity(Severity::style) { // default severity
+            , severity(Severity::style)   // default severity
+            , budget(0) {                 // use ruleMatchBudget
         }
 
         std::string tokenlist;
@@ -261,6 +290,8 @@ public:
         std::string id;
         std::string summary;
         Severity::SeverityType severity;
+        /** match budget per token list, 0 => ruleMatchBudget */
+        unsigned long long budget;
     };
 
     /**
@@ -268,6 +299,13 @@ public:
      */
     std::list<Rule> rules;
 
+    /** @brief regex backend for the rules and naming rules (--regex-engine=auto|std) */
+    Regex::Engine regexEngine;
+
+    /** @brief Default match budget of a rule per token list, 0 => unlimited.
+        One unit is one step of the regex automaton. (--rule-match-budget=N) */
+    unsigned long long ruleMatchBudget;
+
     /** Is the 'configuration checking' wanted? */
     bool checkConfiguration;
 
@@ -306,9 +306,22 @@ bool Suppressions::isSuppressedLocal(const Suppressions::ErrorMessage &errmsg)
     return false;
 }
 
+bool Suppressions::isSuppressedEverywhere(const std::string &errorId) const
+{
+    for (const Suppression &s : mSuppressions) {
+        if (s.lineNumber != Suppression::NO_LINE || !s.symbolName.empty())
+            continue;
+        if (!s.fileName.empty() && s.fileName != "*")
+            continue;
+        if (matchglob(s.errorId, errorId))
+            return true;
+    }
+    return false;
+}
+
 void Suppressions::dump(std::ostream & out)
 {
-    out << "  <suppressions>" << std::endl;
+    out << "  <suppressions>\n";
     for (const Suppression &suppression : mSuppressions) {
         out << "    <suppression";
         out << " errorId=\"" << ErrorLogger::toxml(suppression.errorId) << '"';
@@ -318,9 +331,9 @@ void Suppressions::dump(std::ostream & out)
             out << " lineNumber=\"" << suppression.lineNumber << '"';
         if (!suppression.symbolName.empty())
             out << " symbolName=\"" << ErrorLogger::toxml(suppression.symbolName) << '\"';
-        out << " />" << std::endl;
+        out << " />\n";
     }
-    out << "  </suppressions>" << std::endl;
+    out << "  </suppressions>\n";
 }
 
 #include <iostream>
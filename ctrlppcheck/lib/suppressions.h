@@ -144,6 +144,13 @@ public:
      */
     bool isSuppressedLocal(const ErrorMessage &errmsg);
 
+    /**
+     * @brief Returns true if the error id is suppressed in all files and lines.
+     * @param errorId error id
+     * @return true if there is a global suppression for this id
+     */
+    bool isSuppressedEverywhere(const std::string &errorId) const;
+
     /**
      * @brief Create an xml dump of suppressions
      * @param out stream to write XML to
@@ -0,0 +1,181 @@
+//-----------------------------------------------------------------------------
+#include "keywords.h"
+
+#include <cstddef>
+#include <cstdint>
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+/// All keywords: X(name, flags, type)
+#define CTRL_KEYWORDS(X) \
+    X("anytype",            0,                       ANYTYPE)             \
+    X("mixed",              0,                       MIXED)               \
+    X("char",               0,                       CHAR)                \
+    X("float",              0,                       FLOAT)               \
+    X("int",                0,                       INT)                 \
+    X("uint",               0,                       UINT)                \
+    X("long",               0,                       LONG)                \
+    X("ulong",              0,                       ULONG)               \
+    X("short",              0,                       SHORT)               \
+    X("function_ptr",       0,                       FUNCTION_PTR)        \
+    X("shared_ptr",         0,                       SHARED_PTR)          \
+    X("nullptr",            RESERVED,                NULL_PTR)            \
+    X("time",               0,                       TIME)                \
+    X("string",             0,                       STRING)              \
+    X("langString",         0,                       LANG_STRING)         \
+    X("bool",               RESERVED,                BOOL)                \
+    X("bit32",              0,                       BIT32)               \
+    X("bit64",              0,                       BIT64)               \
+    X("file",               0,                       FILE)                \
+    X("blob",               0,                       BLOB)                \
+    X("atime",              0,                       ATIME)               \
+    X("errClass",           0,                       ERR_CLASS)           \
+    X("dbRecordset",        0,                       DB_RECORDSET)        \
+    X("dbConnection",       0,                       DB_CONNECTION)       \
+    X("dbCommand",          0,                       DB_COMMAND)          \
+    X("shape",              0,                       SHAPE)               \
+    X("idispatch",          0,                       IDISPATCH)           \
+    X("mapping",            0,                       MAPPING)             \
+    X("va_list",            0,                       VA_LIST)             \
+    X("dyn_int",            0,                       DYN_INT)             \
+    X("dyn_uint",           0,                       DYN_UINT)            \
+    X("dyn_long",           0,                       DYN_LONG)            \
+    X("dyn_ulong",          0,                       DYN_ULONG)           \
+    X("dyn_float",          0,                       DYN_FLOAT)           \
+    X("dyn_time",           0,                       DYN_TIME)            \
+    X("dyn_atime",          0,                       DYN_ATIME)           \
+    X("dyn_string",         0,                       DYN_STRING)          \
+    X("dyn_langString",     0,                       DYN_LANG_STRING)     \
+    X("dyn_bool",           0,                       DYN_BOOL)            \
+    X("dyn_bit32",          0,                       DYN_BIT32)           \
+    X("dyn_bit64",          0,                       DYN_BIT64)           \
+    X("dyn_char",           0,                       DYN_CHAR)            \
+    X("dyn_blob",           0,                       DYN_BLOB)            \
+    X("dyn_anytype",        0,                       DYN_ANYTYPE)         \
+    X("dyn_mixed",          0,                       DYN_MIXED)           \
+    X("dyn_errClass",       0,                       DYN_ERR_CLASS)       \
+    X("dyn_mapping",        0,                       DYN_MAPPING)         \
+    X("dyn_dbConnection",   0,                       DYN_DB_CONNECTION)   \
+    X("dyn_dbCommand",      0,                       DYN_DB_COMMAND)      \
+    X("dyn_dbRecordset",    0,                       DYN_DB_RECORDSET)    \
+    X("dyn_shape",          0,                       DYN_SHAPE)           \
+    X("dyn_function_ptr",   0,                       DYN_FUNCTION_PTR)    \
+    X("dyn_dyn_int",        0,                       DYN_DYN_INT)         \
+    X("dyn_dyn_uint",       0,                       DYN_DYN_UINT)        \
+    X("dyn_dyn_long",       0,                       DYN_DYN_LONG)        \
+    X("dyn_dyn_ulong",      0,                       DYN_DYN_ULONG)       \
+    X("dyn_dyn_float",      0,                       DYN_DYN_FLOAT)       \
+    X("dyn_dyn_time",       0,                       DYN_DYN_TIME)        \
+    X("dyn_dyn_atime",      0,                       DYN_DYN_ATIME)       \
+    X("dyn_dyn_string",     0,                       DYN_DYN_STRING)      \
+    X("dyn_dyn_langString", 0,                       DYN_DYN_LANG_STRING) \
+    X("dyn_dyn_bool",       0,                       DYN_DYN_BOOL)        \
+    X("dyn_dyn_bit32",      0,                       DYN_DYN_BIT32)       \
+    X("dyn_dyn_bit64",      0,                       DYN_DYN_BIT64)       \
+    X("dyn_dyn_char",       0,                       DYN_DYN_CHAR)        \
+    X("dyn_dyn_anytype",    0,                       DYN_DYN_ANYTYPE)     \
+    X("dyn_dyn_mixed",      0,                       DYN_DYN_MIXED)       \
+    X("dyn_dyn_errClass",   0,                       DYN_DYN_ERR_CLASS)   \
+    X("vector",             0,                       VECTOR)              \
+    X("do",                 CONTROL_FLOW | RESERVED, UNKNOWN_TYPE)        \
+    X("if",                 CONTROL_FLOW | RESERVED, UNKNOWN_TYPE)        \
+    X("else",               CONTROL_FLOW | RESERVED, UNKNOWN_TYPE)        \
+    X("for",                CONTROL_FLOW | RESERVED, UNKNOWN_TYPE)        \
+    X("while",              CONTROL_FLOW | RESERVED, UNKNOWN_TYPE)        \
+    X("switch",             CONTROL_FLOW | RESERVED, UNKNOWN_TYPE)        \
+    X("case",               CONTROL_FLOW | RESERVED, UNKNOWN_TYPE)        \
+    X("break",              CONTROL_FLOW | RESERVED, UNKNOWN_TYPE)        \
+    X("continue",           CONTROL_FLOW | RESERVED, UNKNOWN_TYPE)        \
+    X("return",             CONTROL_FLOW | RESERVED, UNKNOWN_TYPE)        \
+    X("default",            CONTROL_FLOW | RESERVED, UNKNOWN_TYPE)        \
+    X("try",                CONTROL_FLOW | RESERVED, UNKNOWN_TYPE)        \
+    X("catch",              CONTROL_FLOW | RESERVED, UNKNOWN_TYPE)        \
+    X("finally",            CONTROL_FLOW,            UNKNOWN_TYPE)        \
+    X("inline",             RESERVED | NOT_USED,     UNKNOWN_TYPE)        \
+    X("extern",             RESERVED | NOT_USED,     UNKNOWN_TYPE)        \
+    X("restrict",           RESERVED | NOT_USED,     UNKNOWN_TYPE)        \
+    X("auto",               RESERVED | NOT_USED,     UNKNOWN_TYPE)        \
+    X("typedef",            RESERVED | NOT_USED,     UNKNOWN_TYPE)        \
+    X("volatile",           RESERVED | NOT_USED,     UNKNOWN_TYPE)        \
+    X("register",           RESERVED | NOT_USED,     UNKNOWN_TYPE)        \
+    X("goto",               RESERVED | NOT_USED,     UNKNOWN_TYPE)        \
+    X("const",              RESERVED,                UNKNOWN_TYPE)        \
+    X("enum",               RESERVED,                UNKNOWN_TYPE)        \
+    X("static",             RESERVED,                UNKNOWN_TYPE)        \
+    X("struct",             RESERVED,                UNKNOWN_TYPE)        \
+    X("void",               RESERVED,                UNKNOWN_TYPE)        \
+    X("class",              RESERVED,                UNKNOWN_TYPE)        \
+    X("delete",             RESERVED,                UNKNOWN_TYPE)        \
+    X("false",              RESERVED,                UNKNOWN_TYPE)        \
+    X("global",             RESERVED,                UNKNOWN_TYPE)        \
+    X("new",                RESERVED,                UNKNOWN_TYPE)        \
+    X("private",            RESERVED,                UNKNOWN_TYPE)        \
+    X("protected",          RESERVED,                UNKNOWN_TYPE)        \
+    X("public",             RESERVED,                UNKNOWN_TYPE)        \
+    X("synchronized",       RESERVED,                UNKNOWN_TYPE)        \
+    X("true",               RESERVED,                UNKNOWN_TYPE)        \
+    X("this",               RESERVED,                UNKNOWN_TYPE)       
+
+//-----------------------------------------------------------------------------
+/// Seed of the hash, chosen so that all names have different slots.
+const std::uint32_t KEYWORD_HASH_SEED = 2166156519U;
+
+/// Number of bits of a slot, the table has 2^KEYWORD_SLOT_BITS slots.
+const unsigned int KEYWORD_SLOT_BITS = 9;
+
+//-----------------------------------------------------------------------------
+/// FNV-1a hash, evaluated at compile time for the names of the table.
+constexpr std::uint32_t keywordHash(const char *str, std::size_t length, std::uint32_t hash = KEYWORD_HASH_SEED)
+{
+    return length == 0 ? hash : keywordHash(str + 1, length - 1, (hash ^ static_cast<unsigned char>(*str)) * 16777619U);
+}
+
+constexpr std::uint32_t keywordSlot(const char *str, std::size_t length)
+{
+    return keywordHash(str, length) >> (32 - KEYWORD_SLOT_BITS);
+}
+
+//-----------------------------------------------------------------------------
+constexpr std::size_t maxLength(const std::size_t *lengths, std::size_t count, std::size_t result = 0)
+{
+    return count == 0 ? result : maxLength(lengths + 1, count - 1, lengths[0] > result ? lengths[0] : result);
+}
+
+#define CTRL_KEYWORD_LENGTH(name, flags, type) sizeof(name) - 1,
+constexpr std::size_t keywordLengths[] = { CTRL_KEYWORDS(CTRL_KEYWORD_LENGTH) };
+#undef CTRL_KEYWORD_LENGTH
+
+constexpr std::size_t maxKeywordLength = maxLength(keywordLengths, sizeof(keywordLengths) / sizeof(keywordLengths[0]));
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+Keywords::Keyword Keywords::classify(const std::string &name)
+{
+    const Keyword none = { 0, ValueType::Type::UNKNOWN_TYPE };
+    if (name.empty() || name.size() > maxKeywordLength)
+        return none;
+
+    // Each name has its own case label. When a new name gets the slot of
+    // another one, the compiler reports a duplicate case value and the
+    // seed must be changed.
+    switch (keywordSlot(name.data(), name.size()))
+    {
+#define CTRL_KEYWORD_CASE(str, flags, type)                                 \
+    case keywordSlot(str, sizeof(str) - 1):                                 \
+        if (name == str)                                                    \
+        {                                                                   \
+            const Keyword keyword = { flags, ValueType::Type::type };       \
+            return keyword;                                                 \
+        }                                                                   \
+        break;
+    CTRL_KEYWORDS(CTRL_KEYWORD_CASE)
+#undef CTRL_KEYWORD_CASE
+    default:
+        break;
+    }
+    return none;
+}
@@ -0,0 +1,45 @@
+//-----------------------------------------------------------------------------
+#ifndef keywordsH
+#define keywordsH
+//-----------------------------------------------------------------------------
+
+#include "../config.h"
+#include "valuetype.h"
+
+#include <string>
+
+//-----------------------------------------------------------------------------
+/**
+  Classification of the ctrl keywords, built-in types and reserved names.
+
+  The names are looked up in a perfect hash table, the hash values of all
+  names are calculated at compile time. The table is shared by the token
+  list, the symbol database and the value types.
+*/
+class CPPCHECKLIB Keywords
+{
+public:
+    enum Flags
+    {
+        CONTROL_FLOW = 1 << 0,  ///< do, if, return, try, ...
+        RESERVED     = 1 << 1,  ///< reserved name, can't be used for functions and variables
+        NOT_USED     = 1 << 2   ///< reserved, but not used by ctrl (goto, typedef, ...)
+    };
+
+    struct Keyword
+    {
+        unsigned int flags;
+        ValueType::Type type;   ///< built-in type, UNKNOWN_TYPE for other keywords
+    };
+
+    //-------------------------------------------------------------------------
+    /**
+       Classify a name.
+       @param name token string
+       @return flags 0 and type UNKNOWN_TYPE if the name is no keyword
+    */
+    static Keyword classify(const std::string &name);
+};
+
+//-----------------------------------------------------------------------------
+#endif // keywordsH
@@ -2,54 +2,19 @@
 //-----------------------------------------------------------------------------
 #include "symboldatabase.h"
 
+#include "../astutils.h"
+#include "keywords.h"
 #include "symbolutils.h"
 #include "variable.h"
 
 #include <cassert>
 #include <iomanip>
 
-//-----------------------------------------------------------------------------
-
-namespace
-{
-
-/// reseved keyowrds
-/// not used, but reserved keywords
-#define CTRL_NOTUSED_KEYWORDS          \
-    "inline", "extern", "restrict",    \
-        "auto", "typedef", "volatile", \
-        "register", "goto"
-
-const std::set<std::string> ctrl_reserved_notUsed_keywords = {CTRL_NOTUSED_KEYWORDS};
-
-// all keywords
-const std::set<std::string> ctrl_reserved_keywords = {
-    CTRL_NOTUSED_KEYWORDS,
-
-    "break", "case", "const", "continue", "default", "do",
-    "else", "enum", "for", "goto", "if",
-    "return",
-    "static", "struct", "switch", "void",
-    "while",
-    "bool", "catch", "class",
-    "delete",
-    "false",
-    "global",
-    "new",
-    "nullptr",
-    "private", "protected", "public",
-    "synchronized",
-    "true", "try",
-    "this"};
-} // namespace
-
-//-----------------------------------------------------------------------------
-
 //-----------------------------------------------------------------------------
 bool SymbolDatabase::isReservedName(const std::string &iName)
 {
-    return (ValueType::typeFromString(iName) == ValueType::Type::UNKNOWN_TYPE) &&
-           (ctrl_reserved_keywords.find(iName) != ctrl_reserved_keywords.cend());
+    const Keywords::Keyword keyword = Keywords::classify(iName);
+    return (keyword.type == ValueType::Type::UNKNOWN_TYPE) && (keyword.flags & Keywords::RESERVED) != 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -1269,6 +1234,17 @@ SymbolDatabase::~SymbolDatabase()
     }
 }
 
+//-----------------------------------------------------------------------------
+const VariableChangeIndex *SymbolDatabase::getVariableChangeIndex(const Scope *functionScope) const
+{
+    if (!functionScope || !functionScope->bodyStart || !functionScope->bodyEnd)
+        return nullptr;
+    std::shared_ptr<const VariableChangeIndex> &index = mVariableChangeIndex[functionScope];
+    if (!index)
+        index = std::make_shared<const VariableChangeIndex>(functionScope, mSettings);
+    return index.get();
+}
+
 //-----------------------------------------------------------------------------
 void SymbolDatabase::validate() const
 {
@@ -2018,7 +1994,7 @@ void SymbolDatabase::printXml(std::ostream &out) const
     std::set<const Variable *> variables;
 
     // Scopes..
-    out << "  <scopes>" << std::endl;
+    out << "  <scopes>\n";
     for (std::list<Scope>::const_iterator scope = scopeList.begin(); scope != scopeList.end(); ++scope)
     {
         out << "    <scope";
@@ -2038,62 +2014,62 @@ void SymbolDatabase::printXml(std::ostream &out) const
         if (scope->function)
             out << " function=\"" << scope->function << "\"";
         if (scope->functionList.empty() && scope->varlist.empty() && scope->enumeratorList.empty())
-            out << "/>" << std::endl;
+            out << "/>\n";
         else
         {
-            out << '>' << std::endl;
+            out << ">\n";
             if (!scope->functionList.empty())
             {
-                out << "      <functionList>" << std::endl;
+                out << "      <functionList>\n";
                 for (std::list<Function>::const_iterator function = scope->functionList.begin(); function != scope->functionList.end(); ++function)
                 {
                     out << "        <function id=\"" << &*function << "\" tokenDef=\"" << function->tokenDef << "\" name=\"" << ErrorLogger::toxml(function->name()) << '\"';
                     out << " type=\"" << (function->type == Function::eConstructor ? "Constructor" : function->type == Function::eDestructor ? "Destructor" : function->type == Function::eFunction ? "Function" : "Unknown") << '\"';
                     out << " access=\"" << accessControlToString(function->access) << '\"';
                     if (function->argCount() == 0U)
-                        out << "/>" << std::endl;
+                        out << "/>\n";
                     else
                     {
-                        out << ">" << std::endl;
+                        out << ">\n";
                         for (unsigned int argnr = 0; argnr < function->argCount(); ++argnr)
                         {
                             const Variable *arg = function->getArgumentVar(argnr);
-                            out << "          <arg nr=\"" << argnr + 1 << "\" variable=\"" << arg << "\"/>" << std::endl;
+                            out << "          <arg nr=\"" << argnr + 1 << "\" variable=\"" << arg << "\"/>\n";
                             variables.insert(arg);
                         }
-                        out << "        </function>" << std::endl;
+                        out << "        </function>\n";
                     }
                 }
-                out << "      </functionList>" << std::endl;
+                out << "      </functionList>\n";
             }
             if (!scope->varlist.empty())
             {
-                out << "      <varlist>" << std::endl;
+                out << "      <varlist>\n";
                 for (std::list<Variable>::const_iterator var = scope->varlist.begin(); var != scope->varlist.end(); ++var)
-                    out << "        <var id=\"" << &*var << "\"/>" << std::endl;
-                out << "      </varlist>" << std::endl;
+                    out << "        <var id=\"" << &*var << "\"/>\n";
+                out << "      </varlist>\n";
             }
             if (!scope->enumeratorList.empty())
             {
-                out << "      <enumeratorList>" << std::endl;
+                out << "      <enumeratorList>\n";
                 for (std::size_t i = 0, end = scope->enumeratorList.size(); i < end; ++i)
                 {
                     out << "        <enumerator id=\"" << scope->enumeratorList[i].name << "\"";
                     out << " name=\"" << scope->enumeratorList[i].name->str() << "\"";
-                    out << "/>" << std::endl;
+                    out << "/>\n";
                 }
-                out << "      </enumeratorList>" << std::endl;
+                out << "      </enumeratorList>\n";
             }
 
-            out << "    </scope>" << std::endl;
+            out << "    </scope>\n";
         }
     }
-    out << "  </scopes>" << std::endl;
+    out << "  </scopes>\n";
 
     // Variables..
     for (const Variable *var : mVariableList)
         variables.insert(var);
-    out << "  <variables>" << std::endl;
+    out << "  <variables>\n";
     for (const Variable *var : variables)
     {
         if (!var)
@@ -2113,9 +2089,9 @@ void SymbolDatabase::printXml(std::ostream &out) const
         out << " isLocal=\"" << var->isLocal() << '\"';
         out << " isReference=\"" << var->isReference() << '\"';
         out << " isStatic=\"" << var->isStatic() << '\"';
-        out << "/>" << std::endl;
+        out << "/>\n";
     }
-    out << "  </variables>" << std::endl;
+    out << "  </variables>\n";
     out << std::resetiosflags(std::ios::boolalpha);
 }
 
@@ -2793,7 +2769,7 @@ void SymbolDatabase::setValueType(Token *tok, const Enumerator &enumerator)
 //-----------------------------------------------------------------------------
 void SymbolDatabase::setValueType(Token *tok, const ValueType &valuetype)
 {
-    tok->setValueType(new ValueType(valuetype));
+    tok->setValueType(mTokenizer->list.internValueType(valuetype));
     Token *parent = const_cast<Token *>(tok->astParent());
     if (!parent || parent->valueType())
         return;
@@ -2914,7 +2890,7 @@ void SymbolDatabase::setValueTypeInTokenList()
     {
         if (tok->isNumber())
         {
-            if (MathLib::isFloat(tok->str()))
+            if (tok->isFloatNumber())
             {
                 ValueType::Type type = ValueType::Type::DOUBLE;
                 const char suffix = tok->str()[tok->str().size() - 1];
@@ -2924,11 +2900,11 @@ void SymbolDatabase::setValueTypeInTokenList()
                     type = ValueType::Type::LONG;
                 setValueType(tok, ValueType(type, 0U));
             }
-            else if (MathLib::isInt(tok->str()))
+            else if (tok->isIntNumber())
             {
                 const bool unsignedSuffix = (tok->str().find_last_of("uU") != std::string::npos);
                 ValueType::Type type;
-                const MathLib::bigint value = MathLib::toLongNumber(tok->str());
+                const MathLib::bigint value = tok->getIntNumber();
                 if (mSettings->platformType == cppcheck::Platform::Unspecified)
                     type = ValueType::Type::INT;
                 else if (mSettings->isIntValue(unsignedSuffix ? (value >> 1) : value))
@@ -3102,4 +3078,4 @@ void SymbolDatabase::setValueTypeInTokenList()
     createSymbolDatabaseSetVariablePointers();
 }
 
-//-----------------------------------------------------------------------------
\ No newline at end of file
+//-----------------------------------------------------------------------------
\ No newline at end of file
@@ -12,6 +12,11 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <memory>
+
+//-----------------------------------------------------------------------------
+
+class VariableChangeIndex;
 
 //-----------------------------------------------------------------------------
 
@@ -130,6 +135,15 @@ public:
     unsigned int sizeOfType(const Token *type) const;
 
     //-------------------------------------------------------------------------
+    /**
+     * @brief Def-use index of a function body, built on first use.
+     * The token list must not be changed while the symbol database exists.
+     * @param functionScope scope of the function
+     * @return the index or NULL if the scope has no body
+     */
+    const VariableChangeIndex *getVariableChangeIndex(const Scope *functionScope) const;
+
+    //-------------------------------------------------------------------------
 
 private:
     friend class Scope;
@@ -198,6 +212,10 @@ private:
     /** "negative cache" list of tokens that we find are not enumeration values */
     mutable std::set<std::string> mTokensThatAreNotEnumeratorValues;
 
+    //-------------------------------------------------------------------------
+    /** def-use index per function scope, see getVariableChangeIndex() */
+    mutable std::map<const Scope *, std::shared_ptr<const VariableChangeIndex>> mVariableChangeIndex;
+
     //-------------------------------------------------------------------------
 };
 
@@ -1,6 +1,7 @@
 //-----------------------------------------------------------------------------
 #include "valuetype.h"
 
+#include "keywords.h"
 #include "symbolutils.h"
 #include "scope.h"
 
@@ -14,296 +15,9 @@ ValueType ValueType::parseDecl(const Token *type, const Settings *settings)
 }
 
 //-----------------------------------------------------------------------------
-// the CCN is terrible big, but it is really easy to read.
 ValueType::Type ValueType::typeFromString(const std::string &typestr)
 {
-    // standard ctrl variables
-    if ("anytype" == typestr)
-    {
-        return ValueType::Type::ANYTYPE;
-    }
-    if ("mixed" == typestr)
-    {
-        return ValueType::Type::MIXED;
-    }
-    if ("char" == typestr)
-    {
-        return ValueType::Type::CHAR;
-    }
-    if ("float" == typestr)
-    {
-        return ValueType::Type::FLOAT;
-    }
-    if ("int" == typestr)
-    {
-        return ValueType::Type::INT;
-    }
-    if ("uint" == typestr)
-    {
-        return ValueType::Type::UINT;
-    }
-    if ("long" == typestr)
-    {
-        return ValueType::Type::LONG;
-    }
-    if ("ulong" == typestr)
-    {
-        return ValueType::Type::ULONG;
-    }
-    if ("short" == typestr)
-    {
-        return ValueType::Type::SHORT;
-    }
-    //if ("signed" == typestr) { return ValueType::Type::SIGNED; }
-    //if ("unsigned" == typestr) { return ValueType::Type::UNSIGNED; }
-    if ("function_ptr" == typestr)
-    {
-        return ValueType::Type::FUNCTION_PTR;
-    }
-    if ("shared_ptr" == typestr)
-    {
-        return ValueType::Type::SHARED_PTR;
-    }
-    if ("nullptr" == typestr)
-    {
-        return ValueType::Type::NULL_PTR;
-    }
-    if ("time" == typestr)
-    {
-        return ValueType::Type::TIME;
-    }
-    if ("string" == typestr)
-    {
-        return ValueType::Type::STRING;
-    }
-    if ("langString" == typestr)
-    {
-        return ValueType::Type::LANG_STRING;
-    }
-    if ("bool" == typestr)
-    {
-        return ValueType::Type::BOOL;
-    }
-    if ("bit32" == typestr)
-    {
-        return ValueType::Type::BIT32;
-    }
-    if ("bit64" == typestr)
-    {
-        return ValueType::Type::BIT64;
-    }
-    if ("file" == typestr)
-    {
-        return ValueType::Type::FILE;
-    }
-    if ("blob" == typestr)
-    {
-        return ValueType::Type::BLOB;
-    }
-    if ("atime" == typestr)
-    {
-        return ValueType::Type::ATIME;
-    }
-    if ("errClass" == typestr)
-    {
-        return ValueType::Type::ERR_CLASS;
-    }
-    if ("dbRecordset" == typestr)
-    {
-        return ValueType::Type::DB_RECORDSET;
-    }
-    if ("dbConnection" == typestr)
-    {
-        return ValueType::Type::DB_CONNECTION;
-    }
-    if ("dbCommand" == typestr)
-    {
-        return ValueType::Type::DB_COMMAND;
-    }
-    if ("shape" == typestr)
-    {
-        return ValueType::Type::SHAPE;
-    }
-    if ("idispatch" == typestr)
-    {
-        return ValueType::Type::IDISPATCH;
-    }
-    if ("mapping" == typestr)
-    {
-        return ValueType::Type::MAPPING;
-    }
-    if ("va_list" == typestr)
-    {
-        return ValueType::Type::VA_LIST;
-    }
-
-    // dyn variables
-    if ("dyn_int" == typestr)
-    {
-        return ValueType::Type::DYN_INT;
-    }
-    if ("dyn_uint" == typestr)
-    {
-        return ValueType::Type::DYN_UINT;
-    }
-    if ("dyn_long" == typestr)
-    {
-        return ValueType::Type::DYN_LONG;
-    }
-    if ("dyn_ulong" == typestr)
-    {
-        return ValueType::Type::DYN_ULONG;
-    }
-    if ("dyn_float" == typestr)
-    {
-        return ValueType::Type::DYN_FLOAT;
-    }
-    if ("dyn_time" == typestr)
-    {
-        return ValueType::Type::DYN_TIME;
-    }
-    if ("dyn_atime" == typestr)
-    {
-        return ValueType::Type::DYN_ATIME;
-    }
-    if ("dyn_string" == typestr)
-    {
-        return ValueType::Type::DYN_STRING;
-    }
-    if ("dyn_langString" == typestr)
-    {
-        return ValueType::Type::DYN_LANG_STRING;
-    }
-    if ("dyn_bool" == typestr)
-    {
-        return ValueType::Type::DYN_BOOL;
-    }
-    if ("dyn_bit32" == typestr)
-    {
-        return ValueType::Type::DYN_BIT32;
-    }
-    if ("dyn_bit64" == typestr)
-    {
-        return ValueType::Type::DYN_BIT64;
-    }
-    if ("dyn_char" == typestr)
-    {
-        return ValueType::Type::DYN_CHAR;
-    }
-    if ("dyn_blob" == typestr)
-    {
-        return ValueType::Type::DYN_BLOB;
-    }
-    if ("dyn_anytype" == typestr)
-    {
-        return ValueType::Type::DYN_ANYTYPE;
-    }
-    if ("dyn_mixed" == typestr)
-    {
-        return ValueType::Type::DYN_MIXED;
-    }
-    if ("dyn_errClass" == typestr)
-    {
-        return ValueType::Type::DYN_ERR_CLASS;
-    }
-    if ("dyn_mapping" == typestr)
-    {
-        return ValueType::Type::DYN_MAPPING;
-    }
-    if ("dyn_dbConnection" == typestr)
-    {
-        return ValueType::Type::DYN_DB_CONNECTION;
-    }
-    if ("dyn_dbCommand" == typestr)
-    {
-        return ValueType::Type::DYN_DB_COMMAND;
-    }
-    if ("dyn_dbRecordset" == typestr)
-    {
-        return ValueType::Type::DYN_DB_RECORDSET;
-    }
-    if ("dyn_shape" == typestr)
-    {
-        return ValueType::Type::DYN_SHAPE;
-    }
-    if ("dyn_function_ptr" == typestr)
-    {
-        return ValueType::Type::DYN_FUNCTION_PTR;
-    }
-
-    // dyn_dyn variables
-    if ("dyn_dyn_int" == typestr)
-    {
-        return ValueType::Type::DYN_DYN_INT;
-    }
-    if ("dyn_dyn_uint" == typestr)
-    {
-        return ValueType::Type::DYN_DYN_UINT;
-    }
-    if ("dyn_dyn_long" == typestr)
-    {
-        return ValueType::Type::DYN_DYN_LONG;
-    }
-    if ("dyn_dyn_ulong" == typestr)
-    {
-        return ValueType::Type::DYN_DYN_ULONG;
-    }
-    if ("dyn_dyn_float" == typestr)
-    {
-        return ValueType::Type::DYN_DYN_FLOAT;
-    }
-    if ("dyn_dyn_time" == typestr)
-    {
-        return ValueType::Type::DYN_DYN_TIME;
-    }
-    if ("dyn_dyn_atime" == typestr)
-    {
-        return ValueType::Type::DYN_DYN_ATIME;
-    }
-    if ("dyn_dyn_string" == typestr)
-    {
-        return ValueType::Type::DYN_DYN_STRING;
-    }
-    if ("dyn_dyn_langString" == typestr)
-    {
-        return ValueType::Type::DYN_DYN_LANG_STRING;
-    }
-    if ("dyn_dyn_bool" == typestr)
-    {
-        return ValueType::Type::DYN_DYN_BOOL;
-    }
-    if ("dyn_dyn_bit32" == typestr)
-    {
-        return ValueType::Type::DYN_DYN_BIT32;
-    }
-    if ("dyn_dyn_bit64" == typestr)
-    {
-        return ValueType::Type::DYN_DYN_BIT64;
-    }
-    if ("dyn_dyn_char" == typestr)
-    {
-        return ValueType::Type::DYN_DYN_CHAR;
-    }
-    if ("dyn_dyn_anytype" == typestr)
-    {
-        return ValueType::Type::DYN_DYN_ANYTYPE;
-    }
-    if ("dyn_dyn_mixed" == typestr)
-    {
-        return ValueType::Type::DYN_DYN_MIXED;
-    }
-    if ("dyn_dyn_errClass" == typestr)
-    {
-        return ValueType::Type::DYN_DYN_ERR_CLASS;
-    }
-
-    // added in WinCC OA 3.17
-    if ("vector" == typestr)
-    {
-        return ValueType::Type::VECTOR;
-    }
-
-    return ValueType::Type::UNKNOWN_TYPE;
+    return Keywords::classify(typestr).type;
 }
 
 //-----------------------------------------------------------------------------
@@ -785,44 +499,71 @@ bool ValueType::isEnum() const
 }
 
 //-----------------------------------------------------------------------------
-bool ValueType::canCastTo(const std::string &otherType) const
+bool ValueType::canCastTo(const ValueType &other) const
 {
     //Any type can be casted to anytype or mixed
-    //Also returns true when type == otherType
-    if (otherType == "anytype" ||
-        otherType == "mixed" || 
-        otherType == typeToString())
+    //Also returns true when type == other.type, interned types have the same address
+    if (this == &other ||
+        type == other.type ||
+        other.type == ANYTYPE ||
+        other.type == MIXED)
     {
         return true;
     }
 
     //Map of types that can be casted
-    //ValueType::Type (FROM) -> std::vector<std::string>> (TO)
+    //ValueType::Type (FROM) -> std::vector<ValueType::Type> (TO)
     //If the ValueType:Type is not in this is map i can't be casted
-    std::map<ValueType::Type, std::vector<std::string>> castToMap = {
-        {BOOL, {"int", "float", "long", "ulong", "uint", "double", "string"}},
-        {CHAR, {"int", "float", "long", "ulong", "uint", "double", "string"}},
-        {SHORT, {"int", "float", "long", "ulong", "uint", "double", "string"}},
-        {INT, {"float", "long", "ulong", "uint", "double", "string", "time"}},
-        {LONG, {"float", "ulong", "double", "string", "time"}},
-        {ULONG, {"float", "long", "double", "string", "time"}},
-        {UINT, {"int", "float", "long", "ulong", "double", "string", "time"}},
-        {FLOAT, {"double", "string", "time"}},
-        {DOUBLE, {"float", "string", "time"}},
-        {STRING, {"lang_string"}},
-        {LANG_STRING, {"string"}},
-        {TIME, {"string"}},
-        {ATIME, {"string"}}};
+    static const std::map<ValueType::Type, std::vector<ValueType::Type>> castToMap = {
+        {BOOL, {INT, FLOAT, LONG, ULONG, UINT, DOUBLE, STRING}},
+        {CHAR, {INT, FLOAT, LONG, ULONG, UINT, DOUBLE, STRING}},
+        {SHORT, {INT, FLOAT, LONG, ULONG, UINT, DOUBLE, STRING}},
+        {INT, {FLOAT, LONG, ULONG, UINT, DOUBLE, STRING, TIME}},
+        {LONG, {FLOAT, ULONG, DOUBLE, STRING, TIME}},
+        {ULONG, {FLOAT, LONG, DOUBLE, STRING, TIME}},
+        {UINT, {INT, FLOAT, LONG, ULONG, DOUBLE, STRING, TIME}},
+        {FLOAT, {DOUBLE, STRING, TIME}},
+        {DOUBLE, {FLOAT, STRING, TIME}},
+        {STRING, {LANG_STRING}},
+        {LANG_STRING, {STRING}},
+        {TIME, {STRING}},
+        {ATIME, {STRING}}};
 
     //Find current type int the castToMap
-    if (castToMap.find(type) != castToMap.end())
+    const std::map<ValueType::Type, std::vector<ValueType::Type>>::const_iterator it = castToMap.find(type);
+    if (it != castToMap.end())
     {
-        std::vector<std::string> possibleCasts = castToMap[type];
-        return std::find(possibleCasts.begin(), possibleCasts.end(), otherType) != possibleCasts.end();
+        const std::vector<ValueType::Type> &possibleCasts = it->second;
+        return std::find(possibleCasts.begin(), possibleCasts.end(), other.type) != possibleCasts.end();
     }
 
     //Current value isn't in the castTo Map
     return false;
 }
 
-//-----------------------------------------------------------------------------
\ No newline at end of file
+//-----------------------------------------------------------------------------
+const ValueType *ValueTypePool::intern(const ValueType &valuetype)
+{
+    return &*mValueTypes.insert(valuetype).first;
+}
+
+//-----------------------------------------------------------------------------
+std::size_t ValueTypePool::Hash::operator()(const ValueType &valuetype) const
+{
+    std::size_t h = std::hash<std::string>()(valuetype.originalTypeName);
+    h = h * 31 + static_cast<std::size_t>(valuetype.type);
+    h = h * 31 + valuetype.bits;
+    h = h * 31 + valuetype.constness;
+    h = h * 31 + std::hash<const Scope *>()(valuetype.typeScope);
+    return h;
+}
+
+//-----------------------------------------------------------------------------
+bool ValueTypePool::Equal::operator()(const ValueType &vt1, const ValueType &vt2) const
+{
+    return vt1.type == vt2.type &&
+           vt1.bits == vt2.bits &&
+           vt1.constness == vt2.constness &&
+           vt1.typeScope == vt2.typeScope &&
+           vt1.originalTypeName == vt2.originalTypeName;
+}
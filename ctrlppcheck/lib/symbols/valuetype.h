@@ -8,7 +8,9 @@
 #include "../library.h"
 #include "../token.h"
 
+#include <cstddef>
 #include <string>
+#include <unordered_set>
 
 //class Scope;
 
@@ -230,8 +232,11 @@ public:
     bool isEnum() const;
 
     //---------------------------------------------------------------------------
-
-    bool canCastTo(const std::string &otherType) const;
+    /**
+     * Check if the value can be casted to the other type.
+     * Interned value types are compared by their pointers first.
+     */
+    bool canCastTo(const ValueType &other) const;
 
     //-------------------------------------------------------------------------
     /**
@@ -254,5 +259,42 @@ public:
     std::string typeToString() const;
 };
 
+//-----------------------------------------------------------------------------
+/**
+  Interned value types.
+  Equal value types are stored once and never change, so tokens share them
+  and two interned value types are equal when their pointers are equal.
+*/
+class CPPCHECKLIB ValueTypePool
+{
+public:
+    //-------------------------------------------------------------------------
+    /**
+       Get the shared instance of a value type.
+       @param valuetype value type, it is copied into the pool if there is no equal one
+       @return shared instance, valid as long as the pool
+    */
+    const ValueType *intern(const ValueType &valuetype);
+
+    //-------------------------------------------------------------------------
+    /// number of distinct value types
+    std::size_t size() const
+    {
+        return mValueTypes.size();
+    }
+
+private:
+    struct Hash
+    {
+        std::size_t operator()(const ValueType &valuetype) const;
+    };
+    struct Equal
+    {
+        bool operator()(const ValueType &vt1, const ValueType &vt2) const;
+    };
+
+    std::unordered_set<ValueType, Hash, Equal> mValueTypes;
+};
+
 //---------------------------------------------------------------------------
 #endif // valuetypeH
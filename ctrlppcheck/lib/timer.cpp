@@ -41,7 +41,7 @@ namespace {
 
 void TimerResults::ShowResults(SHOWTIME_MODES mode) const
 {
-    if (mode == SHOWTIME_NONE)
+    if (mode == SHOWTIME_NONE || mode == SHOWTIME_MEMORY || mode == SHOWTIME_QUIET)
         return;
 
     std::cout << std::endl;
@@ -30,7 +30,9 @@ enum SHOWTIME_MODES {
     SHOWTIME_NONE = 0,
     SHOWTIME_FILE,
     SHOWTIME_SUMMARY,
-    SHOWTIME_TOP5
+    SHOWTIME_TOP5,
+    SHOWTIME_MEMORY,    ///< memory of the analysis data instead of the times
+    SHOWTIME_QUIET      ///< collect the times without printing them, see CppCheck::timerResults()
 };
 
 class CPPCHECKLIB TimerResultsIntf {
@@ -63,6 +65,14 @@ public:
     void ShowResults(SHOWTIME_MODES mode) const;
     void AddResults(const std::string& str, std::clock_t clocks) OVERRIDE;
 
+    const std::map<std::string, struct TimerResultsData> &getResults() const {
+        return mResults;
+    }
+
+    void clear() {
+        mResults.clear();
+    }
+
 private:
     std::map<std::string, struct TimerResultsData> mResults;
 };
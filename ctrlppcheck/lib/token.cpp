@@ -22,6 +22,7 @@
 #include "errorlogger.h"
 #include "library.h"
 #include "settings.h"
+#include "symbols/keywords.h"
 #include "symbols/symbols.h"
 #include "utils.h"
 
@@ -65,33 +66,12 @@ Token::~Token()
     delete mImpl;
 }
 
-static const std::set<std::string> controlFlowKeywords = {
-    "do",
-    "if",
-    "else",
-    "for",
-    "while",
-    "switch",
-    "case",
-    "break",
-    "continue",
-    "return",
-    "default",
-    "try",
-    "catch",
-    "finally"
-};
-
-//-----------------------------------------------------------------------------
-bool Token::isControlFlowKeyword()
-{
-  return controlFlowKeywords.find(mStr) != controlFlowKeywords.end();
-}
-
 //-----------------------------------------------------------------------------
 void Token::update_property_info()
 {
-    setFlag(fIsControlFlowKeyword, isControlFlowKeyword());
+    mImpl->mNumberKind = TokenImpl::NUMBER_UNPARSED;
+    const Keywords::Keyword keyword = Keywords::classify(mStr);
+    setFlag(fIsControlFlowKeyword, (keyword.flags & Keywords::CONTROL_FLOW) != 0);
 
     if (!mStr.empty()) {
         if (mStr == "true" || mStr == "false" || mStr == "TRUE" || mStr == "FALSE")
@@ -141,18 +121,9 @@ void Token::update_property_info()
         tokType(eNone);
     }
 
-    update_property_isStandardType();
-}
-
-void Token::update_property_isStandardType()
-{
-    isStandardType(false);
-
-    if ( ValueType::typeFromString(mStr) != ValueType::Type::UNKNOWN_TYPE )
-    {
-        isStandardType(true);
+    isStandardType(keyword.type != ValueType::Type::UNKNOWN_TYPE);
+    if (isStandardType())
         tokType(eType);
-    }
 }
 
 
@@ -167,6 +138,20 @@ bool Token::isUpperCaseName() const
     return true;
 }
 
+void Token::parseNumber() const
+{
+    if (MathLib::isInt(mStr))
+        mImpl->mNumberKind = TokenImpl::NUMBER_INT;
+    else if (MathLib::isFloat(mStr))
+        mImpl->mNumberKind = TokenImpl::NUMBER_FLOAT;
+    else {
+        mImpl->mNumberKind = TokenImpl::NUMBER_OTHER;
+        return;
+    }
+    mImpl->mIntNumber = MathLib::toLongNumber(mStr);
+    mImpl->mFloatNumber = MathLib::toDoubleNumber(mStr);
+}
+
 void Token::concatStr(std::string const& b)
 {
     mStr.erase(mStr.length() - 1);
@@ -1108,16 +1093,16 @@ static void astStringXml(const Token *tok, std::size_t indent, std::ostream &out
         out << " values=\"" << &tok->values() << '\"';
 
     if (!tok->astOperand1() && !tok->astOperand2()) {
-        out << "/>" << std::endl;
+        out << "/>\n";
     }
 
     else {
-        out << '>' << std::endl;
+        out << ">\n";
         if (tok->astOperand1())
             astStringXml(tok->astOperand1(), indent+2U, out);
         if (tok->astOperand2())
             astStringXml(tok->astOperand2(), indent+2U, out);
-        out << strindent << "</token>" << std::endl;
+        out << strindent << "</token>\n";
     }
 }
 
@@ -1127,19 +1112,19 @@ void Token::printAst(bool verbose, bool xml, std::ostream &out) const
     for (const Token *tok = this; tok; tok = tok->next()) {
         if (!tok->mImpl->mAstParent && tok->mImpl->mAstOperand1) {
             if (printed.empty() && !xml)
-                out << "\n\n##AST" << std::endl;
+                out << "\n\n##AST\n";
             else if (printed.find(tok) != printed.end())
                 continue;
             printed.insert(tok);
 
             if (xml) {
-                out << "<ast scope=\"" << tok->scope() << "\" fileIndex=\"" << tok->fileIndex() << "\" linenr=\"" << tok->linenr() << "\">" << std::endl;
+                out << "<ast scope=\"" << tok->scope() << "\" fileIndex=\"" << tok->fileIndex() << "\" linenr=\"" << tok->linenr() << "\">\n";
                 astStringXml(tok, 2U, out);
-                out << "</ast>" << std::endl;
+                out << "</ast>\n";
             } else if (verbose)
-                out << tok->astStringVerbose(0,0) << std::endl;
+                out << tok->astStringVerbose(0,0) << '\n';
             else
-                out << tok->astString(" ") << std::endl;
+                out << tok->astString(" ") << '\n';
             if (tok->str() == "(")
                 tok = tok->link();
         }
@@ -1183,16 +1168,16 @@ void Token::printValueFlow(bool xml, std::ostream &out) const
 {
     unsigned int line = 0;
     if (xml)
-        out << "  <valueflow>" << std::endl;
+        out << "  <valueflow>\n";
     else
-        out << "\n\n##Value flow" << std::endl;
+        out << "\n\n##Value flow\n";
     for (const Token *tok = this; tok; tok = tok->next()) {
         if (!tok->mImpl->mValues)
             continue;
         if (xml)
-            out << "    <values id=\"" << tok->mImpl->mValues << "\">" << std::endl;
+            out << "    <values id=\"" << tok->mImpl->mValues << "\">\n";
         else if (line != tok->linenr())
-            out << "Line " << tok->linenr() << std::endl;
+            out << "Line " << tok->linenr() << '\n';
         line = tok->linenr();
         if (!xml) {
             out << "  " << tok->str() << (tok->mImpl->mValues->front().isKnown() ? " always " : " possible ");
@@ -1227,7 +1212,7 @@ void Token::printValueFlow(bool xml, std::ostream &out) const
                     out << " possible=\"true\"";
                 else if (value.isInconclusive())
                     out << " inconclusive=\"true\"";
-                out << "/>" << std::endl;
+                out << "/>\n";
             }
 
             else {
@@ -1253,14 +1238,14 @@ void Token::printValueFlow(bool xml, std::ostream &out) const
             }
         }
         if (xml)
-            out << "    </values>" << std::endl;
+            out << "    </values>\n";
         else if (tok->mImpl->mValues->size() > 1U)
-            out << '}' << std::endl;
+            out << "}\n";
         else
-            out << std::endl;
+            out << '\n';
     }
     if (xml)
-        out << "  </valueflow>" << std::endl;
+        out << "  </valueflow>\n";
 }
 
 const ValueFlow::Value * Token::getValueLE(const MathLib::bigint val, const Settings *settings) const
@@ -1441,14 +1426,6 @@ void Token::assignProgressValues(Token *tok)
         tok2->mImpl->mProgressValue = count++ * 100 / total_count;
 }
 
-void Token::setValueType(ValueType *vt)
-{
-    if (vt != mImpl->mValueType) {
-        delete mImpl->mValueType;
-        mImpl->mValueType = vt;
-    }
-}
-
 void Token::type(const ::Type *t)
 {
     mImpl->mType = t;
@@ -1462,7 +1439,6 @@ void Token::type(const ::Type *t)
 TokenImpl::~TokenImpl()
 {
     delete mOriginalName;
-    delete mValueType;
     delete mValues;
 }
 
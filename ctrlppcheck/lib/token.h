@@ -82,8 +82,8 @@ struct TokenImpl {
     // original name like size_t
     std::string* mOriginalName;
 
-    // ValueType
-    ValueType *mValueType;
+    // ValueType, shared instance of the ValueTypePool of the token list
+    const ValueType *mValueType;
 
     // ValueFlow
     std::list<ValueFlow::Value>* mValues;
@@ -92,6 +92,12 @@ struct TokenImpl {
     /** Bitfield bit count. */
     unsigned char mBits;
 
+    // Number literal, parsed on demand. Reset when the string changes.
+    enum { NUMBER_UNPARSED, NUMBER_INT, NUMBER_FLOAT, NUMBER_OTHER };
+    unsigned char mNumberKind;
+    MathLib::bigint mIntNumber;
+    double mFloatNumber;
+
     TokenImpl()
         : mVarId(0)
         , mFileIndex(0)
@@ -107,6 +113,9 @@ struct TokenImpl {
         , mValueType(nullptr)
         , mValues(nullptr)
         , mBits(0)
+        , mNumberKind(NUMBER_UNPARSED)
+        , mIntNumber(0)
+        , mFloatNumber(0.0)
     {}
 
     ~TokenImpl();
@@ -306,7 +315,10 @@ public:
     const ValueType *valueType() const {
         return mImpl->mValueType;
     }
-    void setValueType(ValueType *vt);
+    /** Set the value type, vt must be owned by a ValueTypePool (see TokenList::internValueType()) */
+    void setValueType(const ValueType *vt) {
+        mImpl->mValueType = vt;
+    }
 
     const ValueType *argumentType() const {
         const Token *top = this;
@@ -349,6 +361,25 @@ public:
     bool isNumber() const {
         return mTokType == eNumber;
     }
+    /** Is this an integer number token (MathLib::isInt)? */
+    bool isIntNumber() const {
+        return isNumber() && numberKind() == TokenImpl::NUMBER_INT;
+    }
+    /** Is this a float number token (MathLib::isFloat)? */
+    bool isFloatNumber() const {
+        return isNumber() && numberKind() == TokenImpl::NUMBER_FLOAT;
+    }
+    /**
+     * Integer value of the token, same as MathLib::toLongNumber(str()).
+     * Numbers are parsed once, the value is kept until the string changes.
+     */
+    MathLib::bigint getIntNumber() const {
+        return numberKind() == TokenImpl::NUMBER_OTHER ? MathLib::toLongNumber(mStr) : mImpl->mIntNumber;
+    }
+    /** Float value of the token, same as MathLib::toDoubleNumber(str()) */
+    double getFloatNumber() const {
+        return numberKind() == TokenImpl::NUMBER_OTHER ? MathLib::toDoubleNumber(mStr) : mImpl->mFloatNumber;
+    }
     bool isEnumerator() const {
         return mTokType == eEnumerator;
     }
@@ -973,8 +1004,15 @@ private:
         Called after any mStr() modification. */
     void update_property_info();
 
-    /** Update internal property cache about isStandardType() */
-    void update_property_isStandardType();
+    /** Kind of the number in mStr, the string is parsed on the first call */
+    unsigned char numberKind() const {
+        if (mImpl->mNumberKind == TokenImpl::NUMBER_UNPARSED)
+            parseNumber();
+        return mImpl->mNumberKind;
+    }
+
+    /** Parse mStr into the number cache of mImpl */
+    void parseNumber() const;
 
 public:
 
@@ -1037,13 +1075,6 @@ public:
     void printAst(bool verbose, bool xml, std::ostream &out) const;
 
     void printValueFlow(bool xml, std::ostream &out) const;
-
-    //-------------------------------------------------------------------------
-    /** @brief Function check if the token is ctrl key word (if,else,while...).
-        @details ctrl keywords are defined in static member controlFlowKeywords
-        @return true when token is ctrl keyword. Otherwise false.
-    */
-    bool isControlFlowKeyword();
 };
 
 /// @}
@@ -19,9 +19,11 @@
 //---------------------------------------------------------------------------
 #include "tokenize.h"
 
+#include "astutils.h"
 #include "check.h"
 #include "library.h"
 #include "mathlib.h"
+#include "memoryusage.h"
 #include "path.h"
 #include "platform.h"
 #include "settings.h"
@@ -210,7 +212,10 @@ Tokenizer::Tokenizer(const Settings *settings, ErrorLogger *errorLogger) :
     mVarId(0),
     mUnnamedCount(0),
     mCodeWithTemplates(false), //is there any templates?
-    mTimerResults(nullptr)
+    mTimerResults(nullptr),
+    mValueFlowEnabled(true),
+    mMemoryBudget(0),
+    mMemoryUsed(0)
 #ifdef MAXTIME
     ,mMaxTime(std::time(0) + MAXTIME)
 #endif
@@ -328,7 +333,23 @@ bool Tokenizer::simplifyTokens1(const std::string &configuration)
         mSymbolDatabase->setValueTypeInTokenList();
     }
 
-    if (mTimerResults) {
+    // the values would exceed the memory budget, the checks run without them
+    if (mValueFlowEnabled && mMemoryBudget > 0) {
+        MemoryUsage usage;
+        usage.addTokens(list);
+        usage.addSymbolDatabase(*mSymbolDatabase);
+        if (mMemoryUsed + usage.total() > mMemoryBudget) {
+            memoryBudgetError("The ValueFlow analysis", mMemoryUsed + usage.total());
+            mValueFlowEnabled = false;
+        }
+    }
+
+    if (!mValueFlowEnabled) {
+        // no check needs the values, list the step as skipped in --showtime
+        if (mTimerResults) {
+            Timer t("Tokenizer::simplifyTokens1::ValueFlow (skipped)", mSettings->showtime, mTimerResults);
+        }
+    } else if (mTimerResults) {
         Timer t("Tokenizer::simplifyTokens1::ValueFlow", mSettings->showtime, mTimerResults);
         ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger, mSettings);
     } else {
@@ -1512,110 +1533,137 @@ void Tokenizer::createLinks()
     }
 }
 
+//---------------------------------------------------------------------------
+namespace {
+    // Runs the passes of a token list simplification. With --showtime each
+    // pass is timed as "<list>::<name>".
+    class PassRunner {
+    public:
+        PassRunner(const char *list, TimerResults *timerResults, unsigned int showtime)
+            : mList(list), mTimerResults(timerResults), mShowtime(showtime) {
+        }
+
+        template<class Pass>
+        auto operator()(const char *name, Pass pass) const -> decltype(pass()) {
+            if (!mTimerResults)
+                return pass();
+            Timer t(std::string(mList) + "::" + name, mShowtime, mTimerResults);
+            return pass();
+        }
+
+    private:
+        const char *mList;
+        TimerResults *mTimerResults;
+        unsigned int mShowtime;
+    };
+}
+
 bool Tokenizer::simplifyTokenList1(const char FileName[])
 {
     if (mSettings->terminated())
         return false;
 
+    const PassRunner runPass("Tokenizer::simplifyTokenList1", mTimerResults, mSettings->showtime);
 
     // Combine strings and character literals, e.g. L"string", L'c', "string1" "string2"
-    combineStringAndCharLiterals();
+    runPass("combineStringAndCharLiterals", [this] { combineStringAndCharLiterals(); });
 
-    createLinks();
+    runPass("createLinks", [this] { createLinks(); });
 
     // Bail out if code is garbage
-    if (mTimerResults) {
-        Timer t("Tokenizer::tokenize::findGarbageCode", mSettings->showtime, mTimerResults);
-        findGarbageCode();
-    } else {
-        findGarbageCode();
-    }
+    runPass("findGarbageCode", [this] { findGarbageCode(); });
 
     if (mSettings->terminated())
         return false;
 
     // remove __attribute__((?))
-    simplifyAttribute();
+    runPass("simplifyAttribute", [this] { simplifyAttribute(); });
 
     // Combine tokens..
-    combineOperators();
+    runPass("combineOperators", [this] { combineOperators(); });
 
     // replace 'sin(0)' to '0' and other similar math expressions
-    simplifyMathExpressions();
+    runPass("simplifyMathExpressions", [this] { simplifyMathExpressions(); });
 
     // combine "- %num%"
-    concatenateNegativeNumberAndAnyPositive();
+    runPass("concatenateNegativeNumberAndAnyPositive", [this] { concatenateNegativeNumberAndAnyPositive(); });
 
     // check for simple syntax errors..
-    for (const Token *tok = list.front(); tok; tok = tok->next()) {
-        if (Token::simpleMatch(tok, "> struct {") &&
-            Token::simpleMatch(tok->linkAt(2), "} ;")) {
-            syntaxErrorDetail(tok);
+    runPass("checkStructAfterTemplate", [this] {
+        for (const Token *tok = list.front(); tok; tok = tok->next()) {
+            if (Token::simpleMatch(tok, "> struct {") &&
+                Token::simpleMatch(tok->linkAt(2), "} ;")) {
+                syntaxErrorDetail(tok);
+            }
         }
-    }
+    });
 
-    if (!simplifyAddBraces())
+    if (!runPass("simplifyAddBraces", [this] { return simplifyAddBraces(); }))
         return false;
 
     if (mSettings->terminated())
         return false;
 
     // simplify simple calculations inside <..>
-    Token *lt = nullptr;
-    for (Token *tok = list.front(); tok; tok = tok->next()) {
-        if (Token::Match(tok, "[;{}]"))
-            lt = nullptr;
-        else if (Token::Match(tok, "%type% <"))
-            lt = tok->next();
-        else if (lt && Token::Match(tok, ">|>> %name%|::|(")) {
-            const Token * const end = tok;
-            for (tok = lt; tok != end; tok = tok->next()) {
-                if (tok->isNumber())
-                    mCalculationsSimplifier->simplifyNumericCalculations(tok);
-            }
-            lt = tok->next();
+    runPass("simplifyTemplateCalculations", [this] {
+        Token *lt = nullptr;
+        for (Token *tok = list.front(); tok; tok = tok->next()) {
+            if (Token::Match(tok, "[;{}]"))
+                lt = nullptr;
+            else if (Token::Match(tok, "%type% <"))
+                lt = tok->next();
+            else if (lt && Token::Match(tok, ">|>> %name%|::|(")) {
+                const Token * const end = tok;
+                for (tok = lt; tok != end; tok = tok->next()) {
+                    if (tok->isNumber())
+                        mCalculationsSimplifier->simplifyNumericCalculations(tok);
+                }
+                lt = tok->next();
+            }
         }
-    }
+    });
 
 
     // Convert K&R function declarations to modern C
-    simplifyVarDecl(true);
+    runPass("simplifyVarDecl", [this] { simplifyVarDecl(true); });
     // simplify labels and 'case|default'-like syntaxes
-    simplifyLabelsCaseDefault();
+    runPass("simplifyLabelsCaseDefault", [this] { simplifyLabelsCaseDefault(); });
 
     if (mSettings->terminated())
         return false;
 
     // That call here fixes #7190
-    validate();
+    runPass("validate", [this] { validate(); });
 
     // remove unnecessary member qualification..
-    removeUnnecessaryQualification();
+    runPass("removeUnnecessaryQualification", [this] { removeUnnecessaryQualification(); });
 
     if (mSettings->terminated())
         return false;
 
     // syntax error: enum with typedef in it
-    checkForEnumsWithTypedef();
+    runPass("checkForEnumsWithTypedef", [this] { checkForEnumsWithTypedef(); });
 
     // Add parentheses to ternary operator where necessary
-    prepareTernaryOpForAST();
+    runPass("prepareTernaryOpForAST", [this] { prepareTernaryOpForAST(); });
 
 
     // Split up variable declarations.
-    simplifyVarDecl(false);
+    runPass("simplifyVarDecl", [this] { simplifyVarDecl(false); });
 
     // Add parentheses to ternary operator where necessary
     // TODO: this is only necessary if one typedef simplification had a comma and was used within ?:
     // If typedef handling is refactored and moved to symboldatabase someday we can remove this
-    prepareTernaryOpForAST();
+    runPass("prepareTernaryOpForAST", [this] { prepareTernaryOpForAST(); });
 
-    for (Token* tok = list.front(); tok;) {
-        if (Token::Match(tok, "struct|class struct|class"))
-            tok->deleteNext();
-        else
-            tok = tok->next();
-    }
+    runPass("removeDoubleStructKeyword", [this] {
+        for (Token* tok = list.front(); tok;) {
+            if (Token::Match(tok, "struct|class struct|class"))
+                tok->deleteNext();
+            else
+                tok = tok->next();
+        }
+    });
 
 
     // catch bad typedef canonicalization
@@ -1623,7 +1671,8 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
     // to reproduce bad typedef, download upx-ucl from:
     // http://packages.debian.org/sid/upx-ucl
     // analyse the file src/stub/src/i386-linux.elf.interp-main.c
-    validate();
+    //
+    runPass("validate", [this] { validate(); });
 
     // The simplify enum have inner loops
     if (mSettings->terminated())
@@ -1631,42 +1680,44 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
 
 //@todo I think we can remove this for ctrl code.
     // When the assembly code has been cleaned up, no @ is allowed
-    for (const Token *tok = list.front(); tok; tok = tok->next()) {
-        if (tok->str() == "(") {
-            const Token *tok1 = tok;
-            tok = tok->link();
-            if (!tok)
-                syntaxErrorDetail(tok1);
-        } else if (tok->str() == "@") {
-            syntaxErrorDetail(tok);
+    runPass("checkAt", [this] {
+        for (const Token *tok = list.front(); tok; tok = tok->next()) {
+            if (tok->str() == "(") {
+                const Token *tok1 = tok;
+                tok = tok->link();
+                if (!tok)
+                    syntaxErrorDetail(tok1);
+            } else if (tok->str() == "@") {
+                syntaxErrorDetail(tok);
+            }
         }
-    }
+    });
 
     // Order keywords "static" and "const"
-    simplifyStaticConst();
+    runPass("simplifyStaticConst", [this] { simplifyStaticConst(); });
 
     // convert platform dependent types to standard types
     // 32 bits: size_t -> unsigned long
     // 64 bits: size_t -> unsigned long long
-    list.simplifyPlatformTypes();
+    runPass("simplifyPlatformTypes", [this] { list.simplifyPlatformTypes(); });
 
     // collapse compound standard types into a single token
     // unsigned long long int => long (with _isUnsigned=true,_isLong=true)
-    list.simplifyStdType();
+    runPass("simplifyStdType", [this] { list.simplifyStdType(); });
 
     if (mSettings->terminated())
         return false;
 
     // struct simplification "struct S {} s; => struct S { } ; S s ;
-    simplifyStructDecl();
+    runPass("simplifyStructDecl", [this] { simplifyStructDecl(); });
 
     if (mSettings->terminated())
         return false;
 
-    simplifyVariableMultipleAssign();
+    runPass("simplifyVariableMultipleAssign", [this] { simplifyVariableMultipleAssign(); });
 
     // Remove redundant parentheses
-    simplifyRedundantParentheses();
+    runPass("simplifyRedundantParentheses", [this] { simplifyRedundantParentheses(); });
 
     // The simplifyTemplates have inner loops
     if (mSettings->terminated())
@@ -1675,23 +1726,18 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
     // sometimes the "simplifyTemplates" fail and then unsimplified
     // function calls etc remain. These have the "wrong" syntax. So
     // this function will just fix so that the syntax is corrected.
-    validate(); // #6847 - invalid code
+    runPass("validate", [this] { validate(); }); // #6847 - invalid code
 
 
     // Split up variable declarations.
-    simplifyVarDecl(false);
+    runPass("simplifyVarDecl", [this] { simplifyVarDecl(false); });
 
-    validate(); // #6772 "segmentation fault (invalid code) in Tokenizer::setVarId"
+    runPass("validate", [this] { validate(); }); // #6772 "segmentation fault (invalid code) in Tokenizer::setVarId"
 
-    if (mTimerResults) {
-        Timer t("Tokenizer::tokenize::setVarId", mSettings->showtime, mTimerResults);
-        setVarId();
-    } else {
-        setVarId();
-    }
+    runPass("setVarId", [this] { setVarId(); });
 
     // specify array size
-    arraySize();
+    runPass("arraySize", [this] { arraySize(); });
 
     // The simplify enum might have inner loops
     if (mSettings->terminated())
@@ -1699,25 +1745,31 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
 
 
     // Convert e.g. atol("0") into 0
-    simplifyMathFunctions();
+    runPass("simplifyMathFunctions", [this] { simplifyMathFunctions(); });
 
-    simplifyDoublePlusAndDoubleMinus();
+    runPass("simplifyDoublePlusAndDoubleMinus", [this] { simplifyDoublePlusAndDoubleMinus(); });
 
-    Token::assignProgressValues(list.front());
+    runPass("assignProgressValues", [this] { Token::assignProgressValues(list.front()); });
 
-    removeRedundantSemicolons();
+    runPass("removeRedundantSemicolons", [this] { removeRedundantSemicolons(); });
 
-    simplifyRedundantConsecutiveBraces();
+    runPass("simplifyRedundantConsecutiveBraces", [this] { simplifyRedundantConsecutiveBraces(); });
 
-    elseif();
+    runPass("elseif", [this] { elseif(); });
 
 
-    validate();
+    runPass("validate", [this] { validate(); });
     return true;
 }
 
 bool Tokenizer::simplifyTokenList2()
 {
+    const PassRunner runPass("Tokenizer::simplifyTokenList2", mTimerResults, mSettings->showtime);
+
+    // replace variables with the known values of the ValueFlow
+    if (!mSettings->legacyKnownVariables)
+        runPass("simplifyKnownValues", [this] { simplifyKnownValues(); });
+
     // clear the _functionList so it can't contain dead pointers
     deleteSymbolDatabase();
 
@@ -1728,47 +1780,49 @@ bool Tokenizer::simplifyTokenList2()
     }
 
     // f(x=g())   =>   x=g(); f(x)
-    simplifyAssignmentInFunctionCall();
+    runPass("simplifyAssignmentInFunctionCall", [this] { simplifyAssignmentInFunctionCall(); });
 
     // ";a+=b;" => ";a=a+b;"
-    simplifyCompoundAssignment();
+    runPass("simplifyCompoundAssignment", [this] { simplifyCompoundAssignment(); });
 
     // simplify references
-    simplifyReference();
+    runPass("simplifyReference", [this] { simplifyReference(); });
 
     if (mSettings->terminated())
         return false;
 
-    simplifyUndefinedSizeArray();
+    runPass("simplifyUndefinedSizeArray", [this] { simplifyUndefinedSizeArray(); });
 
-    simplifyCasts();
+    runPass("simplifyCasts", [this] { simplifyCasts(); });
 
     // Simplify simple calculations before replace constants, this allows the replacement of constants that are calculated
     // e.g. const static int value = sizeof(X)/sizeof(Y);
-    simplifyCalculations();
+    runPass("simplifyCalculations", [this] { simplifyCalculations(); });
 
     if (mSettings->terminated())
         return false;
 
-    removeRedundantAssignment();
+    runPass("removeRedundantAssignment", [this] { removeRedundantAssignment(); });
 
 
     // Simplify variable declarations
-    simplifyVarDecl(false);
+    runPass("simplifyVarDecl", [this] { simplifyVarDecl(false); });
 
-    simplifyIfAndWhileAssign();
-    simplifyRedundantParentheses();
-    simplifyFuncInWhile();
+    runPass("simplifyIfAndWhileAssign", [this] { simplifyIfAndWhileAssign(); });
+    runPass("simplifyRedundantParentheses", [this] { simplifyRedundantParentheses(); });
+    runPass("simplifyFuncInWhile", [this] { simplifyFuncInWhile(); });
 
-    simplifyIfAndWhileAssign();
+    runPass("simplifyIfAndWhileAssign", [this] { simplifyIfAndWhileAssign(); });
 
     // replace strlen(str)
-    for (Token *tok = list.front(); tok; tok = tok->next()) {
-        if (Token::Match(tok, "strlen ( %str% )")) {
-            tok->str(MathLib::toString(Token::getStrLength(tok->tokAt(2))));
-            tok->deleteNext(3);
+    runPass("simplifyStrlenOfLiteral", [this] {
+        for (Token *tok = list.front(); tok; tok = tok->next()) {
+            if (Token::Match(tok, "strlen ( %str% )")) {
+                tok->str(MathLib::toString(Token::getStrLength(tok->tokAt(2))));
+                tok->deleteNext(3);
+            }
         }
-    }
+    });
 
     bool modified = true;
     while (modified) {
@@ -1776,60 +1830,67 @@ bool Tokenizer::simplifyTokenList2()
             return false;
 
         modified = false;
-        modified |= simplifyConditions();
-        modified |= simplifyFunctionReturn();
-        modified |= simplifyKnownVariables();
-        modified |= simplifyStrlen();
-
-        modified |= removeRedundantConditions();
-        modified |= simplifyRedundantParentheses();
-        modified |= simplifyConstTernaryOp();
-        modified |= simplifyCalculations();
-        validate();
+        modified |= runPass("simplifyConditions", [this] { return simplifyConditions(); });
+        modified |= runPass("simplifyFunctionReturn", [this] { return simplifyFunctionReturn(); });
+        if (mSettings->legacyKnownVariables)
+            modified |= runPass("simplifyKnownVariables", [this] { return simplifyKnownVariables(); });
+        modified |= runPass("simplifyStrlen", [this] { return simplifyStrlen(); });
+
+        modified |= runPass("removeRedundantConditions", [this] { return removeRedundantConditions(); });
+        modified |= runPass("simplifyRedundantParentheses", [this] { return simplifyRedundantParentheses(); });
+        modified |= runPass("simplifyConstTernaryOp", [this] { return simplifyConstTernaryOp(); });
+        modified |= runPass("simplifyCalculations", [this] { return simplifyCalculations(); });
+        runPass("validate", [this] { validate(); });
     }
 
     // simplify redundant loops
-    simplifyWhile0();
-    removeRedundantFor();
+    runPass("simplifyWhile0", [this] { simplifyWhile0(); });
+    runPass("removeRedundantFor", [this] { removeRedundantFor(); });
 
     // Remove redundant parentheses in return..
-    for (Token *tok = list.front(); tok; tok = tok->next()) {
-        while (Token::simpleMatch(tok, "return (")) {
-            Token *tok2 = tok->next()->link();
-            if (Token::simpleMatch(tok2, ") ;")) {
-                tok->deleteNext();
-                tok2->deleteThis();
-            } else {
-                break;
+    runPass("removeReturnParentheses", [this] {
+        for (Token *tok = list.front(); tok; tok = tok->next()) {
+            while (Token::simpleMatch(tok, "return (")) {
+                Token *tok2 = tok->next()->link();
+                if (Token::simpleMatch(tok2, ") ;")) {
+                    tok->deleteNext();
+                    tok2->deleteThis();
+                } else {
+                    break;
+                }
             }
         }
-    }
+    });
 
-    removeRedundantAssignment();
+    runPass("removeRedundantAssignment", [this] { removeRedundantAssignment(); });
 
-    simplifyComma();
+    runPass("simplifyComma", [this] { simplifyComma(); });
 
-    removeRedundantSemicolons();
+    runPass("removeRedundantSemicolons", [this] { removeRedundantSemicolons(); });
 
-    simplifyFlowControl();
+    runPass("simplifyFlowControl", [this] { simplifyFlowControl(); });
 
-    simplifyRedundantConsecutiveBraces();
+    runPass("simplifyRedundantConsecutiveBraces", [this] { simplifyRedundantConsecutiveBraces(); });
 
-    simplifyMathFunctions();
+    runPass("simplifyMathFunctions", [this] { simplifyMathFunctions(); });
 
-    validate();
+    runPass("validate", [this] { validate(); });
 
     Token::assignProgressValues(list.front());
 
-    list.createAst();
-    // needed for #7208 (garbage code) and #7724 (ast max depth limit)
-    list.validateAst();
+    runPass("createAst", [this] {
+        list.createAst();
+        // needed for #7208 (garbage code) and #7724 (ast max depth limit)
+        list.validateAst();
+    });
 
     // Create symbol database and then remove const keywords
-    createSymbolDatabase();
-    mSymbolDatabase->setValueTypeInTokenList();
+    runPass("createSymbolDatabase", [this] {
+        createSymbolDatabase();
+        mSymbolDatabase->setValueTypeInTokenList();
+    });
 
-    ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger, mSettings);
+    runPass("ValueFlow", [this] { ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger, mSettings); });
 
     if (mSettings->terminated())
         return false;
@@ -1897,7 +1958,7 @@ void Tokenizer::dump(std::ostream &out) const
     // data dump that 3rd party tools could load and get useful info from.
 
     // tokens..
-    out << "  <tokenlist>" << std::endl;
+    out << "  <tokenlist>\n";
     for (const Token *tok = list.front(); tok; tok = tok->next()) {
         out << "    <token id=\"" << tok << "\" file=\"" << ErrorLogger::toxml(list.file(tok)) << "\" linenr=\"" << tok->linenr() << '\"';
         out << " str=\"" << ErrorLogger::toxml(tok->str()) << '\"';
@@ -1958,9 +2019,9 @@ void Tokenizer::dump(std::ostream &out) const
             if (!vt.empty())
                 out << ' ' << vt;
         }
-        out << "/>" << std::endl;
+        out << "/>\n";
     }
-    out << "  </tokenlist>" << std::endl;
+    out << "  </tokenlist>\n";
 
     mSymbolDatabase->printXml(out);
     if (list.front())
@@ -2187,8 +2248,8 @@ void Tokenizer::removeRedundantFor()
                 continue;
 
             // Check that the difference of the numeric values is 1
-            const MathLib::bigint num1(MathLib::toLongNumber(varTok->strAt(2)));
-            const MathLib::bigint num2(MathLib::toLongNumber(varTok->strAt(6)));
+            const MathLib::bigint num1(varTok->tokAt(2)->getIntNumber());
+            const MathLib::bigint num2(varTok->tokAt(6)->getIntNumber());
             if (num1 + 1 != num2)
                 continue;
 
@@ -2612,8 +2673,8 @@ bool Tokenizer::simplifyConditions()
                     const std::string& op2(tok->strAt(3));
 
                     bool eq = false;
-                    if (MathLib::isInt(op1) && MathLib::isInt(op2))
-                        eq = (MathLib::toLongNumber(op1) == MathLib::toLongNumber(op2));
+                    if (tok->next()->isIntNumber() && tok->tokAt(3)->isIntNumber())
+                        eq = (tok->next()->getIntNumber() == tok->tokAt(3)->getIntNumber());
                     else {
                         eq = (op1 == op2);
 
@@ -2627,8 +2688,8 @@ bool Tokenizer::simplifyConditions()
                     else
                         result = !eq;
                 } else {
-                    const double op1 = MathLib::toDoubleNumber(tok->next()->str());
-                    const double op2 = MathLib::toDoubleNumber(tok->strAt(3));
+                    const double op1 = tok->next()->getFloatNumber();
+                    const double op2 = tok->tokAt(3)->getFloatNumber();
                     if (cmp == ">=")
                         result = (op1 >= op2);
                     else if (cmp == ">")
@@ -3340,6 +3401,37 @@ void Tokenizer::simplifyVariableMultipleAssign()
 
 
 
+void Tokenizer::simplifyKnownValues()
+{
+    for (Token *tok = list.front(); tok; tok = tok->next()) {
+        if (!tok->varId() || tok->values().size() != 1U)
+            continue;
+        const ValueFlow::Value &value = tok->values().front();
+        if (!value.isKnown() || !value.isIntValue())
+            continue;
+
+        // local variables and global constants with an integral type
+        const Variable *var = tok->variable();
+        if (!var || var->nameToken() == tok || !(var->isLocal() || (var->isGlobal() && var->isConst())))
+            continue;
+        if (!tok->valueType() || !tok->valueType()->isIntegral() || tok->valueType()->type == ValueType::Type::BOOL)
+            continue;
+
+        // the variable must be read
+        const Token *parent = tok->astParent();
+        if (!parent || Token::Match(parent, ".|++|--") || parent->isUnaryOp("&"))
+            continue;
+        if (parent->isAssignmentOp() && parent->astOperand1() == tok)
+            continue;
+        bool inconclusive = false;
+        if (isVariableChangedByFunctionCall(tok, mSettings, &inconclusive) || inconclusive)
+            continue;
+
+        tok->setVarId(0);
+        tok->str(MathLib::toString(value.intvalue));
+    }
+}
+
 bool Tokenizer::simplifyKnownVariables()
 {
     // return value for function. Set to true if any simplifications are made
@@ -3635,7 +3727,7 @@ bool Tokenizer::simplifyKnownVariablesGetData(unsigned int varid, Token **_tok2,
             value = compareTok->next()->str();
             valueVarId = compareTok->next()->varId();
         } else
-            value = MathLib::toString(MathLib::toLongNumber(compareTok->next()->str()) + 1);
+            value = MathLib::toString(compareTok->next()->getIntNumber() + 1);
 
         // Skip for-body..
         tok3 = tok2->previous()->link()->next()->link()->next();
@@ -4820,14 +4912,17 @@ void Tokenizer::validate() const
     const Token *lastTok = nullptr;
     for (const Token *tok = tokens(); tok; tok = tok->next()) {
         lastTok = tok;
-        if (Token::Match(tok, "[{([]") || (tok->str() == "<" && tok->link())) {
+        // compare the characters, the validation runs several times for each file
+        const std::string &str = tok->str();
+        const char c = str.size() == 1 ? str[0] : (str == ">>" ? '>' : '\0');
+        if (c == '{' || c == '(' || c == '[' || (c == '<' && tok->link())) {
             if (tok->link() == nullptr)
                 cppcheckError(tok);
 
             linkTokens.push(tok);
         }
 
-        else if (Token::Match(tok, "[})]]") || (Token::Match(tok, ">|>>") && tok->link())) {
+        else if (c == '}' || c == ')' || c == ']' || (c == '>' && tok->link())) {
             if (tok->link() == nullptr)
                 cppcheckError(tok);
 
@@ -4873,35 +4968,85 @@ static const Token *findUnmatchedTernaryOp(const Token * const begin, const Toke
     return ternaryOp.empty() ? nullptr : ternaryOp.top();
 }
 
+// Operators without operands..
+static bool isOperatorWithoutOperands(const Token *tok)
+{
+    // names are only matched by "throw {"
+    if (tok->isName() && !tok->isBoolean())
+        return Token::Match(tok, "throw {|if|else|try|catch|while|do|for|return|switch|break");
+    return Token::Match(tok, "%or%|%oror%|==|!=|+|-|/|!|>=|<=|~|++|--|::|throw {|if|else|try|catch|while|do|for|return|switch|break") ||
+           (Token::Match(tok, "( %any% )") && tok->next()->isKeyword() && !Token::simpleMatch(tok->next(), "void")) ||
+           (Token::Match(tok, "%num%|%bool%|%char%|%str% %num%|%bool%|%char%|%str%") && !Token::Match(tok, "%str% %str%")) ||
+           Token::Match(tok, "%assign% typename|class %assign%") ||
+           Token::Match(tok, "%cop%|=|,|[ %or%|%oror%|/|%") ||
+           Token::Match(tok, ";|(|[ %comp%") ||
+           (Token::Match(tok, "%cop%|= ]") && !Token::Match(tok->previous(), "[|, &|= ]")) ||
+           Token::Match(tok, "[+-] [;,)]}]");
+}
+
 void Tokenizer::findGarbageCode() const
 {
-    // Inside [] there can't be ; or various keywords
+    // The checks of single tokens are done in one walk over the token list.
+    // The first error of each check is remembered and the errors are reported
+    // in the order of the checks, the reported error does not depend on the walk.
+    enum { BRACKET, CONTROL, FOR_SEMICOLONS, OPERATOR, OBJECTIVE_C, CHECKS };
+    std::pair<const Token *, const char *> errors[CHECKS] = {};
     for (const Token *tok = tokens(); tok; tok = tok->next()) {
-        if (tok->str() != "[")
-            continue;
-        for (const Token *inner = tok->next(); inner != tok->link(); inner = inner->next()) {
-            if (Token::Match(inner, "(|["))
-                inner = inner->link();
-            else if (Token::Match(inner, ";|goto|return|typedef"))
-                syntaxErrorDetailMsg(inner, "Inside [] there can't be ; or various keywords");
+        // Inside [] there can't be ; or various keywords
+        if (!errors[BRACKET].first && tok->str() == "[") {
+            for (const Token *inner = tok->next(); inner != tok->link(); inner = inner->next()) {
+                if (Token::Match(inner, "(|["))
+                    inner = inner->link();
+                else if (Token::Match(inner, ";|goto|return|typedef")) {
+                    errors[BRACKET] = std::make_pair(inner, "Inside [] there can't be ; or various keywords");
+                    break;
+                }
+            }
         }
-    }
 
-    for (const Token *tok = tokens(); tok; tok = tok->next()) {
-        if (Token::Match(tok, "if|while|for|switch")) { // if|while|for|switch (EXPR) { ... }
+        // if|while|for|switch (EXPR) { ... }
+        if (!errors[CONTROL].first && Token::Match(tok, "if|while|for|switch")) {
             if (tok->previous() && !Token::Match(tok->previous(), "%name%|:|;|{|}|(|)|,"))
-                syntaxErrorDetail(tok);
-            if (Token::Match(tok->previous(), "[(,]"))
-                continue;
-            if (!Token::Match(tok->next(), "( !!)"))
-                syntaxErrorDetail(tok);
-            if (tok->str() != "for") {
-                if (isGarbageExpr(tok->next(), tok->linkAt(1)))
-                    syntaxErrorDetail(tok);
+                errors[CONTROL].first = tok;
+            else if (!Token::Match(tok->previous(), "[(,]") &&
+                     (!Token::Match(tok->next(), "( !!)") ||
+                      (tok->str() != "for" && isGarbageExpr(tok->next(), tok->linkAt(1)))))
+                errors[CONTROL].first = tok;
+        }
+
+        if (!errors[FOR_SEMICOLONS].first && Token::simpleMatch(tok, "for (")) {
+            // count number of semicolons, walk backwards from the ")" of the for-loop
+            unsigned int semicolons = 0;
+            for (const Token *inner = tok->linkAt(1)->previous(); inner != tok; inner = inner->previous()) {
+                if (inner->str() == ";") { // do the counting
+                    semicolons++;
+                } else if (inner->str() == ")") { // skip pairs of ( )
+                    inner = inner->link();
+                }
             }
+            // if we have an invalid number of semicolons inside for( ), assume syntax error
+            if ((semicolons == 1) || (semicolons > 2))
+                errors[FOR_SEMICOLONS] = std::make_pair(tok, "invalid number of semicolons inside for( )");
         }
+
+        if (!errors[OPERATOR].first && isOperatorWithoutOperands(tok))
+            errors[OPERATOR] = std::make_pair(tok, "operator without operands ...");
+
+        // Objective C/C++
+        if (!errors[OBJECTIVE_C].first && Token::Match(tok, "[;{}] [ %name% %name% ] ;"))
+            errors[OBJECTIVE_C].first = tok->next();
     }
 
+    const auto reportError = [](const std::pair<const Token *, const char *> &error) {
+        if (!error.first)
+            return;
+        if (error.second)
+            syntaxErrorDetailMsg(error.first, error.second);
+        syntaxErrorDetail(error.first);
+    };
+    reportError(errors[BRACKET]);
+    reportError(errors[CONTROL]);
+
     // case keyword must be inside switch
     for (const Token *tok = tokens(); tok; tok = tok->next()) {
         if (Token::simpleMatch(tok, "switch (")) {
@@ -4934,46 +5079,8 @@ void Tokenizer::findGarbageCode() const
         }
     }
 
-    for (const Token *tok = tokens(); tok ; tok = tok->next()) {
-        if (!Token::simpleMatch(tok, "for (")) // find for loops
-            continue;
-        // count number of semicolons
-        unsigned int semicolons = 0;
-        const Token* const startTok = tok;
-        tok = tok->next()->link()->previous(); // find ")" of the for-loop
-        // walk backwards until we find the beginning (startTok) of the for() again
-        for (; tok != startTok; tok = tok->previous()) {
-            if (tok->str() == ";") { // do the counting
-                semicolons++;
-            } else if (tok->str() == ")") { // skip pairs of ( )
-                tok = tok->link();
-            }
-        }
-        // if we have an invalid number of semicolons inside for( ), assume syntax error
-        if ((semicolons == 1) || (semicolons > 2)) {
-            syntaxErrorDetailMsg(tok, "invalid number of semicolons inside for( )");
-        }
-    }
-
-    // Operators without operands..
-    for (const Token *tok = tokens(); tok; tok = tok->next()) {
-        if (Token::Match(tok, "%or%|%oror%|==|!=|+|-|/|!|>=|<=|~|++|--|::|throw {|if|else|try|catch|while|do|for|return|switch|break"))
-            syntaxErrorDetailMsg(tok, "operator without operands ...");
-        if (Token::Match(tok, "( %any% )") && tok->next()->isKeyword() && !Token::simpleMatch(tok->next(), "void"))
-            syntaxErrorDetailMsg(tok, "operator without operands ...");
-        if (Token::Match(tok, "%num%|%bool%|%char%|%str% %num%|%bool%|%char%|%str%") && !Token::Match(tok, "%str% %str%"))
-            syntaxErrorDetailMsg(tok, "operator without operands ...");
-        if (Token::Match(tok, "%assign% typename|class %assign%"))
-            syntaxErrorDetailMsg(tok, "operator without operands ...");
-        if (Token::Match(tok, "%cop%|=|,|[ %or%|%oror%|/|%"))
-            syntaxErrorDetailMsg(tok, "operator without operands ...");
-        if (Token::Match(tok, ";|(|[ %comp%"))
-            syntaxErrorDetailMsg(tok, "operator without operands ...");
-        if (Token::Match(tok, "%cop%|= ]") && !Token::Match(tok->previous(), "[|, &|= ]"))
-            syntaxErrorDetailMsg(tok, "operator without operands ...");
-        if (Token::Match(tok, "[+-] [;,)]}]"))
-            syntaxErrorDetailMsg(tok, "operator without operands ...");
-    }
+    reportError(errors[FOR_SEMICOLONS]);
+    reportError(errors[OPERATOR]);
 
     // ternary operator without :
     if (const Token *ternaryOp = findUnmatchedTernaryOp(tokens(), nullptr))
@@ -4993,12 +5100,7 @@ void Tokenizer::findGarbageCode() const
     if ((list.back()->str()==")" || list.back()->str()=="}") && list.back()->previous() && list.back()->previous()->isControlFlowKeyword())
         syntaxErrorDetailMsg(list.back()->previous(), "code must end with } ; )");
 
-
-    // Objective C/C++
-    for (const Token *tok = tokens(); tok; tok = tok->next()) {
-        if (Token::Match(tok, "[;{}] [ %name% %name% ] ;"))
-            syntaxErrorDetail(tok->next());
-    }
+    reportError(errors[OBJECTIVE_C]);
 }
 
 
@@ -5520,6 +5622,21 @@ void Tokenizer::prepareTernaryOpForAST()
     }
 }
 
+void Tokenizer::memoryBudgetError(const std::string &step, std::size_t used) const
+{
+    if (!mSettings->isEnabled(Settings::INFORMATION))
+        return;
+    reportError(list.front(), Severity::information, "memoryBudgetExceeded",
+                "The analysis data of the file needs " + MemoryUsage::toMiB(used) + ", more than the memory budget of " +
+                MemoryUsage::toMiB(mSettings->maxMemory) + ". " + step + " is skipped, some problems may not be found.");
+}
+
+void Tokenizer::getErrorMessages(ErrorLogger *errorLogger, const Settings *settings)
+{
+    const Tokenizer tokenizer(settings, errorLogger);
+    tokenizer.memoryBudgetError("The ValueFlow analysis", 0U);
+}
+
 void Tokenizer::reportError(const Token* tok, const Severity::SeverityType severity, const std::string& id, const std::string& msg, bool inconclusive) const
 {
     const std::list<const Token*> callstack(1, tok);
@@ -89,6 +89,21 @@ public:
         mTimerResults = tr;
     }
 
+    /** Skip ValueFlow in simplifyTokens1(), when no check needs the values */
+    void setValueFlowEnabled(bool enabled) {
+        mValueFlowEnabled = enabled;
+    }
+
+    /**
+     * Memory budget of the file (--max-memory) and the memory used outside
+     * of the tokenizer, e.g. by the simplecpp token lists. simplifyTokens1()
+     * skips ValueFlow when the tokens and the symbol database use it up.
+     */
+    void setMemoryBudget(std::size_t budget, std::size_t used) {
+        mMemoryBudget = budget;
+        mMemoryUsed = used;
+    }
+
     /** Is the code ctrl. Used for bailouts */
     bool isCTRL() const {
         return list.isCTRL();
@@ -300,6 +315,14 @@ public:
      */
     bool simplifyKnownVariables();
 
+    /**
+     * Replace variables with their known value, e.g. "x=10; if(x)" => "x=10;if(10)".
+     * The values are taken from the ValueFlow of the normal token list, so
+     * this is one walk over the tokens. It must be called before the symbol
+     * database and the ValueFlow values are cleared.
+     */
+    void simplifyKnownValues();
+
     /**
      * Utility function for simplifyKnownVariables. Get data about an
      * assigned variable.
@@ -452,6 +475,12 @@ public:
     void syntaxError(const Token *tok, const std::string &detail) const;
     // void syntaxError(const Token *tok, const std::string &file, int line, const std::string &function) const;
 
+    /** Memory budget exceeded, a step of the analysis is skipped */
+    void memoryBudgetError(const std::string &step, std::size_t used) const;
+
+    /** Errors of the tokenizer that are not syntax errors, for --errorlist */
+    static void getErrorMessages(ErrorLogger *errorLogger, const Settings *settings);
+
     // __FILE__, __LINE__, __func__
     void syntaxErrorDetail(const Token *tok) const;
     static void syntaxErrorDetailMsg(const Token *tok, std::string detail);
@@ -649,6 +678,15 @@ private:
      */
     TimerResults *mTimerResults;
 
+    /** Run ValueFlow in simplifyTokens1()? */
+    bool mValueFlowEnabled;
+
+    /** Memory budget of the file, 0 => unlimited, see setMemoryBudget() */
+    std::size_t mMemoryBudget;
+
+    /** Memory used outside of the tokenizer */
+    std::size_t mMemoryUsed;
+
 #ifdef MAXTIME
     /** Tokenizer maxtime */
     const std::time_t mMaxTime;
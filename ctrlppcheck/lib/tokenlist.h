@@ -23,6 +23,7 @@
 
 #include "config.h"
 #include "token.h"
+#include "symbols/valuetype.h"
 
 #include <string>
 #include <vector>
@@ -156,6 +157,14 @@ public:
      */
     void simplifyStdType();
 
+    /**
+     * Get the shared instance of a value type. Equal value types are stored
+     * once per token list, the tokens point to the shared instances.
+     */
+    const ValueType *internValueType(const ValueType &valuetype) const {
+        return mValueTypes.intern(valuetype);
+    }
+
 private:
 
     /** Disable copy constructor, no implementation */
@@ -178,6 +187,9 @@ private:
 
     /** File is known to be C/C++/ctrl code */
     bool mIsCtrl;
+
+    /** value types of the tokens */
+    mutable ValueTypePool mValueTypes;
 };
 
 /// @}
@@ -36,6 +36,14 @@ inline bool endsWith(const std::string &str, const char end[], std::size_t endle
     return (str.size() >= endlen) && (str.compare(str.size()-endlen, endlen, end)==0);
 }
 
+/** 64 bit FNV-1a hash of the bytes, the same on all platforms */
+inline unsigned long long fnv1a(const char *data, std::size_t size, unsigned long long h = 14695981039346656037ULL)
+{
+    for (std::size_t i = 0; i < size; ++i)
+        h = (h ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+    return h;
+}
+
 inline static const char *getOrdinalText(int i)
 {
     if (i == 1)
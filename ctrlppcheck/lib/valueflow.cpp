@@ -736,7 +736,7 @@ static void setTokenValue(Token* tok, const ValueFlow::Value &value, const Setti
                             element = element->next();
                         }
                         if (Token::Match(element, "%num% [,}]")) {
-                            result.intvalue = MathLib::toLongNumber(element->str());
+                            result.intvalue = element->getIntNumber();
                             setTokenValue(parent, result, settings);
                         }
                     }
@@ -769,14 +769,14 @@ static void setTokenValueCast(Token *parent, const ValueType &valueType, const V
 // Handle various constants..
 static Token *valueFlowSetConstantValue(const Token *tok, const Settings *settings)
 {
-    if ((tok->isNumber() && MathLib::isInt(tok->str())) || (tok->tokType() == Token::eChar))
+    if (tok->isIntNumber() || (tok->tokType() == Token::eChar))
     {
-        ValueFlow::Value value(MathLib::toLongNumber(tok->str()));
+        ValueFlow::Value value(tok->getIntNumber());
         setTokenValue(const_cast<Token *>(tok), value, settings);
-    } else if (tok->isNumber() && MathLib::isFloat(tok->str())) {
+    } else if (tok->isFloatNumber()) {
         ValueFlow::Value value;
         value.valueType = ValueFlow::Value::FLOAT;
-        value.floatValue = MathLib::toDoubleNumber(tok->str());
+        value.floatValue = tok->getFloatNumber();
         setTokenValue(const_cast<Token *>(tok), value, settings);
     }
     else if (tok->enumerator() && tok->enumerator()->value_known)
@@ -3105,8 +3105,8 @@ static void execute(const Token *expr,
     }
 
     else if (expr->isNumber()) {
-        *result = MathLib::toLongNumber(expr->str());
-        if (MathLib::isFloat(expr->str()))
+        *result = expr->getIntNumber();
+        if (expr->isFloatNumber())
             *error = true;
     }
 
@@ -3298,7 +3298,7 @@ static bool valueFlowForLoop1(const Token *tok, unsigned int * const varid, Math
     tok = vartok->tokAt(2);
     const Token * const num1tok = Token::Match(tok, "%num% ;") ? tok : nullptr;
     if (num1tok)
-        *num1 = MathLib::toLongNumber(num1tok->str());
+        *num1 = num1tok->getIntNumber();
     while (Token::Match(tok, "%name%|%num%|%or%|+|-|*|/|&|[|]|("))
         tok = (tok->str() == "(") ? tok->link()->next() : tok->next();
     if (!tok || tok->str() != ";")
@@ -3315,7 +3315,7 @@ static bool valueFlowForLoop1(const Token *tok, unsigned int * const varid, Math
     }
     if (!num2tok)
         return false;
-    *num2 = MathLib::toLongNumber(num2tok->str()) - ((tok->str()=="<=") ? 0 : 1);
+    *num2 = num2tok->getIntNumber() - ((tok->str()=="<=") ? 0 : 1);
     *numAfter = *num2 + 1;
     if (!num1tok)
         *num1 = *num2;
@@ -3586,7 +3586,7 @@ static void valueFlowSwitchVariable(TokenList *tokenlist, SymbolDatabase* symbol
             }
             if (Token::Match(tok, "case %num% :")) {
                 std::list<ValueFlow::Value> values;
-                values.emplace_back(MathLib::toLongNumber(tok->next()->str()));
+                values.emplace_back(tok->next()->getIntNumber());
                 values.back().condition = tok;
                 const std::string info("case " + tok->next()->str() + ": " + vartok->str() + " is " + tok->next()->str() + " here.");
                 values.back().errorPath.emplace_back(tok, info);
@@ -3598,7 +3598,7 @@ static void valueFlowSwitchVariable(TokenList *tokenlist, SymbolDatabase* symbol
                     tok = tok->tokAt(3);
                     if (!tok->isName())
                         tok = tok->next();
-                    values.emplace_back(MathLib::toLongNumber(tok->next()->str()));
+                    values.emplace_back(tok->next()->getIntNumber());
                     values.back().condition = tok;
                     const std::string info2("case " + tok->next()->str() + ": " + vartok->str() + " is " + tok->next()->str() + " here.");
                     values.back().errorPath.emplace_back(tok, info2);
@@ -3753,11 +3753,11 @@ static bool evaluate(const Token *expr, const std::vector<std::list<ValueFlow::V
         return true;
     }
     if (expr->isNumber()) {
-        result->emplace_back(ValueFlow::Value(MathLib::toLongNumber(expr->str())));
+        result->emplace_back(ValueFlow::Value(expr->getIntNumber()));
         result->back().setKnown();
         return true;
     } else if (expr->tokType() == Token::eChar) {
-        result->emplace_back(ValueFlow::Value(MathLib::toLongNumber(expr->str())));
+        result->emplace_back(ValueFlow::Value(expr->getIntNumber()));
         result->back().setKnown();
         return true;
     }